@@ -14,6 +14,7 @@
 #include <jet/scalar_grid3.h>
 #include <limits>
 #include <memory>
+#include <vector>
 
 namespace jet {
 
@@ -109,6 +110,36 @@ class AdvectionSolver3 {
         FaceCenteredGrid3* output,
         const ScalarField3& boundarySdf
             = ConstantScalarField3(kMaxD));
+
+    //!
+    //! \brief Solves advection equation for multiple grids at once.
+    //!
+    //! This function advects every scalar grid \p scalarInputs[i] into
+    //! \p scalarOutputs[i] and every collocated vector grid \p vectorInputs[i]
+    //! into \p vectorOutputs[i] with the same \p flow, \p dt and
+    //! \p boundarySdf. Implementations can group the grids that share the
+    //! same data layout (e.g. smoke density and temperature) and advect them
+    //! in a single traversal that back-traces each data point only once. By
+    //! default, each grid is advected separately.
+    //!
+    //! \param scalarInputs Input scalar grids.
+    //! \param scalarOutputs Output scalar grids.
+    //! \param vectorInputs Input collocated vector grids.
+    //! \param vectorOutputs Output collocated vector grids.
+    //! \param flow Vector field that advects the input fields.
+    //! \param dt Time-step for the advection.
+    //! \param boundarySdf Boundary interface defined by signed-distance
+    //!     field.
+    //!
+    virtual void advectFields(
+        const std::vector<const ScalarGrid3*>& scalarInputs,
+        const std::vector<ScalarGrid3*>& scalarOutputs,
+        const std::vector<const CollocatedVectorGrid3*>& vectorInputs,
+        const std::vector<CollocatedVectorGrid3*>& vectorOutputs,
+        const VectorField3& flow,
+        double dt,
+        const ScalarField3& boundarySdf
+            = ConstantScalarField3(kMaxD));
 };
 
 //! Shared pointer type for the 3-D advection solver.
@@ -116,4 +147,6 @@ typedef std::shared_ptr<AdvectionSolver3> AdvectionSolver3Ptr;
 
 }  // namespace jet
 
+#include "detail/advection_solver3-inl.h"
+
 #endif  // INCLUDE_JET_ADVECTION_SOLVER3_H_
@@ -46,6 +46,10 @@ class ApicSolver3 : public PicSolver3 {
     //! Transfers velocity field from grids to particles.
     void transferFromGridsToParticles() override;
 
+    //! Removes the marked particles along with their affine velocities.
+    void removeParticles(
+        const ConstArrayAccessor1<char>& shouldRemove) override;
+
  private:
     Array1<Vector3D> _cX;
     Array1<Vector3D> _cY;
@@ -71,4 +75,6 @@ class ApicSolver3::Builder final
 
 }  // namespace jet
 
+#include "detail/apic_solver3-inl.h"
+
 #endif  // INCLUDE_JET_APIC_SOLVER3_H_
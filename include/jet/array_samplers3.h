@@ -8,6 +8,7 @@
 #define INCLUDE_JET_ARRAY_SAMPLERS3_H_
 
 #include <jet/array_samplers.h>
+#include <jet/array_accessor1.h>
 #include <jet/array_accessor3.h>
 #include <jet/vector3.h>
 #include <functional>
@@ -99,6 +100,17 @@ class LinearArraySampler<T, R, 3> final {
     //! Returns sampled value at point \p pt.
     T operator()(const Vector3<R>& pt) const;
 
+    //!
+    //! \brief Samples the points \p pts and writes the values to \p results.
+    //!
+    //! The results are identical to calling operator() per point. Points are
+    //! processed in small blocks: the indices and weights of a block are
+    //! computed first in a branch-free loop that the compiler can vectorize,
+    //! and the array values are gathered and interpolated afterwards.
+    //!
+    void operator()(const ConstArrayAccessor1<Vector3<R>>& pts,
+                    ArrayAccessor1<T> results) const;
+
     //! Returns the indices of points and their sampling weight for given point.
     void getCoordinatesAndWeights(
         const Vector3<R>& pt,
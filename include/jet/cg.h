@@ -8,6 +8,7 @@
 #define INCLUDE_JET_CG_H_
 
 #include <jet/blas.h>
+#include <jet/constants.h>
 
 namespace jet {
 
@@ -31,8 +32,10 @@ struct NullCgPreconditioner final {
 //!
 //! \brief Solves conjugate gradient.
 //!
+//! Returns true if \p maxDurationInSeconds stopped the iterations early.
+//!
 template <typename BlasType>
-void cg(
+bool cg(
     const typename BlasType::MatrixType& A,
     const typename BlasType::VectorType& b,
     unsigned int maxNumberOfIterations,
@@ -43,15 +46,51 @@ void cg(
     typename BlasType::VectorType* q,
     typename BlasType::VectorType* s,
     unsigned int* lastNumberOfIterations,
-    double* lastResidualNorm);
+    double* lastResidualNorm,
+    double maxDurationInSeconds = kMaxD);
 
 //!
 //! \brief Solves pre-conditioned conjugate gradient.
 //!
+//! Iterations stop when the residual drops below \p tolerance, when
+//! \p maxNumberOfIterations is reached, or when more than
+//! \p maxDurationInSeconds of wall-clock time has passed. At least one
+//! iteration is always taken. Returns true if the time limit stopped the
+//! iterations before the residual reached \p tolerance.
+//!
+template <
+    typename BlasType,
+    typename PrecondType>
+bool pcg(
+    const typename BlasType::MatrixType& A,
+    const typename BlasType::VectorType& b,
+    unsigned int maxNumberOfIterations,
+    double tolerance,
+    PrecondType* M,
+    typename BlasType::VectorType* x,
+    typename BlasType::VectorType* r,
+    typename BlasType::VectorType* d,
+    typename BlasType::VectorType* q,
+    typename BlasType::VectorType* s,
+    unsigned int* lastNumberOfIterations,
+    double* lastResidualNorm,
+    double maxDurationInSeconds = kMaxD);
+
+//!
+//! \brief Solves pre-conditioned conjugate gradient for multiple right-hand
+//!        sides that share the same matrix.
+//!
+//! The batched BLAS type (such as FdmBatchBlas3) stores the right-hand sides
+//! interleaved, uses K-vectors as scalars and defines the number of
+//! right-hand sides as kNumberOfRhs, so each iteration reads the
+//! matrix once for all of them. Every right-hand side keeps its own step
+//! lengths and stops updating once it has converged; the loop ends when all
+//! of them have converged or the max number of iterations is reached.
+//!
 template <
     typename BlasType,
     typename PrecondType>
-void pcg(
+void batchedPcg(
     const typename BlasType::MatrixType& A,
     const typename BlasType::VectorType& b,
     unsigned int maxNumberOfIterations,
@@ -63,7 +102,25 @@ void pcg(
     typename BlasType::VectorType* q,
     typename BlasType::VectorType* s,
     unsigned int* lastNumberOfIterations,
-    double* lastResidualNorm);
+    typename BlasType::ScalarType* lastResidualNorms);
+
+//!
+//! \brief Solves conjugate gradient for multiple right-hand sides that share
+//!        the same matrix.
+//!
+template <typename BlasType>
+void batchedCg(
+    const typename BlasType::MatrixType& A,
+    const typename BlasType::VectorType& b,
+    unsigned int maxNumberOfIterations,
+    double tolerance,
+    typename BlasType::VectorType* x,
+    typename BlasType::VectorType* r,
+    typename BlasType::VectorType* d,
+    typename BlasType::VectorType* q,
+    typename BlasType::VectorType* s,
+    unsigned int* lastNumberOfIterations,
+    typename BlasType::ScalarType* lastResidualNorms);
 
 }  // namespace jet
 
@@ -0,0 +1,145 @@
+// Copyright (c) 2018 Doyub Kim
+//
+// I am making my contributions/submissions to this project solely in my
+// personal capacity and am not conveying any rights to any intellectual
+// property of any third parties.
+
+#ifndef INCLUDE_JET_CHEBYSHEV_H_
+#define INCLUDE_JET_CHEBYSHEV_H_
+
+#include <jet/blas.h>
+#include <jet/mg.h>
+
+#include <memory>
+#include <vector>
+
+namespace jet {
+
+//!
+//! \brief Estimates the largest eigenvalue of a symmetric matrix using Lanczos
+//!        iterations.
+//!
+//! This function runs \p numberOfIterations Lanczos steps starting from
+//! \p start and returns the largest eigenvalue of the resulting tridiagonal
+//! matrix, which approaches the largest eigenvalue of \p A from below. Only
+//! matrix-vector products and vector updates are used.
+//!
+template <typename BlasType>
+double lanczosLargestEigenvalue(const typename BlasType::MatrixType& A,
+                                const typename BlasType::VectorType& start,
+                                unsigned int numberOfIterations,
+                                typename BlasType::VectorType* v,
+                                typename BlasType::VectorType* vPrev,
+                                typename BlasType::VectorType* w);
+
+//!
+//! \brief Performs Chebyshev iterations.
+//!
+//! For given linear system matrix \p A and RHS vector \p b, this function
+//! improves the initial guess \p x using \p numberOfIterations Chebyshev
+//! iterations that damp the error components whose eigenvalues lie in
+//! [\p lambdaMin, \p lambdaMax]. No inner products are needed, so every step
+//! is fully parallel.
+//!
+template <typename BlasType>
+void chebyshev(const typename BlasType::MatrixType& A,
+               const typename BlasType::VectorType& b,
+               unsigned int numberOfIterations, double lambdaMin,
+               double lambdaMax, typename BlasType::VectorType* x,
+               typename BlasType::VectorType* r,
+               typename BlasType::VectorType* d,
+               typename BlasType::VectorType* q);
+
+//! Parameters for the Chebyshev smoother and preconditioner.
+struct ChebyshevParameters {
+    //! Ratio between the largest and the smallest targeted eigenvalues.
+    double eigenvalueRatio = 30.0;
+
+    //! Number of Lanczos steps for the spectral bound estimation.
+    unsigned int numberOfLanczosIterations = 10;
+
+    //! Factor applied to the estimated largest eigenvalue.
+    double safetyFactor = 1.1;
+};
+
+//!
+//! \brief Chebyshev polynomial preconditioner for conjugate gradient.
+//!
+//! This preconditioner applies a fixed number of Chebyshev iterations with
+//! zero initial guess, which is a symmetric positive definite polynomial of
+//! the matrix. The spectral bound is re-estimated on every build.
+//!
+template <typename BlasType>
+struct ChebyshevPreconditioner final {
+    const typename BlasType::MatrixType* A = nullptr;
+    ChebyshevParameters params;
+    unsigned int degree = 4;
+    double lambdaMax = 0.0;
+    typename BlasType::VectorType r;
+    typename BlasType::VectorType d;
+    typename BlasType::VectorType q;
+
+    //! Estimates the spectral bound of \p matrix; \p b sizes the buffers.
+    void build(const typename BlasType::MatrixType& matrix,
+               const typename BlasType::VectorType& b);
+
+    void solve(const typename BlasType::VectorType& b,
+               typename BlasType::VectorType* x);
+};
+
+//!
+//! \brief Chebyshev smoother for Multigrid.
+//!
+//! relaxFunc() returns a function that can be plugged into
+//! MgParameters::relaxFunc. The spectral bound of each level is estimated
+//! the first time the level is relaxed and cached until invalidate() is
+//! called, which should happen whenever the matrix values change.
+//! FdmMgSolver3::setRelaxFunc(const ChebyshevSmoother&) does this based on
+//! FdmMgLinearSystem3::matrixVersion.
+//!
+template <typename BlasType>
+class ChebyshevSmoother final {
+ public:
+    //! Constructs the smoother with given parameters.
+    explicit ChebyshevSmoother(
+        const ChebyshevParameters& params = ChebyshevParameters());
+
+    //! Returns the parameters.
+    const ChebyshevParameters& params() const;
+
+    //! Returns the relax function sharing this smoother's cached bounds.
+    MgRelaxFunc<BlasType> relaxFunc() const;
+
+    //! Drops the cached spectral bounds and buffers.
+    void invalidate();
+
+    //! Returns the number of levels with cached spectral bounds.
+    size_t numberOfCachedLevels() const;
+
+ private:
+    struct Level {
+        const typename BlasType::MatrixType* A = nullptr;
+        double lambdaMax = 0.0;
+        typename BlasType::VectorType r;
+        typename BlasType::VectorType d;
+    };
+
+    struct State {
+        ChebyshevParameters params;
+        std::vector<Level> levels;
+    };
+
+    std::shared_ptr<State> _state;
+
+    static void relax(State* state, const typename BlasType::MatrixType& A,
+                      const typename BlasType::VectorType& b,
+                      unsigned int numberOfIterations,
+                      typename BlasType::VectorType* x,
+                      typename BlasType::VectorType* buffer);
+};
+
+}  // namespace jet
+
+#include "detail/chebyshev-inl.h"
+
+#endif  // INCLUDE_JET_CHEBYSHEV_H_
@@ -47,6 +47,9 @@ class CubicSemiLagrangian3 final : public SemiLagrangian3 {
     //!
     std::function<Vector3D(const Vector3D&)> getVectorSamplerFunc(
         const FaceCenteredGrid3& source) const override;
+
+    //! Returns false since this class uses cubic samplers.
+    bool hasLinearSamplers() const override { return false; }
 };
 
 typedef std::shared_ptr<CubicSemiLagrangian3> CubicSemiLagrangian3Ptr;
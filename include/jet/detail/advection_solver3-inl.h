@@ -0,0 +1,35 @@
+// Copyright (c) 2018 Doyub Kim
+//
+// I am making my contributions/submissions to this project solely in my
+// personal capacity and am not conveying any rights to any intellectual
+// property of any third parties.
+
+#ifndef INCLUDE_JET_DETAIL_ADVECTION_SOLVER3_INL_H_
+#define INCLUDE_JET_DETAIL_ADVECTION_SOLVER3_INL_H_
+
+#include <jet/advection_solver3.h>
+#include <jet/macros.h>
+
+namespace jet {
+
+inline void AdvectionSolver3::advectFields(
+    const std::vector<const ScalarGrid3*>& scalarInputs,
+    const std::vector<ScalarGrid3*>& scalarOutputs,
+    const std::vector<const CollocatedVectorGrid3*>& vectorInputs,
+    const std::vector<CollocatedVectorGrid3*>& vectorOutputs,
+    const VectorField3& flow, double dt, const ScalarField3& boundarySdf) {
+    JET_THROW_INVALID_ARG_IF(scalarInputs.size() != scalarOutputs.size());
+    JET_THROW_INVALID_ARG_IF(vectorInputs.size() != vectorOutputs.size());
+
+    for (size_t i = 0; i < scalarInputs.size(); ++i) {
+        advect(*scalarInputs[i], flow, dt, scalarOutputs[i], boundarySdf);
+    }
+
+    for (size_t i = 0; i < vectorInputs.size(); ++i) {
+        advect(*vectorInputs[i], flow, dt, vectorOutputs[i], boundarySdf);
+    }
+}
+
+}  // namespace jet
+
+#endif  // INCLUDE_JET_DETAIL_ADVECTION_SOLVER3_INL_H_
@@ -0,0 +1,47 @@
+// Copyright (c) 2018 Doyub Kim
+//
+// I am making my contributions/submissions to this project solely in my
+// personal capacity and am not conveying any rights to any intellectual
+// property of any third parties.
+
+#ifndef INCLUDE_JET_DETAIL_APIC_SOLVER3_INL_H_
+#define INCLUDE_JET_DETAIL_APIC_SOLVER3_INL_H_
+
+#include <jet/apic_solver3.h>
+#include <jet/parallel.h>
+
+#include <vector>
+
+namespace jet {
+
+inline void ApicSolver3::removeParticles(
+    const ConstArrayAccessor1<char>& shouldRemove) {
+    const size_t n = shouldRemove.size();
+    if (_cX.size() == n && _cY.size() == n && _cZ.size() == n) {
+        std::vector<size_t> keep(n);
+        parallelFor(kZeroSize, n,
+                    [&](size_t i) { keep[i] = shouldRemove[i] ? 0 : 1; });
+
+        std::vector<size_t> newIndices;
+        const size_t newSize = parallelExclusiveScan(keep, &newIndices);
+
+        auto compact = [&](Array1<Vector3D>* data) {
+            Array1<Vector3D> compacted(newSize);
+            parallelFor(kZeroSize, n, [&](size_t i) {
+                if (keep[i]) {
+                    compacted[newIndices[i]] = (*data)[i];
+                }
+            });
+            data->swap(compacted);
+        };
+        compact(&_cX);
+        compact(&_cY);
+        compact(&_cZ);
+    }
+
+    PicSolver3::removeParticles(shouldRemove);
+}
+
+}  // namespace jet
+
+#endif  // INCLUDE_JET_DETAIL_APIC_SOLVER3_INL_H_
@@ -10,11 +10,46 @@
 #include <jet/macros.h>
 #include <jet/math_utils.h>
 #include <algorithm>
+#include <cmath>
 #include <functional>
 #include <limits>
 
 namespace jet {
 
+namespace internal {
+
+// Branch-free equivalent of getBarycentric(x, 0, iHigh, i, f).
+template <typename R>
+inline void getLinearSamplerBarycentric(R x, ssize_t iHigh, ssize_t* i,
+                                        R* f) {
+    const R s = std::floor(x);
+    const ssize_t is = static_cast<ssize_t>(s);
+    const bool below = is < 0 || iHigh == 0;
+    const bool above = is > iHigh - 1;
+    *i = below ? 0 : (above ? iHigh - 1 : is);
+    *f = below ? 0 : (above ? 1 : x - s);
+}
+
+// Trilinear interpolation at (i + fx, j + fy, k + fz) with the same
+// neighbor clamping as LinearArraySampler3::operator().
+template <typename T, typename R>
+inline T linearSamplerTrilerp(const ConstArrayAccessor3<T>& a, ssize_t i,
+                              ssize_t j, ssize_t k, R fx, R fy, R fz) {
+    const ssize_t ip1 = std::min(i + 1, static_cast<ssize_t>(a.size().x) - 1);
+    const ssize_t jp1 = std::min(j + 1, static_cast<ssize_t>(a.size().y) - 1);
+    const ssize_t kp1 = std::min(k + 1, static_cast<ssize_t>(a.size().z) - 1);
+
+    return trilerp(a(i, j, k), a(ip1, j, k), a(i, jp1, k), a(ip1, jp1, k),
+                   a(i, j, kp1), a(ip1, j, kp1), a(i, jp1, kp1),
+                   a(ip1, jp1, kp1), fx, fy, fz);
+}
+
+// Number of points whose coordinates are computed together in the batch
+// sampling functions.
+constexpr size_t kLinearSamplerBlockSize = 64;
+
+}  // namespace internal
+
 template <typename T, typename R>
 NearestArraySampler3<T, R>::NearestArraySampler(
     const ConstArrayAccessor3<T>& accessor,
@@ -148,6 +183,44 @@ T LinearArraySampler3<T, R>::operator()(const Vector3<R>& x) const {
         fz);
 }
 
+template <typename T, typename R>
+void LinearArraySampler3<T, R>::operator()(
+    const ConstArrayAccessor1<Vector3<R>>& pts,
+    ArrayAccessor1<T> results) const {
+    JET_ASSERT(pts.size() == results.size());
+    JET_ASSERT(_gridSpacing.x > std::numeric_limits<R>::epsilon() &&
+               _gridSpacing.y > std::numeric_limits<R>::epsilon() &&
+               _gridSpacing.z > std::numeric_limits<R>::epsilon());
+
+    constexpr size_t kBlockSize = internal::kLinearSamplerBlockSize;
+    const ssize_t iHigh = static_cast<ssize_t>(_accessor.size().x) - 1;
+    const ssize_t jHigh = static_cast<ssize_t>(_accessor.size().y) - 1;
+    const ssize_t kHigh = static_cast<ssize_t>(_accessor.size().z) - 1;
+
+    ssize_t i[kBlockSize], j[kBlockSize], k[kBlockSize];
+    R fx[kBlockSize], fy[kBlockSize], fz[kBlockSize];
+
+    for (size_t begin = 0; begin < pts.size(); begin += kBlockSize) {
+        const size_t n = std::min(kBlockSize, pts.size() - begin);
+
+        for (size_t p = 0; p < n; ++p) {
+            const Vector3<R> normalizedX = (pts[begin + p] - _origin)
+                / _gridSpacing;
+            internal::getLinearSamplerBarycentric(
+                normalizedX.x, iHigh, &i[p], &fx[p]);
+            internal::getLinearSamplerBarycentric(
+                normalizedX.y, jHigh, &j[p], &fy[p]);
+            internal::getLinearSamplerBarycentric(
+                normalizedX.z, kHigh, &k[p], &fz[p]);
+        }
+
+        for (size_t p = 0; p < n; ++p) {
+            results[begin + p] = internal::linearSamplerTrilerp(
+                _accessor, i[p], j[p], k[p], fx[p], fy[p], fz[p]);
+        }
+    }
+}
+
 template <typename T, typename R>
 void LinearArraySampler3<T, R>::getCoordinatesAndWeights(
     const Vector3<R>& x,
@@ -8,6 +8,8 @@
 #define INCLUDE_JET_DETAIL_CG_INL_H_
 
 #include <jet/constants.h>
+#include <jet/timer.h>
+
 #include <limits>
 
 namespace jet {
@@ -15,7 +17,7 @@ namespace jet {
 template <
     typename BlasType,
     typename PrecondType>
-void pcg(
+bool pcg(
     const typename BlasType::MatrixType& A,
     const typename BlasType::VectorType& b,
     unsigned int maxNumberOfIterations,
@@ -27,7 +29,10 @@ void pcg(
     typename BlasType::VectorType* q,
     typename BlasType::VectorType* s,
     unsigned int* lastNumberOfIterations,
-    double* lastResidualNorm) {
+    double* lastResidualNorm,
+    double maxDurationInSeconds) {
+    Timer timer;
+
     // Clear
     BlasType::set(0, r);
     BlasType::set(0, d);
@@ -45,6 +50,7 @@ void pcg(
 
     unsigned int iter = 0;
     bool trigger = false;
+    bool hitTimeLimit = false;
     while (sigmaNew > square(tolerance) && iter < maxNumberOfIterations) {
         // q = Ad
         BlasType::mvm(A, *d, q);
@@ -85,16 +91,170 @@ void pcg(
         BlasType::axpy(beta, *d, *s, d);
 
         ++iter;
+
+        if (maxDurationInSeconds < kMaxD &&
+            timer.durationInSeconds() >= maxDurationInSeconds) {
+            hitTimeLimit = sigmaNew > square(tolerance) &&
+                           iter < maxNumberOfIterations;
+            break;
+        }
     }
 
     *lastNumberOfIterations = iter;
 
     // std::fabs(sigmaNew) - Workaround for negative zero
     *lastResidualNorm = std::sqrt(std::fabs(sigmaNew));
+
+    return hitTimeLimit;
+}
+
+template <typename BlasType>
+bool cg(
+    const typename BlasType::MatrixType& A,
+    const typename BlasType::VectorType& b,
+    unsigned int maxNumberOfIterations,
+    double tolerance,
+    typename BlasType::VectorType* x,
+    typename BlasType::VectorType* r,
+    typename BlasType::VectorType* d,
+    typename BlasType::VectorType* q,
+    typename BlasType::VectorType* s,
+    unsigned int* lastNumberOfIterations,
+    double* lastResidualNorm,
+    double maxDurationInSeconds) {
+    typedef NullCgPreconditioner<BlasType> PrecondType;
+    PrecondType precond;
+    return pcg<BlasType, PrecondType>(
+        A,
+        b,
+        maxNumberOfIterations,
+        tolerance,
+        &precond,
+        x,
+        r,
+        d,
+        q,
+        s,
+        lastNumberOfIterations,
+        lastResidualNorm,
+        maxDurationInSeconds);
+}
+
+template <
+    typename BlasType,
+    typename PrecondType>
+void batchedPcg(
+    const typename BlasType::MatrixType& A,
+    const typename BlasType::VectorType& b,
+    unsigned int maxNumberOfIterations,
+    double tolerance,
+    PrecondType* M,
+    typename BlasType::VectorType* x,
+    typename BlasType::VectorType* r,
+    typename BlasType::VectorType* d,
+    typename BlasType::VectorType* q,
+    typename BlasType::VectorType* s,
+    unsigned int* lastNumberOfIterations,
+    typename BlasType::ScalarType* lastResidualNorms) {
+    typedef typename BlasType::ScalarType ScalarType;
+    const size_t numberOfRhs = BlasType::kNumberOfRhs;
+
+    // Clear
+    BlasType::set(0, r);
+    BlasType::set(0, d);
+    BlasType::set(0, q);
+    BlasType::set(0, s);
+
+    // r = b - Ax
+    BlasType::residual(A, *x, b, r);
+
+    // d = M^-1r
+    M->solve(*r, d);
+
+    // sigmaNew = r.d
+    ScalarType sigmaNew = BlasType::dot(*r, *d);
+
+    // Right-hand sides that have not converged yet
+    auto updateActive = [&](ScalarType* active) {
+        bool anyActive = false;
+        for (size_t c = 0; c < numberOfRhs; ++c) {
+            (*active)[c] = (sigmaNew[c] > square(tolerance)) ? 1.0 : 0.0;
+            anyActive |= (*active)[c] > 0.0;
+        }
+        return anyActive;
+    };
+
+    ScalarType active;
+    bool anyActive = updateActive(&active);
+
+    unsigned int iter = 0;
+    bool trigger = false;
+    while (anyActive && iter < maxNumberOfIterations) {
+        // q = Ad
+        BlasType::mvm(A, *d, q);
+
+        // alpha = sigmaNew/d.q, zero for the converged ones
+        ScalarType dq = BlasType::dot(*d, *q);
+        ScalarType alpha;
+        for (size_t c = 0; c < numberOfRhs; ++c) {
+            alpha[c] = (active[c] > 0.0) ? sigmaNew[c] / dq[c] : 0.0;
+        }
+
+        // x = x + alpha*d
+        BlasType::axpy(alpha, *d, *x, x);
+
+        // if i is divisible by 50...
+        if (trigger || (iter % 50 == 0 && iter > 0)) {
+            // r = b - Ax
+            BlasType::residual(A, *x, b, r);
+            trigger = false;
+        } else {
+            // r = r - alpha*q
+            ScalarType minusAlpha;
+            for (size_t c = 0; c < numberOfRhs; ++c) {
+                minusAlpha[c] = -alpha[c];
+            }
+            BlasType::axpy(minusAlpha, *q, *r, r);
+        }
+
+        // s = M^-1r
+        M->solve(*r, s);
+
+        // sigmaOld = sigmaNew
+        ScalarType sigmaOld = sigmaNew;
+
+        // sigmaNew = r.s
+        sigmaNew = BlasType::dot(*r, *s);
+
+        // beta = sigmaNew/sigmaOld
+        ScalarType beta;
+        for (size_t c = 0; c < numberOfRhs; ++c) {
+            if (active[c] > 0.0) {
+                if (sigmaNew[c] > sigmaOld[c]) {
+                    trigger = true;
+                }
+                beta[c] = sigmaNew[c] / sigmaOld[c];
+            }
+        }
+
+        // d = s + beta*d
+        BlasType::axpy(beta, *d, *s, d);
+
+        anyActive = updateActive(&active);
+
+        ++iter;
+    }
+
+    *lastNumberOfIterations = iter;
+
+    for (size_t c = 0; c < numberOfRhs; ++c) {
+        // std::fabs(sigmaNew) - Workaround for negative zero
+        (*lastResidualNorms)[c] = std::sqrt(std::fabs(sigmaNew[c]));
+    }
 }
 
 template <typename BlasType>
-void cg(
+void batchedCg(
     const typename BlasType::MatrixType& A,
     const typename BlasType::VectorType& b,
     unsigned int maxNumberOfIterations,
@@ -105,10 +265,10 @@ void cg(
     typename BlasType::VectorType* q,
     typename BlasType::VectorType* s,
     unsigned int* lastNumberOfIterations,
-    double* lastResidualNorm) {
+    typename BlasType::ScalarType* lastResidualNorms) {
     typedef NullCgPreconditioner<BlasType> PrecondType;
     PrecondType precond;
-    pcg<BlasType, PrecondType>(
+    batchedPcg<BlasType, PrecondType>(
         A,
         b,
         maxNumberOfIterations,
@@ -120,7 +280,7 @@ void cg(
         q,
         s,
         lastNumberOfIterations,
-        lastResidualNorm);
+        lastResidualNorms);
 }
 
 }  // namespace jet
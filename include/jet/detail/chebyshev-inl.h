@@ -0,0 +1,290 @@
+// Copyright (c) 2018 Doyub Kim
+//
+// I am making my contributions/submissions to this project solely in my
+// personal capacity and am not conveying any rights to any intellectual
+// property of any third parties.
+
+#ifndef INCLUDE_JET_DETAIL_CHEBYSHEV_INL_H_
+#define INCLUDE_JET_DETAIL_CHEBYSHEV_INL_H_
+
+#include <jet/array2.h>
+#include <jet/array3.h>
+#include <jet/chebyshev.h>
+#include <jet/constants.h>
+#include <jet/parallel.h>
+#include <jet/vector_n.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+namespace jet {
+
+namespace internal {
+
+// Returns the largest eigenvalue of the symmetric tridiagonal matrix with
+// diagonal alpha and off-diagonal beta using Sturm sequence bisection.
+inline double largestTridiagonalEigenvalue(const std::vector<double>& alpha,
+                                           const std::vector<double>& beta) {
+    const size_t n = alpha.size();
+    if (n == 0) {
+        return 0.0;
+    }
+
+    // Gershgorin interval
+    double lo = alpha[0];
+    double hi = alpha[0];
+    for (size_t i = 0; i < n; ++i) {
+        double radius = ((i > 0) ? std::fabs(beta[i - 1]) : 0.0) +
+                        ((i + 1 < n) ? std::fabs(beta[i]) : 0.0);
+        lo = std::min(lo, alpha[i] - radius);
+        hi = std::max(hi, alpha[i] + radius);
+    }
+
+    // Number of eigenvalues smaller than x
+    auto countBelow = [&](double x) {
+        size_t count = 0;
+        double q = 1.0;
+        for (size_t i = 0; i < n; ++i) {
+            double b2 = (i > 0) ? beta[i - 1] * beta[i - 1] : 0.0;
+            q = alpha[i] - x - ((i > 0) ? b2 / q : 0.0);
+            if (q == 0.0) {
+                q = kEpsilonD * std::max(std::fabs(hi), 1.0);
+            }
+            if (q < 0.0) {
+                ++count;
+            }
+        }
+        return count;
+    };
+
+    for (int iter = 0; iter < 100 && hi - lo > kEpsilonD * std::fabs(hi);
+         ++iter) {
+        double mid = 0.5 * (lo + hi);
+        if (countBelow(mid) < n) {
+            lo = mid;
+        } else {
+            hi = mid;
+        }
+    }
+
+    return hi;
+}
+
+// Fills a vector with deterministic pseudo-random values in [-1, 1]. A rough
+// starting vector overlaps with the high-frequency modes, which makes the
+// Lanczos estimate of the largest eigenvalue converge in a few steps.
+template <typename T>
+void fillLanczosStart(T* data, size_t n) {
+    parallelFor(kZeroSize, n, [&](size_t i) {
+        uint32_t h = static_cast<uint32_t>(i) * 2654435761u;
+        h ^= h >> 16;
+        data[i] = static_cast<T>(h & 0xffff) / static_cast<T>(32767.5) -
+                  static_cast<T>(1);
+    });
+}
+
+template <typename T>
+void fillLanczosStart(Array2<T>* v) {
+    fillLanczosStart(v->data(), v->width() * v->height());
+}
+
+template <typename T>
+void fillLanczosStart(Array3<T>* v) {
+    fillLanczosStart(v->data(), v->width() * v->height() * v->depth());
+}
+
+template <typename T>
+void fillLanczosStart(VectorN<T>* v) {
+    fillLanczosStart(v->data(), v->size());
+}
+
+}  // namespace internal
+
+template <typename BlasType>
+double lanczosLargestEigenvalue(const typename BlasType::MatrixType& A,
+                                const typename BlasType::VectorType& start,
+                                unsigned int numberOfIterations,
+                                typename BlasType::VectorType* v,
+                                typename BlasType::VectorType* vPrev,
+                                typename BlasType::VectorType* w) {
+    std::vector<double> alpha;
+    std::vector<double> beta;
+
+    double norm = BlasType::l2Norm(start);
+    if (norm <= 0.0) {
+        return 0.0;
+    }
+
+    // v = start / |start|
+    BlasType::set(0.0, v);
+    BlasType::axpy(1.0 / norm, start, *v, v);
+    BlasType::set(0.0, vPrev);
+
+    double betaPrev = 0.0;
+    for (unsigned int iter = 0; iter < numberOfIterations; ++iter) {
+        // w = Av - beta_{j-1} v_{j-1}
+        BlasType::mvm(A, *v, w);
+        BlasType::axpy(-betaPrev, *vPrev, *w, w);
+
+        // w = w - alpha_j v_j
+        double a = BlasType::dot(*w, *v);
+        BlasType::axpy(-a, *v, *w, w);
+        alpha.push_back(a);
+
+        double b = BlasType::l2Norm(*w);
+        if (b <= kEpsilonD * std::fabs(a) || iter + 1 == numberOfIterations) {
+            break;
+        }
+        beta.push_back(b);
+
+        // v_{j-1} = v_j, v_j = w / beta_j
+        BlasType::set(*v, vPrev);
+        BlasType::set(0.0, v);
+        BlasType::axpy(1.0 / b, *w, *v, v);
+        betaPrev = b;
+    }
+
+    return internal::largestTridiagonalEigenvalue(alpha, beta);
+}
+
+template <typename BlasType>
+void chebyshev(const typename BlasType::MatrixType& A,
+               const typename BlasType::VectorType& b,
+               unsigned int numberOfIterations, double lambdaMin,
+               double lambdaMax, typename BlasType::VectorType* x,
+               typename BlasType::VectorType* r,
+               typename BlasType::VectorType* d,
+               typename BlasType::VectorType* q) {
+    if (numberOfIterations == 0 || lambdaMax <= 0.0) {
+        return;
+    }
+
+    const double theta = 0.5 * (lambdaMax + lambdaMin);
+    const double delta = 0.5 * (lambdaMax - lambdaMin);
+    const double sigma = theta / delta;
+    double rho = 1.0 / sigma;
+
+    // r = b - Ax
+    BlasType::residual(A, *x, b, r);
+
+    // d = r / theta
+    BlasType::set(0.0, d);
+    BlasType::axpy(1.0 / theta, *r, *d, d);
+
+    for (unsigned int iter = 0; iter < numberOfIterations; ++iter) {
+        // x = x + d
+        BlasType::axpy(1.0, *d, *x, x);
+
+        if (iter + 1 == numberOfIterations) {
+            break;
+        }
+
+        // r = r - Ad
+        BlasType::mvm(A, *d, q);
+        BlasType::axpy(-1.0, *q, *r, r);
+
+        // d = rhoNew * rho * d + 2 * rhoNew / delta * r
+        double rhoNew = 1.0 / (2.0 * sigma - rho);
+        BlasType::set(0.0, q);
+        BlasType::axpy(2.0 * rhoNew / delta, *r, *q, q);
+        BlasType::axpy(rhoNew * rho, *d, *q, d);
+        rho = rhoNew;
+    }
+}
+
+template <typename BlasType>
+void ChebyshevPreconditioner<BlasType>::build(
+    const typename BlasType::MatrixType& matrix,
+    const typename BlasType::VectorType& b) {
+    A = &matrix;
+    r = b;
+    d = b;
+    q = b;
+
+    internal::fillLanczosStart(&r);
+
+    lambdaMax = params.safetyFactor *
+                lanczosLargestEigenvalue<BlasType>(
+                    matrix, r, params.numberOfLanczosIterations, &d, &q, &r);
+}
+
+template <typename BlasType>
+void ChebyshevPreconditioner<BlasType>::solve(
+    const typename BlasType::VectorType& b, typename BlasType::VectorType* x) {
+    BlasType::set(0.0, x);
+    chebyshev<BlasType>(*A, b, degree, lambdaMax / params.eigenvalueRatio,
+                        lambdaMax, x, &r, &d, &q);
+}
+
+template <typename BlasType>
+ChebyshevSmoother<BlasType>::ChebyshevSmoother(
+    const ChebyshevParameters& params)
+    : _state(std::make_shared<State>()) {
+    _state->params = params;
+}
+
+template <typename BlasType>
+const ChebyshevParameters& ChebyshevSmoother<BlasType>::params() const {
+    return _state->params;
+}
+
+template <typename BlasType>
+MgRelaxFunc<BlasType> ChebyshevSmoother<BlasType>::relaxFunc() const {
+    std::shared_ptr<State> state = _state;
+    return [state](const typename BlasType::MatrixType& A,
+                   const typename BlasType::VectorType& b,
+                   unsigned int numberOfIterations, double,
+                   typename BlasType::VectorType* x,
+                   typename BlasType::VectorType* buffer) {
+        relax(state.get(), A, b, numberOfIterations, x, buffer);
+    };
+}
+
+template <typename BlasType>
+void ChebyshevSmoother<BlasType>::invalidate() {
+    _state->levels.clear();
+}
+
+template <typename BlasType>
+size_t ChebyshevSmoother<BlasType>::numberOfCachedLevels() const {
+    return _state->levels.size();
+}
+
+template <typename BlasType>
+void ChebyshevSmoother<BlasType>::relax(
+    State* state, const typename BlasType::MatrixType& A,
+    const typename BlasType::VectorType& b, unsigned int numberOfIterations,
+    typename BlasType::VectorType* x, typename BlasType::VectorType* buffer) {
+    auto iter = std::find_if(state->levels.begin(), state->levels.end(),
+                             [&](const Level& l) { return l.A == &A; });
+
+    if (iter == state->levels.end() || iter->r.size() != b.size()) {
+        if (iter == state->levels.end()) {
+            state->levels.emplace_back();
+            iter = state->levels.end() - 1;
+        }
+
+        Level& level = *iter;
+        level.A = &A;
+        level.r = b;
+        level.d = b;
+
+        internal::fillLanczosStart(&level.r);
+
+        level.lambdaMax =
+            state->params.safetyFactor *
+            lanczosLargestEigenvalue<BlasType>(
+                A, level.r, state->params.numberOfLanczosIterations, &level.d,
+                buffer, &level.r);
+    }
+
+    Level& level = *iter;
+    chebyshev<BlasType>(A, b, numberOfIterations,
+                        level.lambdaMax / state->params.eigenvalueRatio,
+                        level.lambdaMax, x, &level.r, &level.d, buffer);
+}
+
+}  // namespace jet
+
+#endif  // INCLUDE_JET_DETAIL_CHEBYSHEV_INL_H_
@@ -0,0 +1,80 @@
+// Copyright (c) 2018 Doyub Kim
+//
+// I am making my contributions/submissions to this project solely in my
+// personal capacity and am not conveying any rights to any intellectual
+// property of any third parties.
+
+#ifndef INCLUDE_JET_DETAIL_FACE_CENTERED_GRID3_INL_H_
+#define INCLUDE_JET_DETAIL_FACE_CENTERED_GRID3_INL_H_
+
+#include <jet/face_centered_grid3.h>
+#include <jet/macros.h>
+
+#include <algorithm>
+
+namespace jet {
+
+inline void FaceCenteredGrid3::sample(const ConstArrayAccessor1<Vector3D>& x,
+                                      ArrayAccessor1<Vector3D> results) const {
+    JET_ASSERT(x.size() == results.size());
+
+    const Vector3D& h = gridSpacing();
+
+    // Per axis, the face-aligned origin and size come from the component
+    // stored on the faces of that axis, and the cell-centered ones from the
+    // other two components.
+    const Vector3D faceOrigin(_dataOriginU.x, _dataOriginV.y, _dataOriginW.z);
+    const Vector3D centerOrigin(_dataOriginV.x, _dataOriginW.y,
+                                _dataOriginU.z);
+    const ssize_t faceHighX = static_cast<ssize_t>(_dataU.size().x) - 1;
+    const ssize_t faceHighY = static_cast<ssize_t>(_dataV.size().y) - 1;
+    const ssize_t faceHighZ = static_cast<ssize_t>(_dataW.size().z) - 1;
+    const ssize_t centerHighX = static_cast<ssize_t>(_dataV.size().x) - 1;
+    const ssize_t centerHighY = static_cast<ssize_t>(_dataW.size().y) - 1;
+    const ssize_t centerHighZ = static_cast<ssize_t>(_dataU.size().z) - 1;
+
+    const ConstArrayAccessor3<double> u = _dataU.constAccessor();
+    const ConstArrayAccessor3<double> v = _dataV.constAccessor();
+    const ConstArrayAccessor3<double> w = _dataW.constAccessor();
+
+    constexpr size_t kBlockSize = internal::kLinearSamplerBlockSize;
+    ssize_t fi[kBlockSize], fj[kBlockSize], fk[kBlockSize];
+    ssize_t ci[kBlockSize], cj[kBlockSize], ck[kBlockSize];
+    double ffx[kBlockSize], ffy[kBlockSize], ffz[kBlockSize];
+    double cfx[kBlockSize], cfy[kBlockSize], cfz[kBlockSize];
+
+    for (size_t begin = 0; begin < x.size(); begin += kBlockSize) {
+        const size_t n = std::min(kBlockSize, x.size() - begin);
+
+        for (size_t p = 0; p < n; ++p) {
+            const Vector3D face = (x[begin + p] - faceOrigin) / h;
+            const Vector3D center = (x[begin + p] - centerOrigin) / h;
+            internal::getLinearSamplerBarycentric(
+                face.x, faceHighX, &fi[p], &ffx[p]);
+            internal::getLinearSamplerBarycentric(
+                face.y, faceHighY, &fj[p], &ffy[p]);
+            internal::getLinearSamplerBarycentric(
+                face.z, faceHighZ, &fk[p], &ffz[p]);
+            internal::getLinearSamplerBarycentric(
+                center.x, centerHighX, &ci[p], &cfx[p]);
+            internal::getLinearSamplerBarycentric(
+                center.y, centerHighY, &cj[p], &cfy[p]);
+            internal::getLinearSamplerBarycentric(
+                center.z, centerHighZ, &ck[p], &cfz[p]);
+        }
+
+        for (size_t p = 0; p < n; ++p) {
+            results[begin + p] = Vector3D(
+                internal::linearSamplerTrilerp(u, fi[p], cj[p], ck[p], ffx[p],
+                                               cfy[p], cfz[p]),
+                internal::linearSamplerTrilerp(v, ci[p], fj[p], ck[p], cfx[p],
+                                               ffy[p], cfz[p]),
+                internal::linearSamplerTrilerp(w, ci[p], cj[p], fk[p], cfx[p],
+                                               cfy[p], ffz[p]));
+        }
+    }
+}
+
+}  // namespace jet
+
+#endif  // INCLUDE_JET_DETAIL_FACE_CENTERED_GRID3_INL_H_
@@ -0,0 +1,297 @@
+// Copyright (c) 2018 Doyub Kim
+//
+// I am making my contributions/submissions to this project solely in my
+// personal capacity and am not conveying any rights to any intellectual
+// property of any third parties.
+
+#ifndef INCLUDE_JET_DETAIL_FAST_SWEEPING_LEVEL_SET_SOLVER2_INL_H_
+#define INCLUDE_JET_DETAIL_FAST_SWEEPING_LEVEL_SET_SOLVER2_INL_H_
+
+#include <jet/array2.h>
+#include <jet/constants.h>
+#include <jet/fast_sweeping_level_set_solver2.h>
+#include <jet/level_set_utils.h>
+#include <jet/macros.h>
+#include <jet/math_utils.h>
+#include <jet/parallel.h>
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+namespace jet {
+
+namespace internal {
+
+constexpr size_t kFastSweepingBlockSize2 = 16;
+
+// Smallest u that satisfies the upwind discretization of |grad u| = 1, given
+// the smaller neighbor value along each axis.
+inline double fastSweepingDistance2(double ux, double uy,
+                                    const Vector2D& gridSpacing) {
+    double hx = gridSpacing.x;
+    double hy = gridSpacing.y;
+    if (uy < ux) {
+        std::swap(ux, uy);
+        std::swap(hx, hy);
+    }
+
+    const double u = ux + hx;
+    if (u <= uy) {
+        return u;
+    }
+
+    const double a = 1.0 / square(hx) + 1.0 / square(hy);
+    const double b = ux / square(hx) + uy / square(hy);
+    const double c = square(ux / hx) + square(uy / hy) - 1.0;
+    return (b + std::sqrt(std::max(b * b - a * c, 0.0))) / a;
+}
+
+//
+// Invokes func(i, j) for every point of a grid of the given size in the four
+// sweep orders of the fast sweeping method.
+//
+// The grid is split into blocks, and the blocks of one diagonal line
+// bi + bj = const of a sweep are processed in parallel, each in the order of
+// the sweep (Detrixhe et al., "A parallel fast sweeping method for the
+// Eikonal equation", 2013, applied to blocks instead of points). Face
+// neighbors of a point are in its own block or in a block of the previous or
+// next line, so func may read the four neighbors and write the point itself
+// without races, and the result does not depend on the number of threads.
+//
+template <typename Function>
+void fastSweep2(const Size2& size, size_t blockSize, const Function& func) {
+    const Size2 numberOfBlocks((size.x + blockSize - 1) / blockSize,
+                               (size.y + blockSize - 1) / blockSize);
+    if (numberOfBlocks.x * numberOfBlocks.y == 0) {
+        return;
+    }
+
+    const ssize_t nbx = static_cast<ssize_t>(numberOfBlocks.x);
+    const ssize_t nby = static_cast<ssize_t>(numberOfBlocks.y);
+    const ssize_t numberOfLines = nbx + nby - 1;
+
+    for (int sweep = 0; sweep < 4; ++sweep) {
+        const bool forwardX = (sweep & 1) == 0;
+        const bool forwardY = (sweep & 2) == 0;
+
+        auto sweepBlock = [&](ssize_t bi, ssize_t bj) {
+            const ssize_t i0 = bi * blockSize;
+            const ssize_t j0 = bj * blockSize;
+            const ssize_t ni = std::min<ssize_t>(blockSize, size.x - i0);
+            const ssize_t nj = std::min<ssize_t>(blockSize, size.y - j0);
+            for (ssize_t jj = 0; jj < nj; ++jj) {
+                const size_t j = j0 + (forwardY ? jj : nj - 1 - jj);
+                for (ssize_t ii = 0; ii < ni; ++ii) {
+                    const size_t i = i0 + (forwardX ? ii : ni - 1 - ii);
+                    func(i, j);
+                }
+            }
+        };
+
+        for (ssize_t line = 0; line < numberOfLines; ++line) {
+            const ssize_t bjBegin = std::max<ssize_t>(0, line - nbx + 1);
+            const ssize_t bjEnd = std::min<ssize_t>(nby, line + 1);
+            parallelFor(bjBegin, bjEnd, [&](ssize_t bj) {
+                const ssize_t bi = line - bj;
+                sweepBlock(forwardX ? bi : nbx - 1 - bi,
+                           forwardY ? bj : nby - 1 - bj);
+            });
+        }
+    }
+}
+
+// Samples sdf at the data points of a grid.
+inline void sampleFastSweepingSdf2(const ScalarField2& sdf,
+                                   const Grid2::DataPositionFunc& pos,
+                                   Array2<double>* output) {
+    output->parallelForEachIndex([&](size_t i, size_t j) {
+        (*output)(i, j) = sdf.sample(pos(i, j));
+    });
+}
+
+}  // namespace internal
+
+inline FastSweepingLevelSetSolver2::FastSweepingLevelSetSolver2() {}
+
+inline void FastSweepingLevelSetSolver2::reinitialize(
+    const ScalarGrid2& inputSdf, double maxDistance, ScalarGrid2* outputSdf) {
+    JET_THROW_INVALID_ARG_IF(!inputSdf.hasSameShape(*outputSdf));
+
+    const Size2 size = inputSdf.dataSize();
+    const Vector2D h = inputSdf.gridSpacing();
+    const auto input = inputSdf.constDataAccessor();
+    auto output = outputSdf->dataAccessor();
+
+    // Unsigned distance. Points next to a sign change get the distance to
+    // the linearly interpolated crossings and stay fixed.
+    Array2<double> dist(size, kMaxD);
+    Array2<char> fixed(size, 0);
+    parallelFor(kZeroSize, size.x, kZeroSize, size.y, [&](size_t i,
+                                                          size_t j) {
+        const double phi = input(i, j);
+        const bool inside = isInsideSdf(phi);
+        auto crossing = [&](bool valid, double neighbor, double spacing,
+                            double* d) {
+            if (valid && isInsideSdf(neighbor) != inside) {
+                *d = std::min(
+                    *d, std::max(phi / (phi - neighbor) * spacing, kEpsilonD));
+            }
+        };
+
+        double dx = kMaxD;
+        double dy = kMaxD;
+        crossing(i > 0, (i > 0) ? input(i - 1, j) : phi, h.x, &dx);
+        crossing(i + 1 < size.x, (i + 1 < size.x) ? input(i + 1, j) : phi,
+                 h.x, &dx);
+        crossing(j > 0, (j > 0) ? input(i, j - 1) : phi, h.y, &dy);
+        crossing(j + 1 < size.y, (j + 1 < size.y) ? input(i, j + 1) : phi,
+                 h.y, &dy);
+
+        double sumInvD2 = 0.0;
+        if (dx < kMaxD) {
+            sumInvD2 += 1.0 / square(dx);
+        }
+        if (dy < kMaxD) {
+            sumInvD2 += 1.0 / square(dy);
+        }
+        if (sumInvD2 > 0.0) {
+            dist(i, j) = 1.0 / std::sqrt(sumInvD2);
+            fixed(i, j) = 1;
+        }
+    });
+
+    // A point without a fixed neighbor of the other sign only sees points of
+    // its own sign, so the unsigned distance can be swept for both sides at
+    // once.
+    internal::fastSweep2(
+        size, internal::kFastSweepingBlockSize2, [&](size_t i, size_t j) {
+            if (fixed(i, j)) {
+                return;
+            }
+            const double ux =
+                std::min((i > 0) ? dist(i - 1, j) : kMaxD,
+                         (i + 1 < size.x) ? dist(i + 1, j) : kMaxD);
+            const double uy =
+                std::min((j > 0) ? dist(i, j - 1) : kMaxD,
+                         (j + 1 < size.y) ? dist(i, j + 1) : kMaxD);
+            dist(i, j) = std::min(dist(i, j),
+                                  internal::fastSweepingDistance2(ux, uy, h));
+        });
+
+    parallelFor(kZeroSize, size.x, kZeroSize, size.y, [&](size_t i,
+                                                          size_t j) {
+        const double d = std::min(dist(i, j), maxDistance);
+        output(i, j) = isInsideSdf(input(i, j)) ? -d : d;
+    });
+}
+
+inline void FastSweepingLevelSetSolver2::extrapolate(const ScalarGrid2& input,
+                                                     const ScalarField2& sdf,
+                                                     double maxDistance,
+                                                     ScalarGrid2* output) {
+    JET_THROW_INVALID_ARG_IF(!input.hasSameShape(*output));
+
+    Array2<double> sdfGrid(input.dataSize());
+    internal::sampleFastSweepingSdf2(sdf, input.dataPosition(), &sdfGrid);
+
+    extrapolate(input.constDataAccessor(), sdfGrid.constAccessor(),
+                input.gridSpacing(), maxDistance, output->dataAccessor());
+}
+
+inline void FastSweepingLevelSetSolver2::extrapolate(
+    const CollocatedVectorGrid2& input, const ScalarField2& sdf,
+    double maxDistance, CollocatedVectorGrid2* output) {
+    JET_THROW_INVALID_ARG_IF(!input.hasSameShape(*output));
+
+    Array2<double> sdfGrid(input.dataSize());
+    internal::sampleFastSweepingSdf2(sdf, input.dataPosition(), &sdfGrid);
+
+    extrapolate(input.constDataAccessor(), sdfGrid.constAccessor(),
+                input.gridSpacing(), maxDistance, output->dataAccessor());
+}
+
+inline void FastSweepingLevelSetSolver2::extrapolate(
+    const FaceCenteredGrid2& input, const ScalarField2& sdf,
+    double maxDistance, FaceCenteredGrid2* output) {
+    JET_THROW_INVALID_ARG_IF(!input.hasSameShape(*output));
+
+    const Vector2D& h = input.gridSpacing();
+    Array2<double> sdfGrid;
+
+    sdfGrid.resize(input.uSize());
+    internal::sampleFastSweepingSdf2(sdf, input.uPosition(), &sdfGrid);
+    extrapolate(input.uConstAccessor(), sdfGrid.constAccessor(), h,
+                maxDistance, output->uAccessor());
+
+    sdfGrid.resize(input.vSize());
+    internal::sampleFastSweepingSdf2(sdf, input.vPosition(), &sdfGrid);
+    extrapolate(input.vConstAccessor(), sdfGrid.constAccessor(), h,
+                maxDistance, output->vAccessor());
+}
+
+template <typename T>
+void FastSweepingLevelSetSolver2::extrapolate(
+    const ConstArrayAccessor2<T>& input,
+    const ConstArrayAccessor2<double>& sdf, const Vector2D& gridSpacing,
+    double maxDistance, ArrayAccessor2<T> output) {
+    const Size2 size = input.size();
+    const Vector2D invH2 = 1.0 / (gridSpacing * gridSpacing);
+
+    // The values are swept in a copy, so input and output may be the same.
+    Array2<T> values(size);
+    Array2<char> valid(size);
+    parallelFor(kZeroSize, size.x, kZeroSize, size.y, [&](size_t i,
+                                                          size_t j) {
+        values(i, j) = input(i, j);
+        valid(i, j) = isInsideSdf(sdf(i, j)) ? 1 : 0;
+    });
+
+    // Solves grad(value) . grad(sdf) = 0 with the upwind neighbors, which
+    // are the ones with the smaller level set along each axis.
+    internal::fastSweep2(
+        size, internal::kFastSweepingBlockSize2, [&](size_t i, size_t j) {
+            const double phi = sdf(i, j);
+            if (valid(i, j) == 1 || phi >= maxDistance) {
+                return;
+            }
+
+            T sum = T();
+            double sumWeights = 0.0;
+            auto addUpwind = [&](bool hasPrev, size_t i0, size_t j0,
+                                 bool hasNext, size_t i1, size_t j1,
+                                 double weight) {
+                double phiUpwind = phi;
+                T value = T();
+                if (hasPrev && valid(i0, j0) && sdf(i0, j0) < phiUpwind) {
+                    phiUpwind = sdf(i0, j0);
+                    value = values(i0, j0);
+                }
+                if (hasNext && valid(i1, j1) && sdf(i1, j1) < phiUpwind) {
+                    phiUpwind = sdf(i1, j1);
+                    value = values(i1, j1);
+                }
+                if (phiUpwind < phi) {
+                    const double w = (phi - phiUpwind) * weight;
+                    sum += w * value;
+                    sumWeights += w;
+                }
+            };
+            addUpwind(i > 0, i - 1, j, i + 1 < size.x, i + 1, j, invH2.x);
+            addUpwind(j > 0, i, j - 1, j + 1 < size.y, i, j + 1, invH2.y);
+
+            if (sumWeights > 0.0) {
+                values(i, j) = sum / sumWeights;
+                valid(i, j) = 2;
+            }
+        });
+
+    parallelFor(kZeroSize, size.x, kZeroSize, size.y, [&](size_t i,
+                                                          size_t j) {
+        output(i, j) = values(i, j);
+    });
+}
+
+}  // namespace jet
+
+#endif  // INCLUDE_JET_DETAIL_FAST_SWEEPING_LEVEL_SET_SOLVER2_INL_H_
@@ -0,0 +1,330 @@
+// Copyright (c) 2018 Doyub Kim
+//
+// I am making my contributions/submissions to this project solely in my
+// personal capacity and am not conveying any rights to any intellectual
+// property of any third parties.
+
+#ifndef INCLUDE_JET_DETAIL_FAST_SWEEPING_LEVEL_SET_SOLVER3_INL_H_
+#define INCLUDE_JET_DETAIL_FAST_SWEEPING_LEVEL_SET_SOLVER3_INL_H_
+
+#include <jet/array3.h>
+#include <jet/constants.h>
+#include <jet/fast_sweeping_level_set_solver3.h>
+#include <jet/level_set_utils.h>
+#include <jet/macros.h>
+#include <jet/math_utils.h>
+#include <jet/parallel.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <utility>
+
+namespace jet {
+
+namespace internal {
+
+constexpr size_t kFastSweepingBlockSize3 = 8;
+
+// Smallest u that satisfies the upwind discretization of |grad u| = 1, given
+// the smaller neighbor value along each axis.
+inline double fastSweepingDistance3(double ux, double uy, double uz,
+                                    const Vector3D& gridSpacing) {
+    std::array<std::pair<double, double>, 3> terms = {
+        {{ux, gridSpacing.x}, {uy, gridSpacing.y}, {uz, gridSpacing.z}}};
+    std::sort(terms.begin(), terms.end());
+
+    double u = terms[0].first + terms[0].second;
+    double a = 0.0;
+    double b = 0.0;
+    double c = -1.0;
+    for (int n = 0; n < 3 && u > terms[n].first; ++n) {
+        const double invH2 = 1.0 / square(terms[n].second);
+        a += invH2;
+        b += terms[n].first * invH2;
+        c += square(terms[n].first) * invH2;
+        u = (b + std::sqrt(std::max(b * b - a * c, 0.0))) / a;
+    }
+
+    return u;
+}
+
+//
+// Invokes func(i, j, k) for every point of a grid of the given size in the
+// eight sweep orders of the fast sweeping method.
+//
+// The grid is split into blocks, and the blocks of one diagonal plane
+// bi + bj + bk = const of a sweep are processed in parallel, each in the
+// order of the sweep (Detrixhe et al., "A parallel fast sweeping method for
+// the Eikonal equation", 2013, applied to blocks instead of points). Face
+// neighbors of a point are in its own block or in a block of the previous or
+// next plane, so func may read the six neighbors and write the point itself
+// without races, and the result does not depend on the number of threads.
+//
+template <typename Function>
+void fastSweep3(const Size3& size, size_t blockSize, const Function& func) {
+    const Size3 numberOfBlocks((size.x + blockSize - 1) / blockSize,
+                               (size.y + blockSize - 1) / blockSize,
+                               (size.z + blockSize - 1) / blockSize);
+    if (numberOfBlocks.x * numberOfBlocks.y * numberOfBlocks.z == 0) {
+        return;
+    }
+
+    const ssize_t nbx = static_cast<ssize_t>(numberOfBlocks.x);
+    const ssize_t nby = static_cast<ssize_t>(numberOfBlocks.y);
+    const ssize_t nbz = static_cast<ssize_t>(numberOfBlocks.z);
+    const ssize_t numberOfPlanes = nbx + nby + nbz - 2;
+
+    for (int sweep = 0; sweep < 8; ++sweep) {
+        const bool forwardX = (sweep & 1) == 0;
+        const bool forwardY = (sweep & 2) == 0;
+        const bool forwardZ = (sweep & 4) == 0;
+
+        auto sweepBlock = [&](ssize_t bi, ssize_t bj, ssize_t bk) {
+            const ssize_t i0 = bi * blockSize;
+            const ssize_t j0 = bj * blockSize;
+            const ssize_t k0 = bk * blockSize;
+            const ssize_t ni = std::min<ssize_t>(blockSize, size.x - i0);
+            const ssize_t nj = std::min<ssize_t>(blockSize, size.y - j0);
+            const ssize_t nk = std::min<ssize_t>(blockSize, size.z - k0);
+            for (ssize_t kk = 0; kk < nk; ++kk) {
+                const size_t k = k0 + (forwardZ ? kk : nk - 1 - kk);
+                for (ssize_t jj = 0; jj < nj; ++jj) {
+                    const size_t j = j0 + (forwardY ? jj : nj - 1 - jj);
+                    for (ssize_t ii = 0; ii < ni; ++ii) {
+                        const size_t i = i0 + (forwardX ? ii : ni - 1 - ii);
+                        func(i, j, k);
+                    }
+                }
+            }
+        };
+
+        for (ssize_t plane = 0; plane < numberOfPlanes; ++plane) {
+            const ssize_t bjBegin = std::max<ssize_t>(0, plane - nbx - nbz + 2);
+            const ssize_t bjEnd = std::min<ssize_t>(nby, plane + 1);
+            parallelFor(bjBegin, bjEnd, [&](ssize_t bj) {
+                const ssize_t bkBegin =
+                    std::max<ssize_t>(0, plane - bj - nbx + 1);
+                const ssize_t bkEnd = std::min<ssize_t>(nbz, plane - bj + 1);
+                for (ssize_t bk = bkBegin; bk < bkEnd; ++bk) {
+                    const ssize_t bi = plane - bj - bk;
+                    sweepBlock(forwardX ? bi : nbx - 1 - bi,
+                               forwardY ? bj : nby - 1 - bj,
+                               forwardZ ? bk : nbz - 1 - bk);
+                }
+            });
+        }
+    }
+}
+
+// Samples sdf at the data points of a grid.
+inline void sampleFastSweepingSdf3(const ScalarField3& sdf,
+                                   const Grid3::DataPositionFunc& pos,
+                                   Array3<double>* output) {
+    output->parallelForEachIndex([&](size_t i, size_t j, size_t k) {
+        (*output)(i, j, k) = sdf.sample(pos(i, j, k));
+    });
+}
+
+}  // namespace internal
+
+inline FastSweepingLevelSetSolver3::FastSweepingLevelSetSolver3() {}
+
+inline void FastSweepingLevelSetSolver3::reinitialize(
+    const ScalarGrid3& inputSdf, double maxDistance, ScalarGrid3* outputSdf) {
+    JET_THROW_INVALID_ARG_IF(!inputSdf.hasSameShape(*outputSdf));
+
+    const Size3 size = inputSdf.dataSize();
+    const Vector3D h = inputSdf.gridSpacing();
+    const auto input = inputSdf.constDataAccessor();
+    auto output = outputSdf->dataAccessor();
+
+    // Unsigned distance. Points next to a sign change get the distance to
+    // the linearly interpolated crossings and stay fixed.
+    Array3<double> dist(size, kMaxD);
+    Array3<char> fixed(size, 0);
+    parallelFor(kZeroSize, size.x, kZeroSize, size.y, kZeroSize, size.z,
+                [&](size_t i, size_t j, size_t k) {
+        const double phi = input(i, j, k);
+        const bool inside = isInsideSdf(phi);
+        double sumInvD2 = 0.0;
+        auto crossing = [&](bool valid, double neighbor, double spacing,
+                            double* d) {
+            if (valid && isInsideSdf(neighbor) != inside) {
+                *d = std::min(
+                    *d, std::max(phi / (phi - neighbor) * spacing, kEpsilonD));
+            }
+        };
+        for (int axis = 0; axis < 3; ++axis) {
+            const size_t n = size[axis];
+            const size_t c = (axis == 0) ? i : (axis == 1) ? j : k;
+            const size_t di = (axis == 0) ? 1 : 0;
+            const size_t dj = (axis == 1) ? 1 : 0;
+            const size_t dk = (axis == 2) ? 1 : 0;
+            double d = kMaxD;
+            crossing(c > 0,
+                     (c > 0) ? input(i - di, j - dj, k - dk) : phi, h[axis],
+                     &d);
+            crossing(c + 1 < n,
+                     (c + 1 < n) ? input(i + di, j + dj, k + dk) : phi,
+                     h[axis], &d);
+            if (d < kMaxD) {
+                sumInvD2 += 1.0 / square(d);
+            }
+        }
+        if (sumInvD2 > 0.0) {
+            dist(i, j, k) = 1.0 / std::sqrt(sumInvD2);
+            fixed(i, j, k) = 1;
+        }
+    });
+
+    // A point without a fixed neighbor of the other sign only sees points of
+    // its own sign, so the unsigned distance can be swept for both sides at
+    // once.
+    internal::fastSweep3(
+        size, internal::kFastSweepingBlockSize3,
+        [&](size_t i, size_t j, size_t k) {
+            if (fixed(i, j, k)) {
+                return;
+            }
+            const double ux =
+                std::min((i > 0) ? dist(i - 1, j, k) : kMaxD,
+                         (i + 1 < size.x) ? dist(i + 1, j, k) : kMaxD);
+            const double uy =
+                std::min((j > 0) ? dist(i, j - 1, k) : kMaxD,
+                         (j + 1 < size.y) ? dist(i, j + 1, k) : kMaxD);
+            const double uz =
+                std::min((k > 0) ? dist(i, j, k - 1) : kMaxD,
+                         (k + 1 < size.z) ? dist(i, j, k + 1) : kMaxD);
+            dist(i, j, k) = std::min(
+                dist(i, j, k), internal::fastSweepingDistance3(ux, uy, uz, h));
+        });
+
+    parallelFor(kZeroSize, size.x, kZeroSize, size.y, kZeroSize, size.z,
+                [&](size_t i, size_t j, size_t k) {
+        const double d = std::min(dist(i, j, k), maxDistance);
+        output(i, j, k) = isInsideSdf(input(i, j, k)) ? -d : d;
+    });
+}
+
+inline void FastSweepingLevelSetSolver3::extrapolate(const ScalarGrid3& input,
+                                                     const ScalarField3& sdf,
+                                                     double maxDistance,
+                                                     ScalarGrid3* output) {
+    JET_THROW_INVALID_ARG_IF(!input.hasSameShape(*output));
+
+    Array3<double> sdfGrid(input.dataSize());
+    internal::sampleFastSweepingSdf3(sdf, input.dataPosition(), &sdfGrid);
+
+    extrapolate(input.constDataAccessor(), sdfGrid.constAccessor(),
+                input.gridSpacing(), maxDistance, output->dataAccessor());
+}
+
+inline void FastSweepingLevelSetSolver3::extrapolate(
+    const CollocatedVectorGrid3& input, const ScalarField3& sdf,
+    double maxDistance, CollocatedVectorGrid3* output) {
+    JET_THROW_INVALID_ARG_IF(!input.hasSameShape(*output));
+
+    Array3<double> sdfGrid(input.dataSize());
+    internal::sampleFastSweepingSdf3(sdf, input.dataPosition(), &sdfGrid);
+
+    extrapolate(input.constDataAccessor(), sdfGrid.constAccessor(),
+                input.gridSpacing(), maxDistance, output->dataAccessor());
+}
+
+inline void FastSweepingLevelSetSolver3::extrapolate(
+    const FaceCenteredGrid3& input, const ScalarField3& sdf,
+    double maxDistance, FaceCenteredGrid3* output) {
+    JET_THROW_INVALID_ARG_IF(!input.hasSameShape(*output));
+
+    const Vector3D& h = input.gridSpacing();
+    Array3<double> sdfGrid;
+
+    sdfGrid.resize(input.uSize());
+    internal::sampleFastSweepingSdf3(sdf, input.uPosition(), &sdfGrid);
+    extrapolate(input.uConstAccessor(), sdfGrid.constAccessor(), h,
+                maxDistance, output->uAccessor());
+
+    sdfGrid.resize(input.vSize());
+    internal::sampleFastSweepingSdf3(sdf, input.vPosition(), &sdfGrid);
+    extrapolate(input.vConstAccessor(), sdfGrid.constAccessor(), h,
+                maxDistance, output->vAccessor());
+
+    sdfGrid.resize(input.wSize());
+    internal::sampleFastSweepingSdf3(sdf, input.wPosition(), &sdfGrid);
+    extrapolate(input.wConstAccessor(), sdfGrid.constAccessor(), h,
+                maxDistance, output->wAccessor());
+}
+
+template <typename T>
+void FastSweepingLevelSetSolver3::extrapolate(
+    const ConstArrayAccessor3<T>& input,
+    const ConstArrayAccessor3<double>& sdf, const Vector3D& gridSpacing,
+    double maxDistance, ArrayAccessor3<T> output) {
+    const Size3 size = input.size();
+    const Vector3D invH2 = 1.0 / (gridSpacing * gridSpacing);
+
+    // The values are swept in a copy, so input and output may be the same.
+    Array3<T> values(size);
+    Array3<char> valid(size);
+    parallelFor(kZeroSize, size.x, kZeroSize, size.y, kZeroSize, size.z,
+                [&](size_t i, size_t j, size_t k) {
+        values(i, j, k) = input(i, j, k);
+        valid(i, j, k) = isInsideSdf(sdf(i, j, k)) ? 1 : 0;
+    });
+
+    // Solves grad(value) . grad(sdf) = 0 with the upwind neighbors, which
+    // are the ones with the smaller level set along each axis.
+    internal::fastSweep3(
+        size, internal::kFastSweepingBlockSize3,
+        [&](size_t i, size_t j, size_t k) {
+            const double phi = sdf(i, j, k);
+            if (valid(i, j, k) == 1 || phi >= maxDistance) {
+                return;
+            }
+
+            T sum = T();
+            double sumWeights = 0.0;
+            auto addUpwind = [&](bool hasPrev, size_t i0, size_t j0,
+                                 size_t k0, bool hasNext, size_t i1,
+                                 size_t j1, size_t k1, double weight) {
+                double phiUpwind = phi;
+                T value = T();
+                if (hasPrev && valid(i0, j0, k0) &&
+                    sdf(i0, j0, k0) < phiUpwind) {
+                    phiUpwind = sdf(i0, j0, k0);
+                    value = values(i0, j0, k0);
+                }
+                if (hasNext && valid(i1, j1, k1) &&
+                    sdf(i1, j1, k1) < phiUpwind) {
+                    phiUpwind = sdf(i1, j1, k1);
+                    value = values(i1, j1, k1);
+                }
+                if (phiUpwind < phi) {
+                    const double w = (phi - phiUpwind) * weight;
+                    sum += w * value;
+                    sumWeights += w;
+                }
+            };
+            addUpwind(i > 0, i - 1, j, k, i + 1 < size.x, i + 1, j, k,
+                      invH2.x);
+            addUpwind(j > 0, i, j - 1, k, j + 1 < size.y, i, j + 1, k,
+                      invH2.y);
+            addUpwind(k > 0, i, j, k - 1, k + 1 < size.z, i, j, k + 1,
+                      invH2.z);
+
+            if (sumWeights > 0.0) {
+                values(i, j, k) = sum / sumWeights;
+                valid(i, j, k) = 2;
+            }
+        });
+
+    parallelFor(kZeroSize, size.x, kZeroSize, size.y, kZeroSize, size.z,
+                [&](size_t i, size_t j, size_t k) {
+        output(i, j, k) = values(i, j, k);
+    });
+}
+
+}  // namespace jet
+
+#endif  // INCLUDE_JET_DETAIL_FAST_SWEEPING_LEVEL_SET_SOLVER3_INL_H_
@@ -0,0 +1,336 @@
+// Copyright (c) 2018 Doyub Kim
+//
+// I am making my contributions/submissions to this project solely in my
+// personal capacity and am not conveying any rights to any intellectual
+// property of any third parties.
+
+#ifndef INCLUDE_JET_DETAIL_FDM_AUTO_TUNING_SOLVER3_INL_H_
+#define INCLUDE_JET_DETAIL_FDM_AUTO_TUNING_SOLVER3_INL_H_
+
+#include <jet/fdm_auto_tuning_solver3.h>
+#include <jet/fdm_cg_solver3.h>
+#include <jet/fdm_iccg_solver3.h>
+#include <jet/fdm_mgpcg_solver3.h>
+#include <jet/logging.h>
+#include <jet/parallel.h>
+#include <jet/timer.h>
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+
+namespace jet {
+
+inline FdmAutoTuningSolver3::FdmAutoTuningSolver3(
+    unsigned int maxNumberOfIterations, double tolerance,
+    size_t maxNumberOfLevels)
+    : FdmMgSolver3(maxNumberOfLevels, 5, 5, 20, 20, tolerance),
+      _maxNumberOfLevels(std::max(maxNumberOfLevels, kOneSize)) {
+    addCandidate(
+        std::make_shared<FdmCgSolver3>(maxNumberOfIterations, tolerance));
+    addCandidate(
+        std::make_shared<FdmIccgSolver3>(maxNumberOfIterations, tolerance));
+
+    // The blocked smoother gives the same result as the default SOR
+    // relaxation of the multigrid candidates with less memory traffic.
+    FdmBlockedSmoother3 smoother(FdmBlockedSmoother3::Method::kGaussSeidel,
+                                 sorFactor());
+
+    auto mg = std::make_shared<FdmMgSolver3>(maxNumberOfLevels, 5, 5, 20, 20,
+                                             tolerance);
+    mg->setRelaxFunc(smoother);
+    addCandidate(mg);
+
+    auto mgpcg = std::make_shared<FdmMgpcgSolver3>(
+        maxNumberOfIterations, maxNumberOfLevels, 5, 5, 20, 20, tolerance);
+    mgpcg->setRelaxFunc(smoother);
+    addCandidate(mgpcg);
+}
+
+inline bool FdmAutoTuningSolver3::solve(FdmMgLinearSystem3* system) {
+    if (_candidates.empty()) {
+        return false;
+    }
+
+    const FdmMatrix3& A = system->A.finest();
+    const Size3 resolution = A.size();
+    const double fraction = fluidFraction(A);
+
+    // Restart tuning if the system has changed significantly since the
+    // measurements were taken.
+    if (_selected != kMaxSize || _numberOfMeasurements > 0) {
+        if (resolution != _tunedResolution ||
+            std::fabs(fraction - _tunedFluidFraction) >
+                _fluidFractionTolerance * _tunedFluidFraction) {
+            // A system built for a non-multigrid candidate has no coarse
+            // levels, so it is solved by that candidate once more and the
+            // measurements start with the next system.
+            FdmLinearSystemSolver3Ptr previous = selectedSolver();
+            const bool hasHierarchy =
+                params().maxNumberOfLevels == _maxNumberOfLevels;
+            retune();
+            if (previous != nullptr && !hasHierarchy) {
+                return solveWith(previous, system);
+            }
+        }
+    }
+
+    if (_selected != kMaxSize) {
+        return solveWith(_candidates[_selected].solver, system);
+    }
+
+    if (_numberOfMeasurements == 0) {
+        _tunedResolution = resolution;
+        _tunedFluidFraction = fraction;
+    }
+
+    _residual.resize(resolution);
+    FdmBlas3::residual(A, system->x.finest(), system->b.finest(), &_residual);
+    const double initialResidual = FdmBlas3::l2Norm(_residual);
+
+    Candidate& candidate = _candidates[_nextCandidate];
+
+    Timer timer;
+    bool converged = solveWith(candidate.solver, system);
+    const double seconds = timer.durationInSeconds();
+
+    FdmBlas3::residual(A, system->x.finest(), system->b.finest(), &_residual);
+    const double finalResidual = FdmBlas3::l2Norm(_residual);
+
+    // Nothing to measure on a trivial system; try again next time.
+    if (initialResidual <= 0.0) {
+        return converged;
+    }
+
+    const double decades =
+        (finalResidual > 0.0)
+            ? std::log10(initialResidual / finalResidual)
+            : static_cast<double>(std::numeric_limits<double>::digits10);
+
+    ++candidate.numberOfSolves;
+    candidate.seconds += seconds;
+    candidate.decades += std::max(decades, 0.0);
+    candidate.iterations += candidate.solver->lastNumberOfIterations();
+    candidate.converged = candidate.converged && converged;
+
+    // Visit the candidates in turn so that each one is measured on a spread
+    // of frames rather than on consecutive ones.
+    _nextCandidate = (_nextCandidate + 1) % _candidates.size();
+    ++_numberOfMeasurements;
+
+    if (_numberOfMeasurements == _candidates.size() * _numberOfTuningSolves) {
+        selectCandidate();
+    }
+
+    return converged;
+}
+
+inline bool FdmAutoTuningSolver3::solveCompressed(
+    FdmCompressedLinearSystem3* system) {
+    (void)system;
+    JET_THROW_INVALID_ARG_WITH_MESSAGE_IF(
+        true, "FdmAutoTuningSolver3 only solves multigrid systems.");
+    return false;
+}
+
+inline unsigned int FdmAutoTuningSolver3::lastNumberOfIterations() const {
+    return (_lastSolver != nullptr) ? _lastSolver->lastNumberOfIterations()
+                                    : 0;
+}
+
+inline double FdmAutoTuningSolver3::lastResidual() const {
+    return (_lastSolver != nullptr) ? _lastSolver->lastResidual() : 0.0;
+}
+
+inline void FdmAutoTuningSolver3::setTimeBudget(double seconds) {
+    FdmMgSolver3::setTimeBudget(seconds);
+    for (Candidate& c : _candidates) {
+        c.solver->setTimeBudget(_timeBudget);
+    }
+}
+
+inline bool FdmAutoTuningSolver3::lastSolveHitTimeBudget() const {
+    return (_lastSolver != nullptr) && _lastSolver->lastSolveHitTimeBudget();
+}
+
+inline void FdmAutoTuningSolver3::addCandidate(
+    const FdmLinearSystemSolver3Ptr& solver) {
+    JET_THROW_INVALID_ARG_IF(solver == nullptr);
+
+    solver->setTimeBudget(_timeBudget);
+
+    Candidate candidate;
+    candidate.solver = solver;
+    _candidates.push_back(candidate);
+    retune();
+}
+
+inline void FdmAutoTuningSolver3::clearCandidates() {
+    _candidates.clear();
+    _lastSolver = nullptr;
+    retune();
+}
+
+inline size_t FdmAutoTuningSolver3::numberOfCandidates() const {
+    return _candidates.size();
+}
+
+inline const FdmLinearSystemSolver3Ptr& FdmAutoTuningSolver3::candidate(
+    size_t i) const {
+    return _candidates[i].solver;
+}
+
+inline double FdmAutoTuningSolver3::candidateCost(size_t i) const {
+    const Candidate& c = _candidates[i];
+    return (c.numberOfSolves >= _numberOfTuningSolves) ? cost(c) : -1.0;
+}
+
+inline double FdmAutoTuningSolver3::candidateIterations(size_t i) const {
+    const Candidate& c = _candidates[i];
+    return (c.numberOfSolves >= _numberOfTuningSolves)
+               ? c.iterations / c.numberOfSolves
+               : -1.0;
+}
+
+inline unsigned int FdmAutoTuningSolver3::numberOfTuningSolves() const {
+    return _numberOfTuningSolves;
+}
+
+inline void FdmAutoTuningSolver3::setNumberOfTuningSolves(
+    unsigned int numberOfSolves) {
+    _numberOfTuningSolves = std::max(numberOfSolves, 1u);
+    retune();
+}
+
+inline bool FdmAutoTuningSolver3::isTuning() const {
+    return _selected == kMaxSize;
+}
+
+inline FdmLinearSystemSolver3Ptr FdmAutoTuningSolver3::selectedSolver()
+    const {
+    return (_selected != kMaxSize) ? _candidates[_selected].solver : nullptr;
+}
+
+inline void FdmAutoTuningSolver3::retune() {
+    for (Candidate& candidate : _candidates) {
+        candidate.numberOfSolves = 0;
+        candidate.seconds = 0.0;
+        candidate.decades = 0.0;
+        candidate.iterations = 0.0;
+        candidate.converged = true;
+    }
+    _selected = kMaxSize;
+    _nextCandidate = 0;
+    _numberOfMeasurements = 0;
+    setMaxNumberOfLevels(_maxNumberOfLevels);
+}
+
+inline double FdmAutoTuningSolver3::fluidFractionTolerance() const {
+    return _fluidFractionTolerance;
+}
+
+inline void FdmAutoTuningSolver3::setFluidFractionTolerance(double tolerance) {
+    _fluidFractionTolerance = std::max(tolerance, 0.0);
+}
+
+inline bool FdmAutoTuningSolver3::solveWith(
+    const FdmLinearSystemSolver3Ptr& solver, FdmMgLinearSystem3* system) {
+    _lastSolver = solver;
+
+    auto mgSolver = std::dynamic_pointer_cast<FdmMgSolver3>(solver);
+    if (mgSolver != nullptr) {
+        return mgSolver->solve(system);
+    }
+
+    // Solve the finest level for the correction e of A (x + e) = b. The
+    // matrix is borrowed without copying, and starting e from zero gives
+    // every candidate the current x as the initial guess even if it clears
+    // the solution vector.
+    FdmVector3& x = system->x.finest();
+    _finestSystem.A.swap(system->A.finest());
+    _finestSystem.b.resize(x.size());
+    _finestSystem.x.resize(x.size());
+    FdmBlas3::residual(_finestSystem.A, x, system->b.finest(),
+                       &_finestSystem.b);
+    _finestSystem.x.set(0.0);
+
+    bool converged = solver->solve(&_finestSystem);
+
+    _finestSystem.A.swap(system->A.finest());
+    FdmBlas3::axpy(1.0, _finestSystem.x, x, &x);
+
+    return converged;
+}
+
+inline void FdmAutoTuningSolver3::selectCandidate() {
+    // Prefer the cheapest candidate that reached the tolerance, and fall
+    // back to the cheapest one overall.
+    bool anyConverged = false;
+    for (const Candidate& c : _candidates) {
+        anyConverged |= c.converged;
+    }
+
+    for (size_t i = 0; i < _candidates.size(); ++i) {
+        const Candidate& c = _candidates[i];
+        if (anyConverged && !c.converged) {
+            continue;
+        }
+        if (_selected == kMaxSize || cost(c) < cost(_candidates[_selected])) {
+            _selected = i;
+        }
+    }
+
+    // Only multigrid candidates need the coarse levels.
+    const FdmLinearSystemSolver3Ptr& solver = _candidates[_selected].solver;
+    if (std::dynamic_pointer_cast<FdmMgSolver3>(solver) == nullptr) {
+        setMaxNumberOfLevels(1);
+    }
+
+    JET_INFO << "Auto-tuning solver selected candidate " << _selected
+             << " with " << cost(_candidates[_selected])
+             << " seconds per decade of residual reduction and "
+             << candidateIterations(_selected) << " iterations on average";
+}
+
+inline double FdmAutoTuningSolver3::cost(const Candidate& candidate) {
+    return (candidate.decades > 0.0) ? candidate.seconds / candidate.decades
+                                     : kMaxD;
+}
+
+inline double FdmAutoTuningSolver3::fluidFraction(const FdmMatrix3& A) {
+    const Size3 size = A.size();
+    const size_t total = size.x * size.y * size.z;
+    if (total == 0) {
+        return 0.0;
+    }
+
+    // Rows without any coupling are the identity rows of non-fluid cells.
+    size_t numberOfFluidCells = parallelReduce(
+        kZeroSize, size.z, kZeroSize,
+        [&](size_t kBegin, size_t kEnd, size_t init) {
+            size_t count = init;
+            for (size_t k = kBegin; k < kEnd; ++k) {
+                for (size_t j = 0; j < size.y; ++j) {
+                    for (size_t i = 0; i < size.x; ++i) {
+                        const FdmMatrixRow3& row = A(i, j, k);
+                        if (row.right != 0.0 || row.up != 0.0 ||
+                            row.front != 0.0 ||
+                            (i > 0 && A(i - 1, j, k).right != 0.0) ||
+                            (j > 0 && A(i, j - 1, k).up != 0.0) ||
+                            (k > 0 && A(i, j, k - 1).front != 0.0)) {
+                            ++count;
+                        }
+                    }
+                }
+            }
+            return count;
+        },
+        std::plus<size_t>());
+
+    return static_cast<double>(numberOfFluidCells) / total;
+}
+
+}  // namespace jet
+
+#endif  // INCLUDE_JET_DETAIL_FDM_AUTO_TUNING_SOLVER3_INL_H_
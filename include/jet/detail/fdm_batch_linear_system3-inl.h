@@ -0,0 +1,281 @@
+// Copyright (c) 2018 Doyub Kim
+//
+// I am making my contributions/submissions to this project solely in my
+// personal capacity and am not conveying any rights to any intellectual
+// property of any third parties.
+
+#ifndef INCLUDE_JET_DETAIL_FDM_BATCH_LINEAR_SYSTEM3_INL_H_
+#define INCLUDE_JET_DETAIL_FDM_BATCH_LINEAR_SYSTEM3_INL_H_
+
+#include <jet/fdm_batch_linear_system3.h>
+#include <jet/parallel.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+namespace jet {
+
+namespace internal {
+
+// Batched vectors are stored as K consecutive doubles per grid point.
+template <size_t K>
+const double* batchData(const FdmBatchVector3<K>& v) {
+    static_assert(sizeof(Vector<double, K>) == K * sizeof(double),
+                  "Batched scalars must be tightly packed.");
+    return reinterpret_cast<const double*>(v.data());
+}
+
+template <size_t K>
+double* batchData(FdmBatchVector3<K>& v) {
+    static_assert(sizeof(Vector<double, K>) == K * sizeof(double),
+                  "Batched scalars must be tightly packed.");
+    return reinterpret_cast<double*>(v.data());
+}
+
+template <size_t K>
+size_t numberOfBatchElements(const FdmBatchVector3<K>& v) {
+    return v.width() * v.height() * v.depth();
+}
+
+}  // namespace internal
+
+template <size_t K>
+void FdmBatchLinearSystem3<K>::clear() {
+    A.clear();
+    x.clear();
+    b.clear();
+}
+
+template <size_t K>
+void FdmBatchLinearSystem3<K>::resize(const Size3& size) {
+    A.resize(size);
+    x.resize(size);
+    b.resize(size);
+}
+
+template <size_t K>
+void FdmBatchBlas3<K>::set(double s, VectorType* result) {
+    ScalarType value;
+    for (size_t c = 0; c < K; ++c) {
+        value[c] = s;
+    }
+    result->set(value);
+}
+
+template <size_t K>
+void FdmBatchBlas3<K>::set(const VectorType& v, VectorType* result) {
+    result->set(v);
+}
+
+template <size_t K>
+typename FdmBatchBlas3<K>::ScalarType FdmBatchBlas3<K>::dot(
+    const VectorType& a, const VectorType& b) {
+    JET_THROW_INVALID_ARG_IF(a.size() != b.size());
+
+    const double* pa = internal::batchData(a);
+    const double* pb = internal::batchData(b);
+    const size_t n = internal::numberOfBatchElements(a);
+
+    std::array<double, K> sum = parallelReduce(
+        kZeroSize, n, std::array<double, K>(),
+        [&](size_t begin, size_t end, std::array<double, K> init) {
+            std::array<double, K> result = init;
+            for (size_t i = begin; i < end; ++i) {
+                for (size_t c = 0; c < K; ++c) {
+                    result[c] += pa[i * K + c] * pb[i * K + c];
+                }
+            }
+            return result;
+        },
+        [](const std::array<double, K>& x, const std::array<double, K>& y) {
+            std::array<double, K> result;
+            for (size_t c = 0; c < K; ++c) {
+                result[c] = x[c] + y[c];
+            }
+            return result;
+        });
+
+    ScalarType result;
+    for (size_t c = 0; c < K; ++c) {
+        result[c] = sum[c];
+    }
+    return result;
+}
+
+template <size_t K>
+void FdmBatchBlas3<K>::axpy(const ScalarType& a, const VectorType& x,
+                            const VectorType& y, VectorType* result) {
+    JET_THROW_INVALID_ARG_IF(x.size() != y.size());
+    JET_THROW_INVALID_ARG_IF(x.size() != result->size());
+
+    std::array<double, K> coeffs;
+    for (size_t c = 0; c < K; ++c) {
+        coeffs[c] = a[c];
+    }
+
+    const double* px = internal::batchData(x);
+    const double* py = internal::batchData(y);
+    double* pr = internal::batchData(*result);
+    const size_t n = internal::numberOfBatchElements(x);
+
+    parallelRangeFor(kZeroSize, n, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            for (size_t c = 0; c < K; ++c) {
+                pr[i * K + c] = coeffs[c] * px[i * K + c] + py[i * K + c];
+            }
+        }
+    });
+}
+
+template <size_t K>
+void FdmBatchBlas3<K>::mvm(const MatrixType& m, const VectorType& v,
+                           VectorType* result) {
+    const Size3 size = m.size();
+
+    JET_THROW_INVALID_ARG_IF(size != v.size());
+    JET_THROW_INVALID_ARG_IF(size != result->size());
+
+    const size_t strideY = size.x;
+    const size_t strideZ = size.x * size.y;
+    const FdmMatrixRow3* rows = m.data();
+    const ScalarType* vs = v.data();
+    ScalarType* out = result->data();
+
+    parallelRangeFor(
+        kZeroSize, size.z, [&](size_t kBegin, size_t kEnd) {
+            for (size_t k = kBegin; k < kEnd; ++k) {
+                for (size_t j = 0; j < size.y; ++j) {
+                    const size_t base = j * strideY + k * strideZ;
+
+                    for (size_t i = 0; i < size.x; ++i) {
+                        const size_t idx = base + i;
+                        const FdmMatrixRow3& row = rows[idx];
+
+                        // Missing neighbors get a zero coefficient and point
+                        // at the center, so every coefficient is read once
+                        // and applied to all right-hand sides without
+                        // branching.
+                        const double cl = (i > 0) ? rows[idx - 1].right : 0.0;
+                        const double cr = (i + 1 < size.x) ? row.right : 0.0;
+                        const double cd =
+                            (j > 0) ? rows[idx - strideY].up : 0.0;
+                        const double cu = (j + 1 < size.y) ? row.up : 0.0;
+                        const double cb =
+                            (k > 0) ? rows[idx - strideZ].front : 0.0;
+                        const double cf = (k + 1 < size.z) ? row.front : 0.0;
+
+                        const ScalarType& vc = vs[idx];
+                        const ScalarType& vl = vs[(i > 0) ? idx - 1 : idx];
+                        const ScalarType& vr =
+                            vs[(i + 1 < size.x) ? idx + 1 : idx];
+                        const ScalarType& vd =
+                            vs[(j > 0) ? idx - strideY : idx];
+                        const ScalarType& vu =
+                            vs[(j + 1 < size.y) ? idx + strideY : idx];
+                        const ScalarType& vb =
+                            vs[(k > 0) ? idx - strideZ : idx];
+                        const ScalarType& vf =
+                            vs[(k + 1 < size.z) ? idx + strideZ : idx];
+
+                        ScalarType& o = out[idx];
+                        for (size_t c = 0; c < K; ++c) {
+                            o[c] = row.center * vc[c] + cl * vl[c] +
+                                   cr * vr[c] + cd * vd[c] + cu * vu[c] +
+                                   cb * vb[c] + cf * vf[c];
+                        }
+                    }
+                }
+            }
+        });
+}
+
+template <size_t K>
+void FdmBatchBlas3<K>::residual(const MatrixType& a, const VectorType& x,
+                                const VectorType& b, VectorType* result) {
+    JET_THROW_INVALID_ARG_IF(a.size() != b.size());
+
+    mvm(a, x, result);
+
+    result->parallelForEachIndex([&](size_t i, size_t j, size_t k) {
+        const ScalarType& bi = b(i, j, k);
+        ScalarType& ri = (*result)(i, j, k);
+        for (size_t c = 0; c < K; ++c) {
+            ri[c] = bi[c] - ri[c];
+        }
+    });
+}
+
+template <size_t K>
+typename FdmBatchBlas3<K>::ScalarType FdmBatchBlas3<K>::l2Norm(
+    const VectorType& v) {
+    ScalarType result = dot(v, v);
+    for (size_t c = 0; c < K; ++c) {
+        result[c] = std::sqrt(result[c]);
+    }
+    return result;
+}
+
+template <size_t K>
+typename FdmBatchBlas3<K>::ScalarType FdmBatchBlas3<K>::lInfNorm(
+    const VectorType& v) {
+    const Size3 size = v.size();
+
+    auto absMax = [](const ScalarType& x, const ScalarType& y) {
+        ScalarType result;
+        for (size_t c = 0; c < K; ++c) {
+            result[c] = std::max(x[c], y[c]);
+        }
+        return result;
+    };
+
+    return parallelReduce(
+        kZeroSize, size.z, ScalarType(),
+        [&](size_t kBegin, size_t kEnd, ScalarType init) {
+            ScalarType result = init;
+            for (size_t k = kBegin; k < kEnd; ++k) {
+                for (size_t j = 0; j < size.y; ++j) {
+                    for (size_t i = 0; i < size.x; ++i) {
+                        const ScalarType& vi = v(i, j, k);
+                        for (size_t c = 0; c < K; ++c) {
+                            result[c] = std::max(result[c], std::fabs(vi[c]));
+                        }
+                    }
+                }
+            }
+            return result;
+        },
+        absMax);
+}
+
+template <size_t K>
+void FdmBatchBlas3<K>::setComponent(const FdmVector3& v, size_t k,
+                                    VectorType* result) {
+    JET_THROW_INVALID_ARG_IF(k >= K);
+
+    if (result->size() != v.size()) {
+        result->resize(v.size());
+    }
+
+    v.parallelForEachIndex([&](size_t i, size_t j, size_t l) {
+        (*result)(i, j, l)[k] = v(i, j, l);
+    });
+}
+
+template <size_t K>
+void FdmBatchBlas3<K>::getComponent(const VectorType& v, size_t k,
+                                    FdmVector3* result) {
+    JET_THROW_INVALID_ARG_IF(k >= K);
+
+    if (result->size() != v.size()) {
+        result->resize(v.size());
+    }
+
+    v.parallelForEachIndex([&](size_t i, size_t j, size_t l) {
+        (*result)(i, j, l) = v(i, j, l)[k];
+    });
+}
+
+}  // namespace jet
+
+#endif  // INCLUDE_JET_DETAIL_FDM_BATCH_LINEAR_SYSTEM3_INL_H_
@@ -0,0 +1,49 @@
+// Copyright (c) 2018 Doyub Kim
+//
+// I am making my contributions/submissions to this project solely in my
+// personal capacity and am not conveying any rights to any intellectual
+// property of any third parties.
+
+#ifndef INCLUDE_JET_DETAIL_FDM_BLOCKED_SMOOTHER3_INL_H_
+#define INCLUDE_JET_DETAIL_FDM_BLOCKED_SMOOTHER3_INL_H_
+
+#include <jet/fdm_blocked_smoother3.h>
+
+namespace jet {
+
+inline FdmBlockedSmoother3::FdmBlockedSmoother3(Method method,
+                                                double sorFactor)
+    : _method(method), _sorFactor(sorFactor) {}
+
+inline FdmBlockedSmoother3::Method FdmBlockedSmoother3::method() const {
+    return _method;
+}
+
+inline double FdmBlockedSmoother3::sorFactor() const { return _sorFactor; }
+
+inline MgRelaxFunc<FdmBlas3> FdmBlockedSmoother3::relaxFunc() const {
+    const Method method = _method;
+    const double sorFactor = _sorFactor;
+    return [method, sorFactor](const FdmMatrix3& A, const FdmVector3& b,
+                               unsigned int numberOfIterations, double,
+                               FdmVector3* x, FdmVector3* buffer) {
+        switch (method) {
+            case Method::kJacobi:
+                FdmJacobiSolver3::relaxBlocked(A, b, numberOfIterations, x,
+                                               buffer);
+                break;
+            case Method::kGaussSeidel:
+                FdmGaussSeidelSolver3::relaxBlocked(A, b, sorFactor,
+                                                    numberOfIterations, x);
+                break;
+            case Method::kRedBlackGaussSeidel:
+                FdmGaussSeidelSolver3::relaxRedBlackBlocked(
+                    A, b, sorFactor, numberOfIterations, x);
+                break;
+        }
+    };
+}
+
+}  // namespace jet
+
+#endif  // INCLUDE_JET_DETAIL_FDM_BLOCKED_SMOOTHER3_INL_H_
@@ -0,0 +1,74 @@
+// Copyright (c) 2018 Doyub Kim
+//
+// I am making my contributions/submissions to this project solely in my
+// personal capacity and am not conveying any rights to any intellectual
+// property of any third parties.
+
+#ifndef INCLUDE_JET_DETAIL_FDM_CG_SOLVER3_INL_H_
+#define INCLUDE_JET_DETAIL_FDM_CG_SOLVER3_INL_H_
+
+#include <jet/fdm_cg_solver3.h>
+
+namespace jet {
+
+inline bool FdmCgSolver3::solve(FdmLinearSystem3* system) {
+    FdmMatrix3& matrix = system->A;
+    FdmVector3& solution = system->x;
+    FdmVector3& rhs = system->b;
+    Timer timer;
+
+    JET_ASSERT(matrix.size() == rhs.size());
+    JET_ASSERT(matrix.size() == solution.size());
+
+    clearCompressedVectors();
+
+    NullCgPreconditioner<FdmBlas3> precond;
+    _lastSolveHitTimeBudget = _pcg.pcg(
+        _workspace.get(), matrix, rhs, _maxNumberOfIterations, _tolerance,
+        &precond, &solution, &_lastNumberOfIterations, &_lastResidual,
+        remainingTimeBudget(timer));
+
+    return !_lastSolveHitTimeBudget &&
+           (_lastResidual <= _tolerance ||
+            _lastNumberOfIterations < _maxNumberOfIterations);
+}
+
+inline bool FdmCgSolver3::solveCompressed(FdmCompressedLinearSystem3* system) {
+    MatrixCsrD& matrix = system->A;
+    VectorND& solution = system->x;
+    VectorND& rhs = system->b;
+    Timer timer;
+
+    clearUncompressedVectors();
+
+    NullCgPreconditioner<FdmCompressedBlas3> precond;
+    _lastSolveHitTimeBudget = _pcgComp.pcg(
+        _workspace.get(), matrix, rhs, _maxNumberOfIterations, _tolerance,
+        &precond, &solution, &_lastNumberOfIterations, &_lastResidual,
+        remainingTimeBudget(timer));
+
+    return !_lastSolveHitTimeBudget &&
+           (_lastResidual <= _tolerance ||
+            _lastNumberOfIterations < _maxNumberOfIterations);
+}
+
+inline const FdmSolverWorkspace3Ptr& FdmCgSolver3::workspace() const {
+    return _workspace;
+}
+
+inline void FdmCgSolver3::setWorkspace(
+    const FdmSolverWorkspace3Ptr& workspace) {
+    _workspace = workspace;
+    if (_workspace != nullptr) {
+        clearUncompressedVectors();
+        clearCompressedVectors();
+    }
+}
+
+inline void FdmCgSolver3::clearUncompressedVectors() { _pcg.clear(); }
+
+inline void FdmCgSolver3::clearCompressedVectors() { _pcgComp.clear(); }
+
+}  // namespace jet
+
+#endif  // INCLUDE_JET_DETAIL_FDM_CG_SOLVER3_INL_H_
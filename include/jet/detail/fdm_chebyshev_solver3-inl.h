@@ -0,0 +1,123 @@
+// Copyright (c) 2018 Doyub Kim
+//
+// I am making my contributions/submissions to this project solely in my
+// personal capacity and am not conveying any rights to any intellectual
+// property of any third parties.
+
+#ifndef INCLUDE_JET_DETAIL_FDM_CHEBYSHEV_SOLVER3_INL_H_
+#define INCLUDE_JET_DETAIL_FDM_CHEBYSHEV_SOLVER3_INL_H_
+
+#include <jet/cg.h>
+#include <jet/fdm_chebyshev_solver3.h>
+#include <jet/logging.h>
+
+namespace jet {
+
+inline FdmChebyshevSolver3::FdmChebyshevSolver3(
+    unsigned int maxNumberOfIterations, double tolerance,
+    unsigned int polynomialDegree, const ChebyshevParameters& params)
+    : _maxNumberOfIterations(maxNumberOfIterations), _tolerance(tolerance) {
+    _precond.degree = polynomialDegree;
+    _precond.params = params;
+    _precondComp.degree = polynomialDegree;
+    _precondComp.params = params;
+}
+
+inline bool FdmChebyshevSolver3::solve(FdmLinearSystem3* system) {
+    FdmMatrix3& matrix = system->A;
+    FdmVector3& solution = system->x;
+    Timer timer;
+    FdmVector3& rhs = system->b;
+
+    JET_ASSERT(matrix.size() == rhs.size());
+    JET_ASSERT(matrix.size() == solution.size());
+
+    clearCompressedVectors();
+
+    _precond.build(matrix, rhs);
+
+    _lastSolveHitTimeBudget = _pcg.pcg(
+        _workspace.get(), matrix, rhs, _maxNumberOfIterations, _tolerance,
+        &_precond, &solution, &_lastNumberOfIterations, &_lastResidualNorm,
+        remainingTimeBudget(timer));
+
+    JET_INFO << "Residual after solving Chebyshev-preconditioned CG: "
+             << _lastResidualNorm
+             << " Number of iterations: " << _lastNumberOfIterations;
+
+    return !_lastSolveHitTimeBudget &&
+           (_lastResidualNorm <= _tolerance ||
+            _lastNumberOfIterations < _maxNumberOfIterations);
+}
+
+inline bool FdmChebyshevSolver3::solveCompressed(
+    FdmCompressedLinearSystem3* system) {
+    MatrixCsrD& matrix = system->A;
+    VectorND& solution = system->x;
+    Timer timer;
+    VectorND& rhs = system->b;
+
+    clearUncompressedVectors();
+
+    _precondComp.build(matrix, rhs);
+
+    _lastSolveHitTimeBudget = _pcgComp.pcg(
+        _workspace.get(), matrix, rhs, _maxNumberOfIterations, _tolerance,
+        &_precondComp, &solution, &_lastNumberOfIterations,
+        &_lastResidualNorm, remainingTimeBudget(timer));
+
+    JET_INFO << "Residual after solving Chebyshev-preconditioned CG: "
+             << _lastResidualNorm
+             << " Number of iterations: " << _lastNumberOfIterations;
+
+    return !_lastSolveHitTimeBudget &&
+           (_lastResidualNorm <= _tolerance ||
+            _lastNumberOfIterations < _maxNumberOfIterations);
+}
+
+inline unsigned int FdmChebyshevSolver3::maxNumberOfIterations() const {
+    return _maxNumberOfIterations;
+}
+
+inline unsigned int FdmChebyshevSolver3::lastNumberOfIterations() const {
+    return _lastNumberOfIterations;
+}
+
+inline double FdmChebyshevSolver3::tolerance() const { return _tolerance; }
+
+inline double FdmChebyshevSolver3::lastResidual() const {
+    return _lastResidualNorm;
+}
+
+inline unsigned int FdmChebyshevSolver3::polynomialDegree() const {
+    return _precond.degree;
+}
+
+inline const ChebyshevParameters& FdmChebyshevSolver3::params() const {
+    return _precond.params;
+}
+
+inline const FdmSolverWorkspace3Ptr& FdmChebyshevSolver3::workspace() const {
+    return _workspace;
+}
+
+inline void FdmChebyshevSolver3::setWorkspace(
+    const FdmSolverWorkspace3Ptr& workspace) {
+    _workspace = workspace;
+    if (_workspace != nullptr) {
+        clearUncompressedVectors();
+        clearCompressedVectors();
+    }
+}
+
+inline void FdmChebyshevSolver3::clearUncompressedVectors() {
+    _pcg.clear();
+}
+
+inline void FdmChebyshevSolver3::clearCompressedVectors() {
+    _pcgComp.clear();
+}
+
+}  // namespace jet
+
+#endif  // INCLUDE_JET_DETAIL_FDM_CHEBYSHEV_SOLVER3_INL_H_
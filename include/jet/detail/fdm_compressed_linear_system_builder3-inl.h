@@ -0,0 +1,222 @@
+// Copyright (c) 2018 Doyub Kim
+//
+// I am making my contributions/submissions to this project solely in my
+// personal capacity and am not conveying any rights to any intellectual
+// property of any third parties.
+
+#ifndef INCLUDE_JET_DETAIL_FDM_COMPRESSED_LINEAR_SYSTEM_BUILDER3_INL_H_
+#define INCLUDE_JET_DETAIL_FDM_COMPRESSED_LINEAR_SYSTEM_BUILDER3_INL_H_
+
+#include <jet/constants.h>
+#include <jet/fdm_compressed_linear_system_builder3.h>
+#include <jet/parallel.h>
+
+namespace jet {
+
+namespace internal {
+
+// Adapts an assembled FdmMatrix3 to the operator interface of
+// FdmCompressedLinearSystemBuilder3::buildMatrix.
+struct FdmMatrix3Operator {
+    const FdmMatrix3& matrix;
+
+    double center(size_t i, size_t j, size_t k) const {
+        return matrix(i, j, k).center;
+    }
+
+    double right(size_t i, size_t j, size_t k) const {
+        return matrix(i, j, k).right;
+    }
+
+    double up(size_t i, size_t j, size_t k) const {
+        return matrix(i, j, k).up;
+    }
+
+    double front(size_t i, size_t j, size_t k) const {
+        return matrix(i, j, k).front;
+    }
+};
+
+}  // namespace internal
+
+template <typename ActiveFunction>
+void FdmCompressedLinearSystemBuilder3::numberCells(
+    const Size3& size, const ActiveFunction& isActive) {
+    _coordToIndex.resize(size);
+
+    // Count the active cells per grid line (j, k), then offset each line by
+    // the prefix sum so that the numbering matches a serial i-fastest walk.
+    const size_t numberOfLines = size.y * size.z;
+    std::vector<size_t> lineCounts(numberOfLines);
+    parallelFor(kZeroSize, numberOfLines, [&](size_t line) {
+        const size_t j = line % size.y;
+        const size_t k = line / size.y;
+        size_t count = 0;
+        for (size_t i = 0; i < size.x; ++i) {
+            if (isActive(i, j, k)) {
+                _coordToIndex(i, j, k) = count++;
+            } else {
+                _coordToIndex(i, j, k) = kMaxSize;
+            }
+        }
+        lineCounts[line] = count;
+    });
+
+    std::vector<size_t> lineOffsets;
+    const size_t numberOfRows =
+        parallelExclusiveScan(lineCounts, &lineOffsets);
+
+    _indexToCoord.resize(numberOfRows);
+    parallelFor(kZeroSize, numberOfLines, [&](size_t line) {
+        const size_t j = line % size.y;
+        const size_t k = line / size.y;
+        const size_t offset = lineOffsets[line];
+        for (size_t i = 0; i < size.x; ++i) {
+            size_t& index = _coordToIndex(i, j, k);
+            if (index != kMaxSize) {
+                index += offset;
+                _indexToCoord[index] = Point3UI(i, j, k);
+            }
+        }
+    });
+}
+
+inline Size3 FdmCompressedLinearSystemBuilder3::size() const {
+    return _coordToIndex.size();
+}
+
+inline size_t FdmCompressedLinearSystemBuilder3::numberOfRows() const {
+    return _indexToCoord.size();
+}
+
+inline size_t FdmCompressedLinearSystemBuilder3::row(size_t i, size_t j,
+                                                     size_t k) const {
+    return _coordToIndex(i, j, k);
+}
+
+inline const Array3<size_t>& FdmCompressedLinearSystemBuilder3::coordToIndex()
+    const {
+    return _coordToIndex;
+}
+
+inline const std::vector<Point3UI>&
+FdmCompressedLinearSystemBuilder3::indexToCoord() const {
+    return _indexToCoord;
+}
+
+template <typename Operator>
+void FdmCompressedLinearSystemBuilder3::buildMatrix(const Operator& op,
+                                                    MatrixCsrD* matrix) const {
+    const Size3 n = size();
+    const size_t numberOfRows = _indexToCoord.size();
+    const auto& c2i = _coordToIndex;
+
+    // Count the diagonal plus the active face neighbors of each row.
+    std::vector<size_t> rowCounts(numberOfRows);
+    parallelFor(kZeroSize, numberOfRows, [&](size_t row) {
+        const Point3UI& p = _indexToCoord[row];
+        const size_t i = p.x;
+        const size_t j = p.y;
+        const size_t k = p.z;
+        size_t count = 1;
+        count += (k > 0 && c2i(i, j, k - 1) != kMaxSize) ? 1 : 0;
+        count += (j > 0 && c2i(i, j - 1, k) != kMaxSize) ? 1 : 0;
+        count += (i > 0 && c2i(i - 1, j, k) != kMaxSize) ? 1 : 0;
+        count += (i + 1 < n.x && c2i(i + 1, j, k) != kMaxSize) ? 1 : 0;
+        count += (j + 1 < n.y && c2i(i, j + 1, k) != kMaxSize) ? 1 : 0;
+        count += (k + 1 < n.z && c2i(i, j, k + 1) != kMaxSize) ? 1 : 0;
+        rowCounts[row] = count;
+    });
+
+    std::vector<size_t> rowOffsets;
+    const size_t numberOfNonZeros =
+        parallelExclusiveScan(rowCounts, &rowOffsets);
+
+    matrix->reserve(numberOfRows, numberOfRows, numberOfNonZeros);
+    auto rowPointers = matrix->rowPointersBegin();
+    auto columnIndices = matrix->columnIndicesBegin();
+    auto nonZeros = matrix->nonZeroBegin();
+    rowPointers[numberOfRows] = numberOfNonZeros;
+
+    // Fill each row in ascending column order: back, down, left, center,
+    // right, up, front.
+    parallelFor(kZeroSize, numberOfRows, [&](size_t row) {
+        const Point3UI& p = _indexToCoord[row];
+        const size_t i = p.x;
+        const size_t j = p.y;
+        const size_t k = p.z;
+        size_t e = rowOffsets[row];
+        rowPointers[row] = e;
+
+        auto emit = [&](size_t column, double value) {
+            columnIndices[e] = column;
+            nonZeros[e] = value;
+            ++e;
+        };
+
+        if (k > 0 && c2i(i, j, k - 1) != kMaxSize) {
+            emit(c2i(i, j, k - 1), op.front(i, j, k - 1));
+        }
+        if (j > 0 && c2i(i, j - 1, k) != kMaxSize) {
+            emit(c2i(i, j - 1, k), op.up(i, j - 1, k));
+        }
+        if (i > 0 && c2i(i - 1, j, k) != kMaxSize) {
+            emit(c2i(i - 1, j, k), op.right(i - 1, j, k));
+        }
+        emit(row, op.center(i, j, k));
+        if (i + 1 < n.x && c2i(i + 1, j, k) != kMaxSize) {
+            emit(c2i(i + 1, j, k), op.right(i, j, k));
+        }
+        if (j + 1 < n.y && c2i(i, j + 1, k) != kMaxSize) {
+            emit(c2i(i, j + 1, k), op.up(i, j, k));
+        }
+        if (k + 1 < n.z && c2i(i, j, k + 1) != kMaxSize) {
+            emit(c2i(i, j, k + 1), op.front(i, j, k));
+        }
+    });
+}
+
+inline void FdmCompressedLinearSystemBuilder3::buildMatrix(
+    const FdmMatrix3& matrix, MatrixCsrD* result) const {
+    JET_ASSERT(matrix.size() == size());
+
+    buildMatrix(internal::FdmMatrix3Operator{matrix}, result);
+}
+
+template <typename Function>
+void FdmCompressedLinearSystemBuilder3::compress(const Function& func,
+                                                 VectorND* result) const {
+    result->resize(_indexToCoord.size());
+    parallelFor(kZeroSize, _indexToCoord.size(), [&](size_t row) {
+        const Point3UI& p = _indexToCoord[row];
+        (*result)[row] = func(p.x, p.y, p.z);
+    });
+}
+
+inline void FdmCompressedLinearSystemBuilder3::compress(
+    const FdmVector3& vector, VectorND* result) const {
+    JET_ASSERT(vector.size() == size());
+
+    compress([&](size_t i, size_t j, size_t k) { return vector(i, j, k); },
+             result);
+}
+
+inline void FdmCompressedLinearSystemBuilder3::decompress(
+    const VectorND& vector, FdmVector3* result) const {
+    JET_ASSERT(vector.size() == numberOfRows());
+
+    result->resize(size());
+    result->parallelForEachIndex([&](size_t i, size_t j, size_t k) {
+        const size_t row = _coordToIndex(i, j, k);
+        (*result)(i, j, k) = (row != kMaxSize) ? vector[row] : 0.0;
+    });
+}
+
+inline void FdmCompressedLinearSystemBuilder3::clear() {
+    _coordToIndex.clear();
+    _indexToCoord.clear();
+}
+
+}  // namespace jet
+
+#endif  // INCLUDE_JET_DETAIL_FDM_COMPRESSED_LINEAR_SYSTEM_BUILDER3_INL_H_
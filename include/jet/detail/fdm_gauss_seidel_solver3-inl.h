@@ -0,0 +1,162 @@
+// Copyright (c) 2018 Doyub Kim
+//
+// I am making my contributions/submissions to this project solely in my
+// personal capacity and am not conveying any rights to any intellectual
+// property of any third parties.
+
+#ifndef INCLUDE_JET_DETAIL_FDM_GAUSS_SEIDEL_SOLVER3_INL_H_
+#define INCLUDE_JET_DETAIL_FDM_GAUSS_SEIDEL_SOLVER3_INL_H_
+
+#include <jet/fdm_gauss_seidel_solver3.h>
+#include <jet/parallel.h>
+
+#include <algorithm>
+#include <vector>
+
+namespace jet {
+
+namespace internal {
+
+// Edge length in cells of the x/y tiles used by forEachWavefrontTile.
+constexpr size_t kWavefrontTileSize = 32;
+
+//
+// Runs numberOfStages dependent sweeps over a grid as a wavefront. Stage h
+// processes layer k at step k + 2h, so a layer gets all of its stages while
+// it and its neighbors are still in cache. The skew of two layers makes every
+// stage see exactly the same neighbor values as a full sweep would, and the
+// layers of a single step are far enough apart to be processed in parallel.
+//
+// Each layer is further split into kWavefrontTileSize^2 tiles in x and y so
+// that a task works on a cache-sized block, and the tiles of all the active
+// layers of a step run in parallel. If orderedTiles is true, tile (ti, tj)
+// runs after (ti - 1, tj) and (ti, tj - 1), one tile diagonal at a time,
+// which gives the same result as visiting the layer in natural order.
+//
+template <typename Callback>
+void forEachWavefrontTile(const Size3& size, unsigned int numberOfStages,
+                          bool orderedTiles, const Callback& func) {
+    if (size.x == 0 || size.y == 0 || size.z == 0 || numberOfStages == 0) {
+        return;
+    }
+
+    struct Task {
+        size_t h;
+        size_t ti;
+        size_t tj;
+    };
+
+    const size_t numTilesX =
+        (size.x + kWavefrontTileSize - 1) / kWavefrontTileSize;
+    const size_t numTilesY =
+        (size.y + kWavefrontTileSize - 1) / kWavefrontTileSize;
+    const size_t numberOfDiagonals =
+        orderedTiles ? numTilesX + numTilesY - 1 : 1;
+
+    const size_t lastStage = numberOfStages - 1;
+    const size_t numberOfSteps = size.z + 2 * lastStage;
+    std::vector<Task> tasks;
+    for (size_t step = 0; step < numberOfSteps; ++step) {
+        const size_t hBegin = (step >= size.z) ? (step - size.z) / 2 + 1 : 0;
+        const size_t hEnd = std::min(step / 2, lastStage) + 1;
+
+        for (size_t diagonal = 0; diagonal < numberOfDiagonals; ++diagonal) {
+            tasks.clear();
+            for (size_t h = hBegin; h < hEnd; ++h) {
+                for (size_t tj = 0; tj < numTilesY; ++tj) {
+                    if (!orderedTiles) {
+                        for (size_t ti = 0; ti < numTilesX; ++ti) {
+                            tasks.push_back({h, ti, tj});
+                        }
+                    } else if (diagonal >= tj && diagonal - tj < numTilesX) {
+                        tasks.push_back({h, diagonal - tj, tj});
+                    }
+                }
+            }
+
+            parallelFor(kZeroSize, tasks.size(), [&](size_t t) {
+                const Task& task = tasks[t];
+                const size_t iBegin = task.ti * kWavefrontTileSize;
+                const size_t jBegin = task.tj * kWavefrontTileSize;
+                func(task.h, step - 2 * task.h, iBegin,
+                     std::min(iBegin + kWavefrontTileSize, size.x), jBegin,
+                     std::min(jBegin + kWavefrontTileSize, size.y));
+            });
+        }
+    }
+}
+
+// Relaxes the tile [iBegin, iEnd) x [jBegin, jEnd) of layer k in natural
+// order. With iStride 2, only the cells with (i + j + k + parity) even are
+// visited.
+inline void gaussSeidelRelaxTile(const FdmMatrix3& A, const FdmVector3& b,
+                                 double sorFactor, size_t k, size_t iBegin,
+                                 size_t iEnd, size_t jBegin, size_t jEnd,
+                                 size_t iStride, size_t parity,
+                                 FdmVector3* x) {
+    const Size3 size = A.size();
+    FdmVector3& xRef = *x;
+
+    for (size_t j = jBegin; j < jEnd; ++j) {
+        size_t iFirst = iBegin;
+        if (iStride == 2) {
+            iFirst += (iBegin + j + k + parity) % 2;
+        }
+        for (size_t i = iFirst; i < iEnd; i += iStride) {
+            double r =
+                ((i > 0) ? A(i - 1, j, k).right * xRef(i - 1, j, k) : 0.0) +
+                ((i + 1 < size.x) ? A(i, j, k).right * xRef(i + 1, j, k)
+                                  : 0.0) +
+                ((j > 0) ? A(i, j - 1, k).up * xRef(i, j - 1, k) : 0.0) +
+                ((j + 1 < size.y) ? A(i, j, k).up * xRef(i, j + 1, k) : 0.0) +
+                ((k > 0) ? A(i, j, k - 1).front * xRef(i, j, k - 1) : 0.0) +
+                ((k + 1 < size.z) ? A(i, j, k).front * xRef(i, j, k + 1)
+                                  : 0.0);
+
+            xRef(i, j, k) = (1.0 - sorFactor) * xRef(i, j, k) +
+                            sorFactor * (b(i, j, k) - r) / A(i, j, k).center;
+        }
+    }
+}
+
+}  // namespace internal
+
+inline void FdmGaussSeidelSolver3::relaxBlocked(const FdmMatrix3& A,
+                                                const FdmVector3& b,
+                                                double sorFactor,
+                                                unsigned int numberOfIterations,
+                                                FdmVector3* x) {
+    JET_ASSERT(A.size() == b.size());
+    JET_ASSERT(A.size() == x->size());
+
+    // Ordered tiles reproduce the natural ordering within each layer.
+    internal::forEachWavefrontTile(
+        A.size(), numberOfIterations, true,
+        [&](size_t, size_t k, size_t iBegin, size_t iEnd, size_t jBegin,
+            size_t jEnd) {
+            internal::gaussSeidelRelaxTile(A, b, sorFactor, k, iBegin, iEnd,
+                                           jBegin, jEnd, 1, 0, x);
+        });
+}
+
+inline void FdmGaussSeidelSolver3::relaxRedBlackBlocked(
+    const FdmMatrix3& A, const FdmVector3& b, double sorFactor,
+    unsigned int numberOfIterations, FdmVector3* x) {
+    JET_ASSERT(A.size() == b.size());
+    JET_ASSERT(A.size() == x->size());
+
+    // Each iteration is a red and a black half-sweep; stage h relaxes the
+    // cells with (i + j + k + h) even.
+    // Cells of one color are independent, so the tiles need no order.
+    internal::forEachWavefrontTile(
+        A.size(), 2 * numberOfIterations, false,
+        [&](size_t h, size_t k, size_t iBegin, size_t iEnd, size_t jBegin,
+            size_t jEnd) {
+            internal::gaussSeidelRelaxTile(A, b, sorFactor, k, iBegin, iEnd,
+                                           jBegin, jEnd, 2, h % 2, x);
+        });
+}
+
+}  // namespace jet
+
+#endif  // INCLUDE_JET_DETAIL_FDM_GAUSS_SEIDEL_SOLVER3_INL_H_
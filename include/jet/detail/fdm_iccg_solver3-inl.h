@@ -0,0 +1,92 @@
+// Copyright (c) 2018 Doyub Kim
+//
+// I am making my contributions/submissions to this project solely in my
+// personal capacity and am not conveying any rights to any intellectual
+// property of any third parties.
+
+#ifndef INCLUDE_JET_DETAIL_FDM_ICCG_SOLVER3_INL_H_
+#define INCLUDE_JET_DETAIL_FDM_ICCG_SOLVER3_INL_H_
+
+#include <jet/fdm_iccg_solver3.h>
+#include <jet/logging.h>
+
+namespace jet {
+
+inline bool FdmIccgSolver3::solve(FdmLinearSystem3* system) {
+    FdmMatrix3& matrix = system->A;
+    FdmVector3& solution = system->x;
+    FdmVector3& rhs = system->b;
+    Timer timer;
+
+    JET_ASSERT(matrix.size() == rhs.size());
+    JET_ASSERT(matrix.size() == solution.size());
+
+    clearCompressedVectors();
+
+    _precond.build(matrix);
+
+    _lastSolveHitTimeBudget = _pcg.pcg(
+        _workspace.get(), matrix, rhs, _maxNumberOfIterations, _tolerance,
+        &_precond, &solution, &_lastNumberOfIterations, &_lastResidualNorm,
+        remainingTimeBudget(timer));
+
+    JET_INFO << "Residual after solving ICCG: " << _lastResidualNorm
+             << " Number of ICCG iterations: " << _lastNumberOfIterations;
+
+    return !_lastSolveHitTimeBudget &&
+           (_lastResidualNorm <= _tolerance ||
+            _lastNumberOfIterations < _maxNumberOfIterations);
+}
+
+inline bool FdmIccgSolver3::solveCompressed(
+    FdmCompressedLinearSystem3* system) {
+    MatrixCsrD& matrix = system->A;
+    VectorND& solution = system->x;
+    VectorND& rhs = system->b;
+    Timer timer;
+
+    clearUncompressedVectors();
+
+    _precondComp.build(matrix);
+
+    _lastSolveHitTimeBudget = _pcgComp.pcg(
+        _workspace.get(), matrix, rhs, _maxNumberOfIterations, _tolerance,
+        &_precondComp, &solution, &_lastNumberOfIterations,
+        &_lastResidualNorm, remainingTimeBudget(timer));
+
+    JET_INFO << "Residual after solving ICCG: " << _lastResidualNorm
+             << " Number of ICCG iterations: " << _lastNumberOfIterations;
+
+    return !_lastSolveHitTimeBudget &&
+           (_lastResidualNorm <= _tolerance ||
+            _lastNumberOfIterations < _maxNumberOfIterations);
+}
+
+inline const FdmSolverWorkspace3Ptr& FdmIccgSolver3::workspace() const {
+    return _workspace;
+}
+
+inline void FdmIccgSolver3::setWorkspace(
+    const FdmSolverWorkspace3Ptr& workspace) {
+    _workspace = workspace;
+    if (_workspace != nullptr) {
+        clearUncompressedVectors();
+        clearCompressedVectors();
+    }
+}
+
+inline void FdmIccgSolver3::clearUncompressedVectors() {
+    _pcg.clear();
+    _precond.d.clear();
+    _precond.y.clear();
+}
+
+inline void FdmIccgSolver3::clearCompressedVectors() {
+    _pcgComp.clear();
+    _precondComp.d.clear();
+    _precondComp.y.clear();
+}
+
+}  // namespace jet
+
+#endif  // INCLUDE_JET_DETAIL_FDM_ICCG_SOLVER3_INL_H_
@@ -0,0 +1,65 @@
+// Copyright (c) 2018 Doyub Kim
+//
+// I am making my contributions/submissions to this project solely in my
+// personal capacity and am not conveying any rights to any intellectual
+// property of any third parties.
+
+#ifndef INCLUDE_JET_DETAIL_FDM_JACOBI_SOLVER3_INL_H_
+#define INCLUDE_JET_DETAIL_FDM_JACOBI_SOLVER3_INL_H_
+
+#include <jet/fdm_gauss_seidel_solver3.h>
+#include <jet/fdm_jacobi_solver3.h>
+
+namespace jet {
+
+inline void FdmJacobiSolver3::relaxBlocked(const FdmMatrix3& A,
+                                           const FdmVector3& b,
+                                           unsigned int numberOfIterations,
+                                           FdmVector3* x, FdmVector3* xTemp) {
+    Size3 size = A.size();
+
+    JET_ASSERT(size == b.size());
+    JET_ASSERT(size == x->size());
+    JET_ASSERT(size == xTemp->size());
+
+    // Iteration h reads buffers[h % 2] and writes buffers[(h + 1) % 2].
+    FdmVector3* buffers[2] = {x, xTemp};
+
+    // Cells of one iteration are independent, so the tiles need no order.
+    internal::forEachWavefrontTile(
+        size, numberOfIterations, false,
+        [&](size_t h, size_t k, size_t iBegin, size_t iEnd, size_t jBegin,
+            size_t jEnd) {
+            const FdmVector3& src = *buffers[h % 2];
+            FdmVector3& dst = *buffers[(h + 1) % 2];
+
+            for (size_t j = jBegin; j < jEnd; ++j) {
+                for (size_t i = iBegin; i < iEnd; ++i) {
+                    double r =
+                        ((i > 0) ? A(i - 1, j, k).right * src(i - 1, j, k)
+                                 : 0.0) +
+                        ((i + 1 < size.x) ? A(i, j, k).right * src(i + 1, j, k)
+                                          : 0.0) +
+                        ((j > 0) ? A(i, j - 1, k).up * src(i, j - 1, k)
+                                 : 0.0) +
+                        ((j + 1 < size.y) ? A(i, j, k).up * src(i, j + 1, k)
+                                          : 0.0) +
+                        ((k > 0) ? A(i, j, k - 1).front * src(i, j, k - 1)
+                                 : 0.0) +
+                        ((k + 1 < size.z) ? A(i, j, k).front * src(i, j, k + 1)
+                                          : 0.0);
+
+                    dst(i, j, k) = (b(i, j, k) - r) / A(i, j, k).center;
+                }
+            }
+        });
+
+    // Same buffer ownership as calling relax() numberOfIterations times
+    if (numberOfIterations % 2 == 1) {
+        x->swap(*xTemp);
+    }
+}
+
+}  // namespace jet
+
+#endif  // INCLUDE_JET_DETAIL_FDM_JACOBI_SOLVER3_INL_H_
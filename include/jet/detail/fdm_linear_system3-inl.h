@@ -0,0 +1,203 @@
+// Copyright (c) 2018 Doyub Kim
+//
+// I am making my contributions/submissions to this project solely in my
+// personal capacity and am not conveying any rights to any intellectual
+// property of any third parties.
+
+#ifndef INCLUDE_JET_DETAIL_FDM_LINEAR_SYSTEM3_INL_H_
+#define INCLUDE_JET_DETAIL_FDM_LINEAR_SYSTEM3_INL_H_
+
+#include <jet/fdm_linear_system3.h>
+#include <jet/parallel.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace jet {
+
+inline void FdmCompressedBlas3::mvm(const MatrixCsrD& m, const VectorND& v,
+                                    VectorND* result) {
+    m.mul(v, result);
+}
+
+inline void FdmCompressedBlas3::residual(const MatrixCsrD& a, const VectorND& x,
+                                         const VectorND& b, VectorND* result) {
+    a.residual(x, b, result);
+}
+
+namespace internal {
+
+// Double-precision accumulation of a float dot product.
+inline double dotAccumulated(const float* a, const float* b, size_t n) {
+    return parallelReduce(kZeroSize, n, 0.0,
+                          [&](size_t start, size_t end, double init) {
+                              double result = init;
+                              for (size_t i = start; i < end; ++i) {
+                                  result += static_cast<double>(a[i]) * b[i];
+                              }
+                              return result;
+                          },
+                          std::plus<double>());
+}
+
+inline float absMaxOf(const float* a, size_t n) {
+    return parallelReduce(kZeroSize, n, 0.f,
+                          [&](size_t start, size_t end, float init) {
+                              float result = init;
+                              for (size_t i = start; i < end; ++i) {
+                                  result = std::max(result, std::fabs(a[i]));
+                              }
+                              return result;
+                          },
+                          [](float a, float b) { return std::max(a, b); });
+}
+
+inline void axpyFloat(double a, const float* x, const float* y, float* result,
+                      size_t n) {
+    const float af = static_cast<float>(a);
+    parallelRangeFor(kZeroSize, n, [&](size_t start, size_t end) {
+        for (size_t i = start; i < end; ++i) {
+            result[i] = af * x[i] + y[i];
+        }
+    });
+}
+
+}  // namespace internal
+
+inline void FdmBlas3F::set(ScalarType s, VectorType* result) {
+    result->set(s);
+}
+
+inline void FdmBlas3F::set(const VectorType& v, VectorType* result) {
+    result->set(v);
+}
+
+inline void FdmBlas3F::set(ScalarType s, MatrixType* result) {
+    FdmMatrixRow3F row;
+    row.center = row.right = row.up = row.front = s;
+    result->set(row);
+}
+
+inline void FdmBlas3F::set(const MatrixType& m, MatrixType* result) {
+    result->set(m);
+}
+
+inline double FdmBlas3F::dot(const VectorType& a, const VectorType& b) {
+    const Size3 size = a.size();
+    JET_THROW_INVALID_ARG_IF(size != b.size());
+    return internal::dotAccumulated(a.data(), b.data(),
+                                    size.x * size.y * size.z);
+}
+
+inline void FdmBlas3F::axpy(double a, const VectorType& x, const VectorType& y,
+                            VectorType* result) {
+    const Size3 size = x.size();
+    JET_THROW_INVALID_ARG_IF(size != y.size());
+    JET_THROW_INVALID_ARG_IF(size != result->size());
+    internal::axpyFloat(a, x.data(), y.data(), result->data(),
+                        size.x * size.y * size.z);
+}
+
+inline void FdmBlas3F::mvm(const MatrixType& m, const VectorType& v,
+                           VectorType* result) {
+    const Size3 size = m.size();
+    JET_THROW_INVALID_ARG_IF(size != v.size());
+    JET_THROW_INVALID_ARG_IF(size != result->size());
+
+    m.parallelForEachIndex([&](size_t i, size_t j, size_t k) {
+        (*result)(i, j, k) =
+            m(i, j, k).center * v(i, j, k) +
+            ((i > 0) ? m(i - 1, j, k).right * v(i - 1, j, k) : 0.f) +
+            ((i + 1 < size.x) ? m(i, j, k).right * v(i + 1, j, k) : 0.f) +
+            ((j > 0) ? m(i, j - 1, k).up * v(i, j - 1, k) : 0.f) +
+            ((j + 1 < size.y) ? m(i, j, k).up * v(i, j + 1, k) : 0.f) +
+            ((k > 0) ? m(i, j, k - 1).front * v(i, j, k - 1) : 0.f) +
+            ((k + 1 < size.z) ? m(i, j, k).front * v(i, j, k + 1) : 0.f);
+    });
+}
+
+inline void FdmBlas3F::residual(const MatrixType& a, const VectorType& x,
+                                const VectorType& b, VectorType* result) {
+    const Size3 size = a.size();
+    JET_THROW_INVALID_ARG_IF(size != x.size());
+    JET_THROW_INVALID_ARG_IF(size != b.size());
+    JET_THROW_INVALID_ARG_IF(size != result->size());
+
+    a.parallelForEachIndex([&](size_t i, size_t j, size_t k) {
+        (*result)(i, j, k) =
+            b(i, j, k) - a(i, j, k).center * x(i, j, k) -
+            ((i > 0) ? a(i - 1, j, k).right * x(i - 1, j, k) : 0.f) -
+            ((i + 1 < size.x) ? a(i, j, k).right * x(i + 1, j, k) : 0.f) -
+            ((j > 0) ? a(i, j - 1, k).up * x(i, j - 1, k) : 0.f) -
+            ((j + 1 < size.y) ? a(i, j, k).up * x(i, j + 1, k) : 0.f) -
+            ((k > 0) ? a(i, j, k - 1).front * x(i, j, k - 1) : 0.f) -
+            ((k + 1 < size.z) ? a(i, j, k).front * x(i, j, k + 1) : 0.f);
+    });
+}
+
+inline FdmBlas3F::ScalarType FdmBlas3F::l2Norm(const VectorType& v) {
+    return static_cast<float>(std::sqrt(dot(v, v)));
+}
+
+inline FdmBlas3F::ScalarType FdmBlas3F::lInfNorm(const VectorType& v) {
+    const Size3 size = v.size();
+    return internal::absMaxOf(v.data(), size.x * size.y * size.z);
+}
+
+inline void FdmCompressedBlas3F::set(ScalarType s, VectorType* result) {
+    result->set(s);
+}
+
+inline void FdmCompressedBlas3F::set(const VectorType& v,
+                                     VectorType* result) {
+    result->set(v);
+}
+
+inline void FdmCompressedBlas3F::set(ScalarType s, MatrixType* result) {
+    result->set(s);
+}
+
+inline void FdmCompressedBlas3F::set(const MatrixType& m,
+                                     MatrixType* result) {
+    result->set(m);
+}
+
+inline double FdmCompressedBlas3F::dot(const VectorType& a,
+                                       const VectorType& b) {
+    JET_THROW_INVALID_ARG_IF(a.size() != b.size());
+    return internal::dotAccumulated(a.data(), b.data(), a.size());
+}
+
+inline void FdmCompressedBlas3F::axpy(double a, const VectorType& x,
+                                      const VectorType& y,
+                                      VectorType* result) {
+    JET_THROW_INVALID_ARG_IF(x.size() != y.size());
+    result->resize(x.size());
+    internal::axpyFloat(a, x.data(), y.data(), result->data(), x.size());
+}
+
+inline void FdmCompressedBlas3F::mvm(const MatrixType& m, const VectorType& v,
+                                     VectorType* result) {
+    m.mul(v, result);
+}
+
+inline void FdmCompressedBlas3F::residual(const MatrixType& a,
+                                          const VectorType& x,
+                                          const VectorType& b,
+                                          VectorType* result) {
+    a.residual(x, b, result);
+}
+
+inline FdmCompressedBlas3F::ScalarType FdmCompressedBlas3F::l2Norm(
+    const VectorType& v) {
+    return static_cast<float>(std::sqrt(dot(v, v)));
+}
+
+inline FdmCompressedBlas3F::ScalarType FdmCompressedBlas3F::lInfNorm(
+    const VectorType& v) {
+    return internal::absMaxOf(v.data(), v.size());
+}
+
+}  // namespace jet
+
+#endif  // INCLUDE_JET_DETAIL_FDM_LINEAR_SYSTEM3_INL_H_
@@ -0,0 +1,276 @@
+// Copyright (c) 2018 Doyub Kim
+//
+// I am making my contributions/submissions to this project solely in my
+// personal capacity and am not conveying any rights to any intellectual
+// property of any third parties.
+
+#ifndef INCLUDE_JET_DETAIL_FDM_MATRIX_FREE3_INL_H_
+#define INCLUDE_JET_DETAIL_FDM_MATRIX_FREE3_INL_H_
+
+#include <jet/constants.h>
+#include <jet/fdm_matrix_free3.h>
+#include <jet/level_set_utils.h>
+#include <jet/parallel.h>
+
+#include <algorithm>
+
+namespace jet {
+
+inline FdmMatrixFree3::FdmMatrixFree3(const ConstArrayAccessor3<char>& markers,
+                                      const Vector3D& gridSpacing)
+    : _isFractional(false),
+      _invHSqr(Vector3D(1.0, 1.0, 1.0) / (gridSpacing * gridSpacing)),
+      _markers(markers) {}
+
+inline FdmMatrixFree3::FdmMatrixFree3(
+    const ConstArrayAccessor3<float>& uWeights,
+    const ConstArrayAccessor3<float>& vWeights,
+    const ConstArrayAccessor3<float>& wWeights,
+    const ConstArrayAccessor3<float>& fluidSdf, const Vector3D& gridSpacing)
+    : _isFractional(true),
+      _invHSqr(Vector3D(1.0, 1.0, 1.0) / (gridSpacing * gridSpacing)),
+      _uWeights(uWeights),
+      _vWeights(vWeights),
+      _wWeights(wWeights),
+      _fluidSdf(fluidSdf) {
+    const Size3 n = fluidSdf.size();
+    JET_THROW_INVALID_ARG_IF(uWeights.size() != Size3(n.x + 1, n.y, n.z));
+    JET_THROW_INVALID_ARG_IF(vWeights.size() != Size3(n.x, n.y + 1, n.z));
+    JET_THROW_INVALID_ARG_IF(wWeights.size() != Size3(n.x, n.y, n.z + 1));
+}
+
+inline Size3 FdmMatrixFree3::size() const {
+    return _isFractional ? _fluidSdf.size() : _markers.size();
+}
+
+inline double FdmMatrixFree3::offDiagonal(double weight, float phi0,
+                                          float phi1, double invHSqr) const {
+    if (isInsideSdf(phi0) && isInsideSdf(phi1)) {
+        return -weight * invHSqr;
+    }
+    return 0.0;
+}
+
+inline double FdmMatrixFree3::diagonalTerm(double weight, float phi0,
+                                           float phi1, double invHSqr) const {
+    double term = weight * invHSqr;
+    if (isInsideSdf(phi1)) {
+        return term;
+    }
+
+    // Ghost fluid method for the free surface
+    double theta = fractionInsideSdf(phi0, phi1);
+    theta = std::max(theta, 0.01);
+    return term / theta;
+}
+
+inline double FdmMatrixFree3::fractionalCenter(size_t i, size_t j,
+                                               size_t k) const {
+    const Size3 n = size();
+    const float centerPhi = _fluidSdf(i, j, k);
+
+    double c = 0.0;
+    if (i + 1 < n.x) {
+        c += diagonalTerm(_uWeights(i + 1, j, k), centerPhi,
+                          _fluidSdf(i + 1, j, k), _invHSqr.x);
+    }
+    if (i > 0) {
+        c += diagonalTerm(_uWeights(i, j, k), centerPhi,
+                          _fluidSdf(i - 1, j, k), _invHSqr.x);
+    }
+    if (j + 1 < n.y) {
+        c += diagonalTerm(_vWeights(i, j + 1, k), centerPhi,
+                          _fluidSdf(i, j + 1, k), _invHSqr.y);
+    }
+    if (j > 0) {
+        c += diagonalTerm(_vWeights(i, j, k), centerPhi,
+                          _fluidSdf(i, j - 1, k), _invHSqr.y);
+    }
+    if (k + 1 < n.z) {
+        c += diagonalTerm(_wWeights(i, j, k + 1), centerPhi,
+                          _fluidSdf(i, j, k + 1), _invHSqr.z);
+    }
+    if (k > 0) {
+        c += diagonalTerm(_wWeights(i, j, k), centerPhi,
+                          _fluidSdf(i, j, k - 1), _invHSqr.z);
+    }
+    return c;
+}
+
+inline double FdmMatrixFree3::center(size_t i, size_t j, size_t k) const {
+    const Size3 n = size();
+
+    if (_isFractional) {
+        if (!isInsideSdf(_fluidSdf(i, j, k))) {
+            return 1.0;
+        }
+
+        // If the center is near-zero, the cell is likely inside a solid
+        // boundary.
+        const double c = fractionalCenter(i, j, k);
+        return (c < kEpsilonD) ? 1.0 : c;
+    }
+
+    if (_markers(i, j, k) != kFluid) {
+        return 1.0;
+    }
+
+    double c = 0.0;
+    if (i + 1 < n.x && _markers(i + 1, j, k) != kBoundary) {
+        c += _invHSqr.x;
+    }
+    if (i > 0 && _markers(i - 1, j, k) != kBoundary) {
+        c += _invHSqr.x;
+    }
+    if (j + 1 < n.y && _markers(i, j + 1, k) != kBoundary) {
+        c += _invHSqr.y;
+    }
+    if (j > 0 && _markers(i, j - 1, k) != kBoundary) {
+        c += _invHSqr.y;
+    }
+    if (k + 1 < n.z && _markers(i, j, k + 1) != kBoundary) {
+        c += _invHSqr.z;
+    }
+    if (k > 0 && _markers(i, j, k - 1) != kBoundary) {
+        c += _invHSqr.z;
+    }
+    return c;
+}
+
+inline bool FdmMatrixFree3::isDecoupled(size_t i, size_t j,
+                                        size_t k) const {
+    return _isFractional && isInsideSdf(_fluidSdf(i, j, k)) &&
+           fractionalCenter(i, j, k) < kEpsilonD;
+}
+
+inline double FdmMatrixFree3::right(size_t i, size_t j, size_t k) const {
+    if (i + 1 >= size().x) {
+        return 0.0;
+    }
+
+    if (_isFractional) {
+        return offDiagonal(_uWeights(i + 1, j, k), _fluidSdf(i, j, k),
+                           _fluidSdf(i + 1, j, k), _invHSqr.x);
+    }
+
+    return (_markers(i, j, k) == kFluid && _markers(i + 1, j, k) == kFluid)
+               ? -_invHSqr.x
+               : 0.0;
+}
+
+inline double FdmMatrixFree3::up(size_t i, size_t j, size_t k) const {
+    if (j + 1 >= size().y) {
+        return 0.0;
+    }
+
+    if (_isFractional) {
+        return offDiagonal(_vWeights(i, j + 1, k), _fluidSdf(i, j, k),
+                           _fluidSdf(i, j + 1, k), _invHSqr.y);
+    }
+
+    return (_markers(i, j, k) == kFluid && _markers(i, j + 1, k) == kFluid)
+               ? -_invHSqr.y
+               : 0.0;
+}
+
+inline double FdmMatrixFree3::front(size_t i, size_t j, size_t k) const {
+    if (k + 1 >= size().z) {
+        return 0.0;
+    }
+
+    if (_isFractional) {
+        return offDiagonal(_wWeights(i, j, k + 1), _fluidSdf(i, j, k),
+                           _fluidSdf(i, j, k + 1), _invHSqr.z);
+    }
+
+    return (_markers(i, j, k) == kFluid && _markers(i, j, k + 1) == kFluid)
+               ? -_invHSqr.z
+               : 0.0;
+}
+
+inline FdmMatrixRow3 FdmMatrixFree3::row(size_t i, size_t j, size_t k) const {
+    FdmMatrixRow3 r;
+    r.center = center(i, j, k);
+    r.right = right(i, j, k);
+    r.up = up(i, j, k);
+    r.front = front(i, j, k);
+    return r;
+}
+
+inline void FdmMatrixFree3::toMatrix(FdmMatrix3* matrix) const {
+    matrix->resize(size());
+    matrix->parallelForEachIndex([&](size_t i, size_t j, size_t k) {
+        (*matrix)(i, j, k) = row(i, j, k);
+    });
+}
+
+inline void FdmMatrixFreeBlas3::set(ScalarType s, VectorType* result) {
+    FdmBlas3::set(s, result);
+}
+
+inline void FdmMatrixFreeBlas3::set(const VectorType& v, VectorType* result) {
+    FdmBlas3::set(v, result);
+}
+
+inline double FdmMatrixFreeBlas3::dot(const VectorType& a,
+                                      const VectorType& b) {
+    return FdmBlas3::dot(a, b);
+}
+
+inline void FdmMatrixFreeBlas3::axpy(double a, const VectorType& x,
+                                     const VectorType& y, VectorType* result) {
+    FdmBlas3::axpy(a, x, y, result);
+}
+
+inline void FdmMatrixFreeBlas3::mvm(const MatrixType& m, const VectorType& v,
+                                    VectorType* result) {
+    const Size3 size = m.size();
+    JET_ASSERT(size == v.size());
+    JET_ASSERT(size == result->size());
+
+    result->parallelForEachIndex([&](size_t i, size_t j, size_t k) {
+        (*result)(i, j, k) =
+            m.center(i, j, k) * v(i, j, k) +
+            ((i > 0) ? m.right(i - 1, j, k) * v(i - 1, j, k) : 0.0) +
+            ((i + 1 < size.x) ? m.right(i, j, k) * v(i + 1, j, k) : 0.0) +
+            ((j > 0) ? m.up(i, j - 1, k) * v(i, j - 1, k) : 0.0) +
+            ((j + 1 < size.y) ? m.up(i, j, k) * v(i, j + 1, k) : 0.0) +
+            ((k > 0) ? m.front(i, j, k - 1) * v(i, j, k - 1) : 0.0) +
+            ((k + 1 < size.z) ? m.front(i, j, k) * v(i, j, k + 1) : 0.0);
+    });
+}
+
+inline void FdmMatrixFreeBlas3::residual(const MatrixType& a,
+                                         const VectorType& x,
+                                         const VectorType& b,
+                                         VectorType* result) {
+    const Size3 size = a.size();
+    JET_ASSERT(size == x.size());
+    JET_ASSERT(size == b.size());
+    JET_ASSERT(size == result->size());
+
+    result->parallelForEachIndex([&](size_t i, size_t j, size_t k) {
+        (*result)(i, j, k) =
+            b(i, j, k) - a.center(i, j, k) * x(i, j, k) -
+            ((i > 0) ? a.right(i - 1, j, k) * x(i - 1, j, k) : 0.0) -
+            ((i + 1 < size.x) ? a.right(i, j, k) * x(i + 1, j, k) : 0.0) -
+            ((j > 0) ? a.up(i, j - 1, k) * x(i, j - 1, k) : 0.0) -
+            ((j + 1 < size.y) ? a.up(i, j, k) * x(i, j + 1, k) : 0.0) -
+            ((k > 0) ? a.front(i, j, k - 1) * x(i, j, k - 1) : 0.0) -
+            ((k + 1 < size.z) ? a.front(i, j, k) * x(i, j, k + 1) : 0.0);
+    });
+}
+
+inline FdmMatrixFreeBlas3::ScalarType FdmMatrixFreeBlas3::l2Norm(
+    const VectorType& v) {
+    return FdmBlas3::l2Norm(v);
+}
+
+inline FdmMatrixFreeBlas3::ScalarType FdmMatrixFreeBlas3::lInfNorm(
+    const VectorType& v) {
+    return FdmBlas3::lInfNorm(v);
+}
+
+}  // namespace jet
+
+#endif  // INCLUDE_JET_DETAIL_FDM_MATRIX_FREE3_INL_H_
@@ -8,15 +8,20 @@
 #define INCLUDE_JET_FDM_MG_LINEAR_SYSTEM3_INL_H_
 
 #include <jet/fdm_mg_linear_system3.h>
+#include <jet/parallel.h>
+
+#include <algorithm>
+#include <array>
 
 namespace jet {
 
 template <typename T>
-void FdmMgUtils3::resizeArrayWithCoarsest(const Size3& coarsestResolution,
+bool FdmMgUtils3::resizeArrayWithCoarsest(const Size3& coarsestResolution,
                                           size_t numberOfLevels,
                                           std::vector<Array3<T>>* levels) {
     numberOfLevels = std::max(numberOfLevels, kOneSize);
 
+    bool reallocated = levels->size() != numberOfLevels;
     levels->resize(numberOfLevels);
 
     // Level 0 is the finest level, thus takes coarsestResolution ^
@@ -24,15 +29,21 @@ void FdmMgUtils3::resizeArrayWithCoarsest(const Size3& coarsestResolution,
     // Level numberOfLevels - 1 is the coarsest, taking coarsestResolution.
     Size3 res = coarsestResolution;
     for (size_t level = 0; level < numberOfLevels; ++level) {
-        (*levels)[numberOfLevels - level - 1].resize(res);
+        auto& array = (*levels)[numberOfLevels - level - 1];
+        if (array.size() != res) {
+            array.resize(res);
+            reallocated = true;
+        }
         res.x = res.x << 1;
         res.y = res.y << 1;
         res.z = res.z << 1;
     }
+
+    return reallocated;
 }
 
 template <typename T>
-void FdmMgUtils3::resizeArrayWithFinest(const Size3& finestResolution,
+bool FdmMgUtils3::resizeArrayWithFinest(const Size3& finestResolution,
                                         size_t maxNumberOfLevels,
                                         std::vector<Array3<T>>* levels) {
     Size3 res = finestResolution;
@@ -46,7 +57,139 @@ void FdmMgUtils3::resizeArrayWithFinest(const Size3& finestResolution,
             break;
         }
     }
-    resizeArrayWithCoarsest(res, i, levels);
+    return resizeArrayWithCoarsest(res, i, levels);
+}
+
+template <typename T>
+bool FdmMgUtils3::restrictMarkers(const Array3<T>& finer,
+                                  const Array3<char>& finerChanged,
+                                  Array3<T>* coarser,
+                                  Array3<char>* coarserChanged) {
+    JET_ASSERT(finer.size() == finerChanged.size());
+    JET_ASSERT(finer.size().x == 2 * coarser->size().x);
+    JET_ASSERT(finer.size().y == 2 * coarser->size().y);
+    JET_ASSERT(finer.size().z == 2 * coarser->size().z);
+
+    const Size3 n = coarser->size();
+    if (coarserChanged->size() != n) {
+        coarserChanged->resize(n);
+    }
+
+    parallelRangeFor(
+        kZeroSize, n.x, kZeroSize, n.y, kZeroSize, n.z,
+        [&](size_t iBegin, size_t iEnd, size_t jBegin, size_t jEnd,
+            size_t kBegin, size_t kEnd) {
+            std::array<size_t, 4> jIndices;
+            std::array<size_t, 4> kIndices;
+            std::array<size_t, 4> iIndices;
+
+            // Distinct markers under the footprint and their counts
+            std::array<T, 64> markers;
+            std::array<int, 64> counts;
+
+            for (size_t k = kBegin; k < kEnd; ++k) {
+                kIndices[0] = (k > 0) ? 2 * k - 1 : 2 * k;
+                kIndices[1] = 2 * k;
+                kIndices[2] = 2 * k + 1;
+                kIndices[3] = (k + 1 < n.z) ? 2 * k + 2 : 2 * k + 1;
+
+                for (size_t j = jBegin; j < jEnd; ++j) {
+                    jIndices[0] = (j > 0) ? 2 * j - 1 : 2 * j;
+                    jIndices[1] = 2 * j;
+                    jIndices[2] = 2 * j + 1;
+                    jIndices[3] = (j + 1 < n.y) ? 2 * j + 2 : 2 * j + 1;
+
+                    for (size_t i = iBegin; i < iEnd; ++i) {
+                        iIndices[0] = (i > 0) ? 2 * i - 1 : 2 * i;
+                        iIndices[1] = 2 * i;
+                        iIndices[2] = 2 * i + 1;
+                        iIndices[3] = (i + 1 < n.x) ? 2 * i + 2 : 2 * i + 1;
+
+                        (*coarserChanged)(i, j, k) = 0;
+
+                        bool isDirty = false;
+                        for (size_t z = 0; z < 4 && !isDirty; ++z) {
+                            for (size_t y = 0; y < 4 && !isDirty; ++y) {
+                                for (size_t x = 0; x < 4; ++x) {
+                                    if (finerChanged(iIndices[x], jIndices[y],
+                                                     kIndices[z])) {
+                                        isDirty = true;
+                                        break;
+                                    }
+                                }
+                            }
+                        }
+
+                        if (!isDirty) {
+                            continue;
+                        }
+
+                        size_t numberOfMarkers = 0;
+                        for (size_t z = 0; z < 4; ++z) {
+                            for (size_t y = 0; y < 4; ++y) {
+                                for (size_t x = 0; x < 4; ++x) {
+                                    const T& f = finer(
+                                        iIndices[x], jIndices[y], kIndices[z]);
+
+                                    size_t m = 0;
+                                    for (; m < numberOfMarkers; ++m) {
+                                        if (markers[m] == f) {
+                                            ++counts[m];
+                                            break;
+                                        }
+                                    }
+                                    if (m == numberOfMarkers) {
+                                        markers[m] = f;
+                                        counts[m] = 1;
+                                        ++numberOfMarkers;
+                                    }
+                                }
+                            }
+                        }
+
+                        // Ties go to the larger marker, as with argmax3.
+                        size_t best = 0;
+                        for (size_t m = 1; m < numberOfMarkers; ++m) {
+                            if (counts[m] > counts[best] ||
+                                (counts[m] == counts[best] &&
+                                 markers[best] < markers[m])) {
+                                best = m;
+                            }
+                        }
+
+                        if (!((*coarser)(i, j, k) == markers[best])) {
+                            (*coarser)(i, j, k) = markers[best];
+                            (*coarserChanged)(i, j, k) = 1;
+                        }
+                    }
+                }
+            }
+        });
+
+    return std::any_of(coarserChanged->begin(), coarserChanged->end(),
+                       [](char c) { return c != 0; });
+}
+
+inline size_t FdmMgUtils3::markChangedRows(const Array3<char>& changedMarkers,
+                                           Array3<char>* changedRows) {
+    const Size3 n = changedMarkers.size();
+    if (changedRows->size() != n) {
+        changedRows->resize(n);
+    }
+
+    changedRows->parallelForEachIndex([&](size_t i, size_t j, size_t k) {
+        bool changed = changedMarkers(i, j, k) != 0;
+        changed = changed || (i > 0 && changedMarkers(i - 1, j, k));
+        changed = changed || (i + 1 < n.x && changedMarkers(i + 1, j, k));
+        changed = changed || (j > 0 && changedMarkers(i, j - 1, k));
+        changed = changed || (j + 1 < n.y && changedMarkers(i, j + 1, k));
+        changed = changed || (k > 0 && changedMarkers(i, j, k - 1));
+        changed = changed || (k + 1 < n.z && changedMarkers(i, j, k + 1));
+        (*changedRows)(i, j, k) = changed ? 1 : 0;
+    });
+
+    return static_cast<size_t>(
+        std::count(changedRows->begin(), changedRows->end(), char(1)));
 }
 
 }  // namespace jet
@@ -0,0 +1,64 @@
+// Copyright (c) 2018 Doyub Kim
+//
+// I am making my contributions/submissions to this project solely in my
+// personal capacity and am not conveying any rights to any intellectual
+// property of any third parties.
+
+#ifndef INCLUDE_JET_DETAIL_FDM_MG_SOLVER3_INL_H_
+#define INCLUDE_JET_DETAIL_FDM_MG_SOLVER3_INL_H_
+
+#include <jet/fdm_mg_solver3.h>
+
+#include <algorithm>
+
+namespace jet {
+
+inline void FdmMgSolver3::setRelaxFunc(
+    const MgRelaxFunc<FdmBlas3>& relaxFunc) {
+    _mgParams.relaxFunc = relaxFunc;
+    _invalidateRelaxFunc = nullptr;
+}
+
+inline void FdmMgSolver3::setRelaxFunc(
+    const ChebyshevSmoother<FdmBlas3>& smoother) {
+    _mgParams.relaxFunc = smoother.relaxFunc();
+
+    ChebyshevSmoother<FdmBlas3> cached = smoother;
+    _invalidateRelaxFunc = [cached]() mutable { cached.invalidate(); };
+    _lastSystem = nullptr;
+}
+
+inline void FdmMgSolver3::setRelaxFunc(const FdmBlockedSmoother3& smoother) {
+    setRelaxFunc(smoother.relaxFunc());
+}
+
+inline bool FdmMgSolver3::solve(FdmMgLinearSystem3* system) {
+    validateRelaxFunc(*system);
+
+    FdmMgVector3 buffer = system->x;
+    auto result =
+        mgVCycle(system->A, _mgParams, &system->x, &system->b, &buffer);
+    return result.lastResidualNorm < _mgParams.maxTolerance;
+}
+
+inline void FdmMgSolver3::validateRelaxFunc(
+    const FdmMgLinearSystem3& system) {
+    if (_invalidateRelaxFunc == nullptr) {
+        return;
+    }
+
+    if (_lastSystem != &system ||
+        _lastMatrixVersion != system.matrixVersion) {
+        _invalidateRelaxFunc();
+        _lastSystem = &system;
+        _lastMatrixVersion = system.matrixVersion;
+    }
+}
+
+inline void FdmMgSolver3::setMaxNumberOfLevels(size_t numberOfLevels) {
+    _mgParams.maxNumberOfLevels = std::max(numberOfLevels, kOneSize);
+}
+
+}  // namespace jet
+
+#endif  // INCLUDE_JET_DETAIL_FDM_MG_SOLVER3_INL_H_
@@ -0,0 +1,50 @@
+// Copyright (c) 2018 Doyub Kim
+//
+// I am making my contributions/submissions to this project solely in my
+// personal capacity and am not conveying any rights to any intellectual
+// property of any third parties.
+
+#ifndef INCLUDE_JET_DETAIL_FDM_MGPCG_SOLVER3_INL_H_
+#define INCLUDE_JET_DETAIL_FDM_MGPCG_SOLVER3_INL_H_
+
+#include <jet/fdm_mgpcg_solver3.h>
+#include <jet/logging.h>
+
+namespace jet {
+
+inline bool FdmMgpcgSolver3::solve(FdmMgLinearSystem3* system) {
+    Timer timer;
+
+    validateRelaxFunc(*system);
+
+    _precond.build(system, params());
+
+    _lastSolveHitTimeBudget = _pcg.pcg(
+        _workspace.get(), system->A.levels.front(), system->b.levels.front(),
+        _maxNumberOfIterations, _tolerance, &_precond,
+        &system->x.levels.front(), &_lastNumberOfIterations,
+        &_lastResidualNorm, remainingTimeBudget(timer));
+
+    JET_INFO << "Residual after solving MGPCG: " << _lastResidualNorm
+             << " Number of MGPCG iterations: " << _lastNumberOfIterations;
+
+    return !_lastSolveHitTimeBudget &&
+           (_lastResidualNorm <= _tolerance ||
+            _lastNumberOfIterations < _maxNumberOfIterations);
+}
+
+inline const FdmSolverWorkspace3Ptr& FdmMgpcgSolver3::workspace() const {
+    return _workspace;
+}
+
+inline void FdmMgpcgSolver3::setWorkspace(
+    const FdmSolverWorkspace3Ptr& workspace) {
+    _workspace = workspace;
+    if (_workspace != nullptr) {
+        _pcg.clear();
+    }
+}
+
+}  // namespace jet
+
+#endif  // INCLUDE_JET_DETAIL_FDM_MGPCG_SOLVER3_INL_H_
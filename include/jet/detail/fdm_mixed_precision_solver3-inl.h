@@ -0,0 +1,356 @@
+// Copyright (c) 2018 Doyub Kim
+//
+// I am making my contributions/submissions to this project solely in my
+// personal capacity and am not conveying any rights to any intellectual
+// property of any third parties.
+
+#ifndef INCLUDE_JET_DETAIL_FDM_MIXED_PRECISION_SOLVER3_INL_H_
+#define INCLUDE_JET_DETAIL_FDM_MIXED_PRECISION_SOLVER3_INL_H_
+
+#include <jet/cg.h>
+#include <jet/fdm_mixed_precision_solver3.h>
+#include <jet/math_utils.h>
+
+namespace jet {
+
+inline void FdmMixedPrecisionSolver3::Preconditioner::build(
+    const FdmMatrix3F& matrix) {
+    Size3 size = matrix.size();
+    A = &matrix;
+
+    d.resize(size, 0.f);
+    y.resize(size, 0.f);
+
+    matrix.forEachIndex([&](size_t i, size_t j, size_t k) {
+        float denom =
+            matrix(i, j, k).center -
+            ((i > 0) ? square(matrix(i - 1, j, k).right) * d(i - 1, j, k)
+                     : 0.f) -
+            ((j > 0) ? square(matrix(i, j - 1, k).up) * d(i, j - 1, k) : 0.f) -
+            ((k > 0) ? square(matrix(i, j, k - 1).front) * d(i, j, k - 1)
+                     : 0.f);
+
+        if (std::fabs(denom) > 0.f) {
+            d(i, j, k) = 1.f / denom;
+        } else {
+            d(i, j, k) = 0.f;
+        }
+    });
+}
+
+inline void FdmMixedPrecisionSolver3::Preconditioner::solve(
+    const FdmVector3F& b, FdmVector3F* x) {
+    const FdmMatrix3F& a = *A;
+    Size3 size = b.size();
+    ssize_t sx = static_cast<ssize_t>(size.x);
+    ssize_t sy = static_cast<ssize_t>(size.y);
+    ssize_t sz = static_cast<ssize_t>(size.z);
+
+    b.forEachIndex([&](size_t i, size_t j, size_t k) {
+        y(i, j, k) = (b(i, j, k) -
+                      ((i > 0) ? a(i - 1, j, k).right * y(i - 1, j, k) : 0.f) -
+                      ((j > 0) ? a(i, j - 1, k).up * y(i, j - 1, k) : 0.f) -
+                      ((k > 0) ? a(i, j, k - 1).front * y(i, j, k - 1) : 0.f)) *
+                     d(i, j, k);
+    });
+
+    for (ssize_t k = sz - 1; k >= 0; --k) {
+        for (ssize_t j = sy - 1; j >= 0; --j) {
+            for (ssize_t i = sx - 1; i >= 0; --i) {
+                (*x)(i, j, k) =
+                    (y(i, j, k) -
+                     ((i + 1 < sx) ? a(i, j, k).right * (*x)(i + 1, j, k)
+                                   : 0.f) -
+                     ((j + 1 < sy) ? a(i, j, k).up * (*x)(i, j + 1, k) : 0.f) -
+                     ((k + 1 < sz) ? a(i, j, k).front * (*x)(i, j, k + 1)
+                                   : 0.f)) *
+                    d(i, j, k);
+            }
+        }
+    }
+}
+
+inline void FdmMixedPrecisionSolver3::PreconditionerCompressed::build(
+    const MatrixCsrF& matrix) {
+    size_t size = matrix.cols();
+    A = &matrix;
+
+    d.resize(size, 0.f);
+    y.resize(size, 0.f);
+
+    const auto rp = A->rowPointersBegin();
+    const auto ci = A->columnIndicesBegin();
+    const auto nnz = A->nonZeroBegin();
+
+    d.forEachIndex([&](size_t i) {
+        const size_t rowBegin = rp[i];
+        const size_t rowEnd = rp[i + 1];
+
+        float denom = 0.f;
+        for (size_t jj = rowBegin; jj < rowEnd; ++jj) {
+            size_t j = ci[jj];
+
+            if (j == i) {
+                denom += nnz[jj];
+            } else if (j < i) {
+                denom -= square(nnz[jj]) * d[j];
+            }
+        }
+
+        if (std::fabs(denom) > 0.f) {
+            d[i] = 1.f / denom;
+        } else {
+            d[i] = 0.f;
+        }
+    });
+}
+
+inline void FdmMixedPrecisionSolver3::PreconditionerCompressed::solve(
+    const VectorNF& b, VectorNF* x) {
+    const ssize_t size = static_cast<ssize_t>(b.size());
+
+    const auto rp = A->rowPointersBegin();
+    const auto ci = A->columnIndicesBegin();
+    const auto nnz = A->nonZeroBegin();
+
+    b.forEachIndex([&](size_t i) {
+        const size_t rowBegin = rp[i];
+        const size_t rowEnd = rp[i + 1];
+
+        float sum = b[i];
+        for (size_t jj = rowBegin; jj < rowEnd; ++jj) {
+            size_t j = ci[jj];
+
+            if (j < i) {
+                sum -= nnz[jj] * y[j];
+            }
+        }
+
+        y[i] = sum * d[i];
+    });
+
+    for (ssize_t i = size - 1; i >= 0; --i) {
+        const size_t rowBegin = rp[i];
+        const size_t rowEnd = rp[i + 1];
+
+        float sum = y[i];
+        for (size_t jj = rowBegin; jj < rowEnd; ++jj) {
+            ssize_t j = static_cast<ssize_t>(ci[jj]);
+
+            if (j > i) {
+                sum -= nnz[jj] * (*x)[j];
+            }
+        }
+
+        (*x)[i] = sum * d[i];
+    }
+}
+
+inline FdmMixedPrecisionSolver3::FdmMixedPrecisionSolver3(
+    unsigned int maxNumberOfIterations, double tolerance,
+    unsigned int maxNumberOfRefinements, double innerTolerance)
+    : _maxNumberOfIterations(maxNumberOfIterations),
+      _maxNumberOfRefinements(maxNumberOfRefinements),
+      _tolerance(tolerance),
+      _innerTolerance(innerTolerance) {}
+
+inline bool FdmMixedPrecisionSolver3::solve(FdmLinearSystem3* system) {
+    FdmMatrix3& matrix = system->A;
+    FdmVector3& solution = system->x;
+    Timer timer;
+    FdmVector3& rhs = system->b;
+
+    JET_ASSERT(matrix.size() == rhs.size());
+    JET_ASSERT(matrix.size() == solution.size());
+
+    clearCompressedVectors();
+
+    const Size3 size = matrix.size();
+    _aF.resize(size);
+    _rF.resize(size);
+    _eF.resize(size);
+    _r.resize(size);
+    _d.resize(size);
+    _q.resize(size);
+    _s.resize(size);
+    _residual.resize(size);
+
+    // Single-precision copy of the matrix
+    matrix.parallelForEachIndex([&](size_t i, size_t j, size_t k) {
+        const FdmMatrixRow3& row = matrix(i, j, k);
+        FdmMatrixRow3F& rowF = _aF(i, j, k);
+        rowF.center = static_cast<float>(row.center);
+        rowF.right = static_cast<float>(row.right);
+        rowF.up = static_cast<float>(row.up);
+        rowF.front = static_cast<float>(row.front);
+    });
+
+    _precond.build(_aF);
+
+    _lastNumberOfIterations = 0;
+    _lastNumberOfRefinements = 0;
+
+    FdmBlas3::residual(matrix, solution, rhs, &_residual);
+    _lastResidual = FdmBlas3::l2Norm(_residual);
+
+    while (_lastResidual > _tolerance &&
+           _lastNumberOfRefinements < _maxNumberOfRefinements &&
+           remainingTimeBudget(timer) > 0.0) {
+        // Normalize the residual so that the float solve stays well within
+        // the single-precision range.
+        const double scale = 1.0 / _lastResidual;
+        _rF.parallelForEachIndex([&](size_t i, size_t j, size_t k) {
+            _rF(i, j, k) = static_cast<float>(scale * _residual(i, j, k));
+        });
+
+        // Solve A e = r in float
+        _eF.set(0.f);
+        unsigned int numberOfIterations = 0;
+        double innerResidual = 0.0;
+        pcg<FdmBlas3F, Preconditioner>(
+            _aF, _rF, _maxNumberOfIterations, _innerTolerance, &_precond,
+            &_eF, &_r, &_d, &_q, &_s, &numberOfIterations, &innerResidual,
+            remainingTimeBudget(timer));
+
+        _lastNumberOfIterations += numberOfIterations;
+        ++_lastNumberOfRefinements;
+
+        // x = x + e, accumulated in double
+        solution.parallelForEachIndex([&](size_t i, size_t j, size_t k) {
+            solution(i, j, k) += _lastResidual * _eF(i, j, k);
+        });
+
+        const double prevResidual = _lastResidual;
+        FdmBlas3::residual(matrix, solution, rhs, &_residual);
+        _lastResidual = FdmBlas3::l2Norm(_residual);
+
+        // Stagnation; the float solve cannot improve any further.
+        if (numberOfIterations == 0 || _lastResidual >= prevResidual) {
+            break;
+        }
+    }
+
+    _lastSolveHitTimeBudget =
+        _lastResidual > _tolerance && remainingTimeBudget(timer) <= 0.0;
+
+    return _lastResidual <= _tolerance;
+}
+
+inline bool FdmMixedPrecisionSolver3::solveCompressed(
+    FdmCompressedLinearSystem3* system) {
+    MatrixCsrD& matrix = system->A;
+    VectorND& solution = system->x;
+    Timer timer;
+    VectorND& rhs = system->b;
+
+    clearUncompressedVectors();
+
+    const size_t size = solution.size();
+    _rFComp.resize(size);
+    _eFComp.resize(size);
+    _rComp.resize(size);
+    _dComp.resize(size);
+    _qComp.resize(size);
+    _sComp.resize(size);
+    _residualComp.resize(size);
+
+    _aFComp = matrix.castTo<float>();
+    _precondComp.build(_aFComp);
+
+    _lastNumberOfIterations = 0;
+    _lastNumberOfRefinements = 0;
+
+    FdmCompressedBlas3::residual(matrix, solution, rhs, &_residualComp);
+    _lastResidual = FdmCompressedBlas3::l2Norm(_residualComp);
+
+    while (_lastResidual > _tolerance &&
+           _lastNumberOfRefinements < _maxNumberOfRefinements &&
+           remainingTimeBudget(timer) > 0.0) {
+        const double scale = 1.0 / _lastResidual;
+        parallelFor(kZeroSize, size, [&](size_t i) {
+            _rFComp[i] = static_cast<float>(scale * _residualComp[i]);
+        });
+
+        _eFComp.set(0.f);
+        unsigned int numberOfIterations = 0;
+        double innerResidual = 0.0;
+        pcg<FdmCompressedBlas3F, PreconditionerCompressed>(
+            _aFComp, _rFComp, _maxNumberOfIterations, _innerTolerance,
+            &_precondComp, &_eFComp, &_rComp, &_dComp, &_qComp, &_sComp,
+            &numberOfIterations, &innerResidual, remainingTimeBudget(timer));
+
+        _lastNumberOfIterations += numberOfIterations;
+        ++_lastNumberOfRefinements;
+
+        parallelFor(kZeroSize, size, [&](size_t i) {
+            solution[i] += _lastResidual * _eFComp[i];
+        });
+
+        const double prevResidual = _lastResidual;
+        FdmCompressedBlas3::residual(matrix, solution, rhs, &_residualComp);
+        _lastResidual = FdmCompressedBlas3::l2Norm(_residualComp);
+
+        if (numberOfIterations == 0 || _lastResidual >= prevResidual) {
+            break;
+        }
+    }
+
+    _lastSolveHitTimeBudget =
+        _lastResidual > _tolerance && remainingTimeBudget(timer) <= 0.0;
+
+    return _lastResidual <= _tolerance;
+}
+
+inline unsigned int FdmMixedPrecisionSolver3::maxNumberOfIterations() const {
+    return _maxNumberOfIterations;
+}
+
+inline unsigned int FdmMixedPrecisionSolver3::lastNumberOfIterations() const {
+    return _lastNumberOfIterations;
+}
+
+inline unsigned int FdmMixedPrecisionSolver3::maxNumberOfRefinements() const {
+    return _maxNumberOfRefinements;
+}
+
+inline unsigned int FdmMixedPrecisionSolver3::lastNumberOfRefinements() const {
+    return _lastNumberOfRefinements;
+}
+
+inline double FdmMixedPrecisionSolver3::tolerance() const {
+    return _tolerance;
+}
+
+inline double FdmMixedPrecisionSolver3::innerTolerance() const {
+    return _innerTolerance;
+}
+
+inline double FdmMixedPrecisionSolver3::lastResidual() const {
+    return _lastResidual;
+}
+
+inline void FdmMixedPrecisionSolver3::clearUncompressedVectors() {
+    _aF.clear();
+    _rF.clear();
+    _eF.clear();
+    _r.clear();
+    _d.clear();
+    _q.clear();
+    _s.clear();
+    _residual.clear();
+}
+
+inline void FdmMixedPrecisionSolver3::clearCompressedVectors() {
+    _aFComp.clear();
+    _rFComp.clear();
+    _eFComp.clear();
+    _rComp.clear();
+    _dComp.clear();
+    _qComp.clear();
+    _sComp.clear();
+    _residualComp.clear();
+}
+
+}  // namespace jet
+
+#endif  // INCLUDE_JET_DETAIL_FDM_MIXED_PRECISION_SOLVER3_INL_H_
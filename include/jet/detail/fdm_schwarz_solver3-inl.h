@@ -0,0 +1,407 @@
+// Copyright (c) 2018 Doyub Kim
+//
+// I am making my contributions/submissions to this project solely in my
+// personal capacity and am not conveying any rights to any intellectual
+// property of any third parties.
+
+#ifndef INCLUDE_JET_DETAIL_FDM_SCHWARZ_SOLVER3_INL_H_
+#define INCLUDE_JET_DETAIL_FDM_SCHWARZ_SOLVER3_INL_H_
+
+#include <jet/cg.h>
+#include <jet/fdm_schwarz_solver3.h>
+#include <jet/logging.h>
+#include <jet/math_utils.h>
+#include <jet/parallel.h>
+
+#include <algorithm>
+
+namespace jet {
+
+namespace internal {
+
+// Splits [0, n) into at most count contiguous ranges of (nearly) equal size.
+template <typename Subdomain>
+void partitionSchwarzSubdomains(size_t n, size_t count,
+                                std::vector<Subdomain>* subdomains) {
+    count = std::min(count, n);
+    subdomains->resize(count);
+
+    for (size_t s = 0; s < count; ++s) {
+        Subdomain& sub = (*subdomains)[s];
+        sub.begin = n * s / count;
+        sub.end = n * (s + 1) / count;
+        sub.extBegin = sub.begin;
+        sub.extEnd = sub.end;
+    }
+}
+
+// Collects, for each subdomain, the other subdomains whose extended range
+// overlaps its owned range.
+template <typename Subdomain>
+void findSchwarzNeighbors(std::vector<Subdomain>* subdomains) {
+    const size_t count = subdomains->size();
+
+    for (size_t s = 0; s < count; ++s) {
+        Subdomain& sub = (*subdomains)[s];
+        sub.neighbors.clear();
+
+        for (size_t t = 0; t < count; ++t) {
+            const Subdomain& other = (*subdomains)[t];
+            if (t != s && other.extBegin < sub.end &&
+                other.extEnd > sub.begin) {
+                sub.neighbors.push_back(t);
+            }
+        }
+    }
+}
+
+}  // namespace internal
+
+inline void FdmSchwarzSolver3::Preconditioner::build(
+    const FdmMatrix3& matrix, size_t numberOfSubdomains, size_t overlap) {
+    const Size3 size = matrix.size();
+    const size_t plane = size.x * size.y;
+    A = &matrix;
+
+    internal::partitionSchwarzSubdomains(size.z, numberOfSubdomains,
+                                         &subdomains);
+    for (Subdomain& sub : subdomains) {
+        sub.extBegin = (sub.begin > overlap) ? sub.begin - overlap : 0;
+        sub.extEnd = std::min(sub.end + overlap, size.z);
+    }
+    internal::findSchwarzNeighbors(&subdomains);
+
+    parallelFor(kZeroSize, subdomains.size(), [&](size_t s) {
+        Subdomain& sub = subdomains[s];
+        const size_t n = plane * (sub.extEnd - sub.extBegin);
+        sub.d.resize(n);
+        sub.y.resize(n);
+        sub.z.resize(n);
+
+        size_t l = 0;
+        for (size_t k = sub.extBegin; k < sub.extEnd; ++k) {
+            for (size_t j = 0; j < size.y; ++j) {
+                for (size_t i = 0; i < size.x; ++i, ++l) {
+                    double denom =
+                        matrix(i, j, k).center -
+                        ((i > 0) ? square(matrix(i - 1, j, k).right) *
+                                       sub.d[l - 1]
+                                 : 0.0) -
+                        ((j > 0) ? square(matrix(i, j - 1, k).up) *
+                                       sub.d[l - size.x]
+                                 : 0.0) -
+                        ((k > sub.extBegin)
+                             ? square(matrix(i, j, k - 1).front) *
+                                   sub.d[l - plane]
+                             : 0.0);
+
+                    if (std::fabs(denom) > 0.0) {
+                        sub.d[l] = 1.0 / denom;
+                    } else {
+                        sub.d[l] = 0.0;
+                    }
+                }
+            }
+        }
+    });
+}
+
+inline void FdmSchwarzSolver3::Preconditioner::solve(const FdmVector3& b,
+                                                     FdmVector3* x) {
+    const FdmMatrix3& a = *A;
+    const Size3 size = b.size();
+    const size_t plane = size.x * size.y;
+
+    // Local IC(0) solves
+    parallelFor(kZeroSize, subdomains.size(), [&](size_t s) {
+        Subdomain& sub = subdomains[s];
+        const size_t n = sub.d.size();
+
+        size_t l = 0;
+        for (size_t k = sub.extBegin; k < sub.extEnd; ++k) {
+            for (size_t j = 0; j < size.y; ++j) {
+                for (size_t i = 0; i < size.x; ++i, ++l) {
+                    sub.y[l] =
+                        (b(i, j, k) -
+                         ((i > 0) ? a(i - 1, j, k).right * sub.y[l - 1] : 0.0) -
+                         ((j > 0) ? a(i, j - 1, k).up * sub.y[l - size.x]
+                                  : 0.0) -
+                         ((k > sub.extBegin)
+                              ? a(i, j, k - 1).front * sub.y[l - plane]
+                              : 0.0)) *
+                        sub.d[l];
+                }
+            }
+        }
+
+        l = n;
+        for (size_t k = sub.extEnd; k-- > sub.extBegin;) {
+            for (size_t j = size.y; j-- > 0;) {
+                for (size_t i = size.x; i-- > 0;) {
+                    --l;
+                    sub.z[l] =
+                        (sub.y[l] -
+                         ((i + 1 < size.x) ? a(i, j, k).right * sub.z[l + 1]
+                                           : 0.0) -
+                         ((j + 1 < size.y) ? a(i, j, k).up * sub.z[l + size.x]
+                                           : 0.0) -
+                         ((k + 1 < sub.extEnd)
+                              ? a(i, j, k).front * sub.z[l + plane]
+                              : 0.0)) *
+                        sub.d[l];
+                }
+            }
+        }
+    });
+
+    // Sum the local solutions over the overlapping regions
+    parallelFor(kZeroSize, subdomains.size(), [&](size_t s) {
+        const Subdomain& sub = subdomains[s];
+
+        for (size_t k = sub.begin; k < sub.end; ++k) {
+            const double* src = sub.z.data() + plane * (k - sub.extBegin);
+            double* dst = &(*x)(0, 0, k);
+            std::copy(src, src + plane, dst);
+
+            for (size_t t : sub.neighbors) {
+                const Subdomain& other = subdomains[t];
+                if (k >= other.extBegin && k < other.extEnd) {
+                    const double* osrc =
+                        other.z.data() + plane * (k - other.extBegin);
+                    for (size_t l = 0; l < plane; ++l) {
+                        dst[l] += osrc[l];
+                    }
+                }
+            }
+        }
+    });
+}
+
+inline void FdmSchwarzSolver3::PreconditionerCompressed::build(
+    const MatrixCsrD& matrix, size_t numberOfSubdomains, size_t overlap) {
+    const size_t size = matrix.cols();
+    A = &matrix;
+
+    const auto rp = A->rowPointersBegin();
+    const auto ci = A->columnIndicesBegin();
+    const auto nnz = A->nonZeroBegin();
+
+    internal::partitionSchwarzSubdomains(size, numberOfSubdomains,
+                                         &subdomains);
+
+    parallelFor(kZeroSize, subdomains.size(), [&](size_t s) {
+        Subdomain& sub = subdomains[s];
+
+        // Extend the row range by following the matrix graph. The extended
+        // range is kept contiguous so that the local factor is a principal
+        // submatrix.
+        for (size_t o = 0; o < overlap; ++o) {
+            size_t lo = sub.extBegin;
+            size_t hi = sub.extEnd;
+            for (size_t i = sub.extBegin; i < sub.extEnd; ++i) {
+                for (size_t jj = rp[i]; jj < rp[i + 1]; ++jj) {
+                    lo = std::min(lo, ci[jj]);
+                    hi = std::max(hi, ci[jj] + 1);
+                }
+            }
+            sub.extBegin = lo;
+            sub.extEnd = hi;
+        }
+
+        const size_t n = sub.extEnd - sub.extBegin;
+        sub.d.resize(n);
+        sub.y.resize(n);
+        sub.z.resize(n);
+
+        for (size_t i = sub.extBegin; i < sub.extEnd; ++i) {
+            double denom = 0.0;
+            for (size_t jj = rp[i]; jj < rp[i + 1]; ++jj) {
+                size_t j = ci[jj];
+
+                if (j == i) {
+                    denom += nnz[jj];
+                } else if (j < i && j >= sub.extBegin) {
+                    denom -= square(nnz[jj]) * sub.d[j - sub.extBegin];
+                }
+            }
+
+            if (std::fabs(denom) > 0.0) {
+                sub.d[i - sub.extBegin] = 1.0 / denom;
+            } else {
+                sub.d[i - sub.extBegin] = 0.0;
+            }
+        }
+    });
+
+    internal::findSchwarzNeighbors(&subdomains);
+}
+
+inline void FdmSchwarzSolver3::PreconditionerCompressed::solve(
+    const VectorND& b, VectorND* x) {
+    const auto rp = A->rowPointersBegin();
+    const auto ci = A->columnIndicesBegin();
+    const auto nnz = A->nonZeroBegin();
+
+    // Local IC(0) solves
+    parallelFor(kZeroSize, subdomains.size(), [&](size_t s) {
+        Subdomain& sub = subdomains[s];
+        const size_t offset = sub.extBegin;
+
+        for (size_t i = sub.extBegin; i < sub.extEnd; ++i) {
+            double sum = b[i];
+            for (size_t jj = rp[i]; jj < rp[i + 1]; ++jj) {
+                size_t j = ci[jj];
+
+                if (j < i && j >= sub.extBegin) {
+                    sum -= nnz[jj] * sub.y[j - offset];
+                }
+            }
+
+            sub.y[i - offset] = sum * sub.d[i - offset];
+        }
+
+        for (size_t i = sub.extEnd; i-- > sub.extBegin;) {
+            double sum = sub.y[i - offset];
+            for (size_t jj = rp[i]; jj < rp[i + 1]; ++jj) {
+                size_t j = ci[jj];
+
+                if (j > i && j < sub.extEnd) {
+                    sum -= nnz[jj] * sub.z[j - offset];
+                }
+            }
+
+            sub.z[i - offset] = sum * sub.d[i - offset];
+        }
+    });
+
+    // Sum the local solutions over the overlapping regions
+    parallelFor(kZeroSize, subdomains.size(), [&](size_t s) {
+        const Subdomain& sub = subdomains[s];
+
+        for (size_t i = sub.begin; i < sub.end; ++i) {
+            double sum = sub.z[i - sub.extBegin];
+
+            for (size_t t : sub.neighbors) {
+                const Subdomain& other = subdomains[t];
+                if (i >= other.extBegin && i < other.extEnd) {
+                    sum += other.z[i - other.extBegin];
+                }
+            }
+
+            (*x)[i] = sum;
+        }
+    });
+}
+
+inline FdmSchwarzSolver3::FdmSchwarzSolver3(unsigned int maxNumberOfIterations,
+                                            double tolerance,
+                                            size_t numberOfSubdomains,
+                                            size_t overlap)
+    : _maxNumberOfIterations(maxNumberOfIterations),
+      _tolerance(tolerance),
+      _numberOfSubdomains(numberOfSubdomains),
+      _overlap(overlap) {}
+
+inline bool FdmSchwarzSolver3::solve(FdmLinearSystem3* system) {
+    FdmMatrix3& matrix = system->A;
+    FdmVector3& solution = system->x;
+    Timer timer;
+    FdmVector3& rhs = system->b;
+
+    JET_ASSERT(matrix.size() == rhs.size());
+    JET_ASSERT(matrix.size() == solution.size());
+
+    clearCompressedVectors();
+
+    _precond.build(matrix, resolvedNumberOfSubdomains(), _overlap);
+
+    _lastSolveHitTimeBudget = _pcg.pcg(
+        _workspace.get(), matrix, rhs, _maxNumberOfIterations, _tolerance,
+        &_precond, &solution, &_lastNumberOfIterations, &_lastResidualNorm,
+        remainingTimeBudget(timer));
+
+    JET_INFO << "Residual after solving Schwarz-preconditioned CG: "
+             << _lastResidualNorm
+             << " Number of iterations: " << _lastNumberOfIterations;
+
+    return !_lastSolveHitTimeBudget &&
+           (_lastResidualNorm <= _tolerance ||
+            _lastNumberOfIterations < _maxNumberOfIterations);
+}
+
+inline bool FdmSchwarzSolver3::solveCompressed(
+    FdmCompressedLinearSystem3* system) {
+    MatrixCsrD& matrix = system->A;
+    VectorND& solution = system->x;
+    Timer timer;
+    VectorND& rhs = system->b;
+
+    clearUncompressedVectors();
+
+    _precondComp.build(matrix, resolvedNumberOfSubdomains(), _overlap);
+
+    _lastSolveHitTimeBudget = _pcgComp.pcg(
+        _workspace.get(), matrix, rhs, _maxNumberOfIterations, _tolerance,
+        &_precondComp, &solution, &_lastNumberOfIterations,
+        &_lastResidualNorm, remainingTimeBudget(timer));
+
+    JET_INFO << "Residual after solving Schwarz-preconditioned CG: "
+             << _lastResidualNorm
+             << " Number of iterations: " << _lastNumberOfIterations;
+
+    return !_lastSolveHitTimeBudget &&
+           (_lastResidualNorm <= _tolerance ||
+            _lastNumberOfIterations < _maxNumberOfIterations);
+}
+
+inline unsigned int FdmSchwarzSolver3::maxNumberOfIterations() const {
+    return _maxNumberOfIterations;
+}
+
+inline unsigned int FdmSchwarzSolver3::lastNumberOfIterations() const {
+    return _lastNumberOfIterations;
+}
+
+inline double FdmSchwarzSolver3::tolerance() const { return _tolerance; }
+
+inline double FdmSchwarzSolver3::lastResidual() const {
+    return _lastResidualNorm;
+}
+
+inline size_t FdmSchwarzSolver3::numberOfSubdomains() const {
+    return _numberOfSubdomains;
+}
+
+inline size_t FdmSchwarzSolver3::overlap() const { return _overlap; }
+
+inline size_t FdmSchwarzSolver3::resolvedNumberOfSubdomains() const {
+    if (_numberOfSubdomains > 0) {
+        return _numberOfSubdomains;
+    }
+    return std::max(static_cast<size_t>(maxNumberOfThreads()), kOneSize);
+}
+
+inline const FdmSolverWorkspace3Ptr& FdmSchwarzSolver3::workspace() const {
+    return _workspace;
+}
+
+inline void FdmSchwarzSolver3::setWorkspace(
+    const FdmSolverWorkspace3Ptr& workspace) {
+    _workspace = workspace;
+    if (_workspace != nullptr) {
+        clearUncompressedVectors();
+        clearCompressedVectors();
+    }
+}
+
+inline void FdmSchwarzSolver3::clearUncompressedVectors() {
+    _pcg.clear();
+}
+
+inline void FdmSchwarzSolver3::clearCompressedVectors() {
+    _pcgComp.clear();
+}
+
+}  // namespace jet
+
+#endif  // INCLUDE_JET_DETAIL_FDM_SCHWARZ_SOLVER3_INL_H_
@@ -0,0 +1,226 @@
+// Copyright (c) 2018 Doyub Kim
+//
+// I am making my contributions/submissions to this project solely in my
+// personal capacity and am not conveying any rights to any intellectual
+// property of any third parties.
+
+#ifndef INCLUDE_JET_DETAIL_FDM_SOLVER_WORKSPACE3_INL_H_
+#define INCLUDE_JET_DETAIL_FDM_SOLVER_WORKSPACE3_INL_H_
+
+#include <jet/fdm_solver_workspace3.h>
+
+#include <algorithm>
+
+namespace jet {
+
+namespace internal {
+
+inline size_t numberOfElements(const FdmVector3& v) {
+    return v.width() * v.height() * v.depth();
+}
+
+inline size_t numberOfElements(const VectorND& v) { return v.size(); }
+
+inline void resizeScratch(const Size3& size, FdmVector3* v) {
+    if (v->size() != size) {
+        v->resize(size);
+    }
+}
+
+inline void resizeScratch(size_t size, VectorND* v) {
+    if (v->size() != size) {
+        v->resize(size);
+    }
+}
+
+// Picks a free entry, preferring one that already has the requested size so
+// that no reallocation is needed.
+template <typename Entries, typename SizeType, typename VectorType>
+VectorType* borrowScratch(const SizeType& size, Entries* entries) {
+    auto freeEntry = entries->end();
+    for (auto iter = entries->begin(); iter != entries->end(); ++iter) {
+        if (!iter->borrowed) {
+            if (iter->vector->size() == size) {
+                freeEntry = iter;
+                break;
+            }
+            if (freeEntry == entries->end()) {
+                freeEntry = iter;
+            }
+        }
+    }
+
+    if (freeEntry == entries->end()) {
+        entries->emplace_back();
+        freeEntry = entries->end() - 1;
+        freeEntry->vector.reset(new VectorType());
+    }
+
+    freeEntry->borrowed = true;
+    resizeScratch(size, freeEntry->vector.get());
+    return freeEntry->vector.get();
+}
+
+template <typename Entries, typename VectorType>
+void releaseScratch(VectorType* vector, Entries* entries) {
+    auto iter = std::find_if(entries->begin(), entries->end(),
+                             [&](const typename Entries::value_type& e) {
+                                 return e.vector.get() == vector;
+                             });
+
+    JET_THROW_INVALID_ARG_WITH_MESSAGE_IF(
+        iter == entries->end() || !iter->borrowed,
+        "The vector was not borrowed from this workspace.");
+
+    iter->borrowed = false;
+}
+
+inline FdmVector3* borrowFromWorkspace(FdmSolverWorkspace3* workspace,
+                                       const FdmVector3& like) {
+    return workspace->borrow(like.size());
+}
+
+inline VectorND* borrowFromWorkspace(FdmSolverWorkspace3* workspace,
+                                     const VectorND& like) {
+    return workspace->borrowCompressed(like.size());
+}
+
+inline void releaseToWorkspace(FdmSolverWorkspace3* workspace,
+                               FdmVector3* vector) {
+    workspace->release(vector);
+}
+
+inline void releaseToWorkspace(FdmSolverWorkspace3* workspace,
+                               VectorND* vector) {
+    workspace->releaseCompressed(vector);
+}
+
+}  // namespace internal
+
+inline FdmVector3* FdmSolverWorkspace3::borrow(const Size3& size) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return internal::borrowScratch<decltype(_vectors), Size3, FdmVector3>(
+        size, &_vectors);
+}
+
+inline void FdmSolverWorkspace3::release(FdmVector3* vector) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    internal::releaseScratch(vector, &_vectors);
+}
+
+inline VectorND* FdmSolverWorkspace3::borrowCompressed(size_t size) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return internal::borrowScratch<decltype(_compressedVectors), size_t,
+                                   VectorND>(size, &_compressedVectors);
+}
+
+inline void FdmSolverWorkspace3::releaseCompressed(VectorND* vector) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    internal::releaseScratch(vector, &_compressedVectors);
+}
+
+inline void FdmSolverWorkspace3::clear() {
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    auto isFree = [](const Entry<FdmVector3>& e) { return !e.borrowed; };
+    _vectors.erase(std::remove_if(_vectors.begin(), _vectors.end(), isFree),
+                   _vectors.end());
+
+    auto isFreeCompressed = [](const Entry<VectorND>& e) {
+        return !e.borrowed;
+    };
+    _compressedVectors.erase(
+        std::remove_if(_compressedVectors.begin(), _compressedVectors.end(),
+                       isFreeCompressed),
+        _compressedVectors.end());
+}
+
+inline size_t FdmSolverWorkspace3::numberOfVectors() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _vectors.size() + _compressedVectors.size();
+}
+
+inline size_t FdmSolverWorkspace3::numberOfBorrowedVectors() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    size_t count = 0;
+    for (const auto& e : _vectors) {
+        count += e.borrowed ? 1 : 0;
+    }
+    for (const auto& e : _compressedVectors) {
+        count += e.borrowed ? 1 : 0;
+    }
+    return count;
+}
+
+inline size_t FdmSolverWorkspace3::memoryUsage() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    size_t bytes = 0;
+    for (const auto& e : _vectors) {
+        bytes += internal::numberOfElements(*e.vector) * sizeof(double);
+    }
+    for (const auto& e : _compressedVectors) {
+        bytes += internal::numberOfElements(*e.vector) * sizeof(double);
+    }
+    return bytes;
+}
+
+template <typename VectorType>
+FdmScopedScratchVector3<VectorType>::FdmScopedScratchVector3(
+    FdmSolverWorkspace3* workspace, const VectorType& like)
+    : _workspace(workspace),
+      _vector(internal::borrowFromWorkspace(workspace, like)) {}
+
+template <typename VectorType>
+FdmScopedScratchVector3<VectorType>::~FdmScopedScratchVector3() {
+    internal::releaseToWorkspace(_workspace, _vector);
+}
+
+template <typename VectorType>
+VectorType* FdmScopedScratchVector3<VectorType>::get() const {
+    return _vector;
+}
+
+template <typename BlasType>
+template <typename PrecondType>
+bool FdmPcgScratch3<BlasType>::pcg(
+    FdmSolverWorkspace3* workspace, const MatrixType& A, const VectorType& b,
+    unsigned int maxNumberOfIterations, double tolerance, PrecondType* M,
+    VectorType* x, unsigned int* lastNumberOfIterations,
+    double* lastResidualNorm, double maxDurationInSeconds) {
+    if (workspace == nullptr) {
+        _r.resize(b.size());
+        _d.resize(b.size());
+        _q.resize(b.size());
+        _s.resize(b.size());
+
+        return jet::pcg<BlasType, PrecondType>(
+            A, b, maxNumberOfIterations, tolerance, M, x, &_r, &_d, &_q, &_s,
+            lastNumberOfIterations, lastResidualNorm, maxDurationInSeconds);
+    }
+
+    clear();
+
+    FdmScopedScratchVector3<VectorType> r(workspace, b);
+    FdmScopedScratchVector3<VectorType> d(workspace, b);
+    FdmScopedScratchVector3<VectorType> q(workspace, b);
+    FdmScopedScratchVector3<VectorType> s(workspace, b);
+
+    return jet::pcg<BlasType, PrecondType>(
+        A, b, maxNumberOfIterations, tolerance, M, x, r.get(), d.get(),
+        q.get(), s.get(), lastNumberOfIterations, lastResidualNorm,
+        maxDurationInSeconds);
+}
+
+template <typename BlasType>
+void FdmPcgScratch3<BlasType>::clear() {
+    _r.clear();
+    _d.clear();
+    _q.clear();
+    _s.clear();
+}
+
+}  // namespace jet
+
+#endif  // INCLUDE_JET_DETAIL_FDM_SOLVER_WORKSPACE3_INL_H_
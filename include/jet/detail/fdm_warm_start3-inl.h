@@ -0,0 +1,190 @@
+// Copyright (c) 2018 Doyub Kim
+//
+// I am making my contributions/submissions to this project solely in my
+// personal capacity and am not conveying any rights to any intellectual
+// property of any third parties.
+
+#ifndef INCLUDE_JET_DETAIL_FDM_WARM_START3_INL_H_
+#define INCLUDE_JET_DETAIL_FDM_WARM_START3_INL_H_
+
+#include <jet/fdm_warm_start3.h>
+
+namespace jet {
+
+inline FdmWarmStart3::FdmWarmStart3() {}
+
+inline void FdmWarmStart3::clear() {
+    _x.clear();
+    _unknowns.clear();
+    _timeIntervalInSeconds = 0.0;
+    _lastGuessWasWarm = false;
+    _lastNumberOfEnteringCells = 0;
+    _numberOfWarmSolves = 0;
+    _numberOfColdSolves = 0;
+    _totalWarmIterations = 0.0;
+    _totalColdIterations = 0.0;
+}
+
+inline bool FdmWarmStart3::hasSolution(const Size3& resolution) const {
+    return _x.size() == resolution && _timeIntervalInSeconds > 0.0;
+}
+
+inline double FdmWarmStart3::guess(const UnknownFunc& isUnknown, double scale,
+                                   size_t i, size_t j, size_t k,
+                                   bool* isEntering) const {
+    *isEntering = false;
+
+    if (!isUnknown(i, j, k)) {
+        return 0.0;
+    }
+
+    if (_unknowns(i, j, k)) {
+        return scale * _x(i, j, k);
+    }
+
+    // The cell has just entered the unknowns. Take the average of the
+    // neighbors that were solved in the previous step.
+    *isEntering = true;
+
+    const Size3 size = _x.size();
+    double sum = 0.0;
+    int cnt = 0;
+    if (i > 0 && _unknowns(i - 1, j, k)) {
+        sum += _x(i - 1, j, k);
+        ++cnt;
+    }
+    if (i + 1 < size.x && _unknowns(i + 1, j, k)) {
+        sum += _x(i + 1, j, k);
+        ++cnt;
+    }
+    if (j > 0 && _unknowns(i, j - 1, k)) {
+        sum += _x(i, j - 1, k);
+        ++cnt;
+    }
+    if (j + 1 < size.y && _unknowns(i, j + 1, k)) {
+        sum += _x(i, j + 1, k);
+        ++cnt;
+    }
+    if (k > 0 && _unknowns(i, j, k - 1)) {
+        sum += _x(i, j, k - 1);
+        ++cnt;
+    }
+    if (k + 1 < size.z && _unknowns(i, j, k + 1)) {
+        sum += _x(i, j, k + 1);
+        ++cnt;
+    }
+
+    return (cnt > 0) ? scale * sum / cnt : 0.0;
+}
+
+inline bool FdmWarmStart3::initialGuess(const UnknownFunc& isUnknown,
+                                        double timeIntervalInSeconds,
+                                        FdmVector3* x) {
+    _lastNumberOfEnteringCells = 0;
+    _lastGuessWasWarm = hasSolution(x->size());
+
+    if (!_lastGuessWasWarm) {
+        x->set(0.0);
+        return false;
+    }
+
+    const double scale = timeIntervalInSeconds / _timeIntervalInSeconds;
+
+    x->forEachIndex([&](size_t i, size_t j, size_t k) {
+        bool isEntering;
+        (*x)(i, j, k) = guess(isUnknown, scale, i, j, k, &isEntering);
+        if (isEntering) {
+            ++_lastNumberOfEnteringCells;
+        }
+    });
+
+    return true;
+}
+
+inline bool FdmWarmStart3::initialGuessCompressed(const Size3& resolution,
+                                                  const UnknownFunc& isUnknown,
+                                                  double timeIntervalInSeconds,
+                                                  VectorND* x) {
+    _lastNumberOfEnteringCells = 0;
+    _lastGuessWasWarm = hasSolution(resolution);
+
+    if (!_lastGuessWasWarm) {
+        x->set(0.0);
+        return false;
+    }
+
+    const double scale = timeIntervalInSeconds / _timeIntervalInSeconds;
+
+    size_t row = 0;
+    _x.forEachIndex([&](size_t i, size_t j, size_t k) {
+        if (isUnknown(i, j, k)) {
+            JET_ASSERT(row < x->size());
+
+            bool isEntering;
+            (*x)[row] = guess(isUnknown, scale, i, j, k, &isEntering);
+            if (isEntering) {
+                ++_lastNumberOfEnteringCells;
+            }
+            ++row;
+        }
+    });
+
+    return true;
+}
+
+inline void FdmWarmStart3::store(const FdmVector3& x,
+                                 const UnknownFunc& isUnknown,
+                                 double timeIntervalInSeconds) {
+    const Size3 size = x.size();
+    if (_x.size() != size) {
+        _x.resize(size);
+        _unknowns.resize(size);
+    }
+
+    _x.parallelForEachIndex([&](size_t i, size_t j, size_t k) {
+        bool unknown = isUnknown(i, j, k);
+        _unknowns(i, j, k) = unknown ? 1 : 0;
+        _x(i, j, k) = unknown ? x(i, j, k) : 0.0;
+    });
+
+    _timeIntervalInSeconds = timeIntervalInSeconds;
+}
+
+inline void FdmWarmStart3::recordIterations(unsigned int numberOfIterations) {
+    if (_lastGuessWasWarm) {
+        ++_numberOfWarmSolves;
+        _totalWarmIterations += numberOfIterations;
+    } else {
+        ++_numberOfColdSolves;
+        _totalColdIterations += numberOfIterations;
+    }
+}
+
+inline size_t FdmWarmStart3::lastNumberOfEnteringCells() const {
+    return _lastNumberOfEnteringCells;
+}
+
+inline double FdmWarmStart3::averageWarmIterations() const {
+    return (_numberOfWarmSolves > 0)
+               ? _totalWarmIterations / _numberOfWarmSolves
+               : 0.0;
+}
+
+inline double FdmWarmStart3::averageColdIterations() const {
+    return (_numberOfColdSolves > 0)
+               ? _totalColdIterations / _numberOfColdSolves
+               : 0.0;
+}
+
+inline double FdmWarmStart3::iterationSavings() const {
+    double warm = averageWarmIterations();
+    double cold = averageColdIterations();
+    if (_numberOfWarmSolves == 0 || _numberOfColdSolves == 0 || cold <= 0.0) {
+        return 0.0;
+    }
+    return 1.0 - warm / cold;
+}
+
+}  // namespace jet
+
+#endif  // INCLUDE_JET_DETAIL_FDM_WARM_START3_INL_H_
@@ -0,0 +1,267 @@
+// Copyright (c) 2018 Doyub Kim
+//
+// I am making my contributions/submissions to this project solely in my
+// personal capacity and am not conveying any rights to any intellectual
+// property of any third parties.
+
+#ifndef INCLUDE_JET_DETAIL_FLIP_SOLVER3_INL_H_
+#define INCLUDE_JET_DETAIL_FLIP_SOLVER3_INL_H_
+
+#include <jet/array_samplers3.h>
+#include <jet/flip_solver3.h>
+#include <jet/math_utils.h>
+#include <jet/parallel.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+namespace jet {
+
+inline bool FlipSolver3::useNarrowBand() const { return _useNarrowBand; }
+
+inline void FlipSolver3::setUseNarrowBand(bool onoff) {
+    _useNarrowBand = onoff;
+}
+
+inline double FlipSolver3::narrowBandWidth() const {
+    return _narrowBandWidth;
+}
+
+inline void FlipSolver3::setNarrowBandWidth(double widthInCells) {
+    _narrowBandWidth = std::max(widthInCells, 1.0);
+}
+
+inline double FlipSolver3::particleSeedingDepth() const {
+    if (!_useNarrowBand) {
+        return PicSolver3::particleSeedingDepth();
+    }
+
+    const Vector3D h = gridSpacing();
+    return _narrowBandWidth * min3(h.x, h.y, h.z);
+}
+
+inline void FlipSolver3::transferFromParticlesToGrids() {
+    PicSolver3::transferFromParticlesToGrids();
+
+    // Store snapshot
+    auto vel = gridSystemData()->velocity();
+    const auto u = vel->uConstAccessor();
+    const auto v = vel->vConstAccessor();
+    const auto w = vel->wConstAccessor();
+    _uDelta.resize(u.size());
+    _vDelta.resize(v.size());
+    _wDelta.resize(w.size());
+
+    _uDelta.parallelForEachIndex([&](size_t i, size_t j, size_t k) {
+        _uDelta(i, j, k) = static_cast<float>(u(i, j, k));
+    });
+    _vDelta.parallelForEachIndex([&](size_t i, size_t j, size_t k) {
+        _vDelta(i, j, k) = static_cast<float>(v(i, j, k));
+    });
+    _wDelta.parallelForEachIndex([&](size_t i, size_t j, size_t k) {
+        _wDelta(i, j, k) = static_cast<float>(w(i, j, k));
+    });
+}
+
+inline void FlipSolver3::transferFromGridsToParticles() {
+    if (!hasValidParticleStencils()) {
+        updateParticleStencils();
+    }
+
+    auto flow = gridSystemData()->velocity();
+    const auto u = flow->uConstAccessor();
+    const auto v = flow->vConstAccessor();
+    const auto w = flow->wConstAccessor();
+    auto velocities = particleSystemData()->velocities();
+    const size_t numberOfParticles =
+        particleSystemData()->numberOfParticles();
+
+    // Compute delta
+    _uDelta.parallelForEachIndex([&](size_t i, size_t j, size_t k) {
+        _uDelta(i, j, k) = static_cast<float>(u(i, j, k)) - _uDelta(i, j, k);
+    });
+    _vDelta.parallelForEachIndex([&](size_t i, size_t j, size_t k) {
+        _vDelta(i, j, k) = static_cast<float>(v(i, j, k)) - _vDelta(i, j, k);
+    });
+    _wDelta.parallelForEachIndex([&](size_t i, size_t j, size_t k) {
+        _wDelta(i, j, k) = static_cast<float>(w(i, j, k)) - _wDelta(i, j, k);
+    });
+
+    // Transfer delta to the particles
+    const auto uDelta = _uDelta.constAccessor();
+    const auto vDelta = _vDelta.constAccessor();
+    const auto wDelta = _wDelta.constAccessor();
+    parallelFor(kZeroSize, numberOfParticles, [&](size_t i) {
+        Vector3D flipVel =
+            velocities[i] + Vector3D(_uStencils.interpolate(i, uDelta),
+                                     _vStencils.interpolate(i, vDelta),
+                                     _wStencils.interpolate(i, wDelta));
+        if (_picBlendingFactor > 0.0) {
+            const Vector3D picVel(_uStencils.interpolate(i, u),
+                                  _vStencils.interpolate(i, v),
+                                  _wStencils.interpolate(i, w));
+            flipVel = lerp(flipVel, picVel, _picBlendingFactor);
+        }
+        velocities[i] = flipVel;
+    });
+}
+
+inline void FlipSolver3::onBeginAdvanceTimeStep(double timeIntervalInSeconds) {
+    PicSolver3::onBeginAdvanceTimeStep(timeIntervalInSeconds);
+
+    if (_useNarrowBand) {
+        applyNarrowBandInterior();
+        applyBoundaryCondition();
+    }
+}
+
+inline void FlipSolver3::computeAdvection(double timeIntervalInSeconds) {
+    advectNarrowBandInterior(timeIntervalInSeconds);
+    PicSolver3::computeAdvection(timeIntervalInSeconds);
+}
+
+inline void FlipSolver3::moveParticles(double timeIntervalInSeconds) {
+    PicSolver3::moveParticles(timeIntervalInSeconds);
+    updateNarrowBandParticles();
+}
+
+inline void FlipSolver3::advectNarrowBandInterior(
+    double timeIntervalInSeconds) {
+    if (!_useNarrowBand) {
+        return;
+    }
+
+    const auto sdf = signedDistanceField();
+    const auto& vel = gridSystemData()->velocity();
+    const auto boundarySdf = colliderSdf();
+
+    if (_interiorSdf.resolution() != resolution() ||
+        _interiorSdf.gridSpacing() != gridSpacing() ||
+        _interiorSdf.origin() != gridOrigin()) {
+        _interiorSdf.resize(resolution(), gridSpacing(), gridOrigin());
+        _interiorVelocity.resize(resolution(), gridSpacing(), gridOrigin());
+    }
+
+    // Cells inside colliders are not advected and keep the current values.
+    _interiorSdf.parallelForEachDataPointIndex(
+        [&](size_t i, size_t j, size_t k) {
+            _interiorSdf(i, j, k) = (*sdf)(i, j, k);
+        });
+
+    advectionSolver()->advect(*sdf, *vel, timeIntervalInSeconds,
+                              &_interiorSdf, *boundarySdf);
+    advectionSolver()->advect(*vel, *vel, timeIntervalInSeconds,
+                              &_interiorVelocity, *boundarySdf);
+}
+
+inline void FlipSolver3::applyNarrowBandInterior() {
+    if (!_useNarrowBand || _interiorSdf.resolution() != resolution()) {
+        return;
+    }
+
+    const Vector3D h = gridSpacing();
+    const double band = _narrowBandWidth * min3(h.x, h.y, h.z);
+    const Size3 res = resolution();
+
+    auto sdf = signedDistanceField();
+    sdf->parallelForEachDataPointIndex([&](size_t i, size_t j, size_t k) {
+        const double phi = _interiorSdf(i, j, k);
+        if (phi < -band) {
+            (*sdf)(i, j, k) = phi;
+        }
+    });
+
+    // A face is inside the liquid if the mean level set of its two cells is
+    // negative.
+    auto phiAt = [&](size_t i, size_t j, size_t k) {
+        return _interiorSdf(std::min(i, res.x - 1), std::min(j, res.y - 1),
+                            std::min(k, res.z - 1));
+    };
+    auto prev = [](size_t i) { return (i > 0) ? i - 1 : 0; };
+
+    // The FLIP update takes the change from the saved grid velocity, so the
+    // saved values of the merged faces must match as well.
+    auto vel = gridSystemData()->velocity();
+    const bool hasUDelta = _uDelta.size() == vel->uSize();
+    const bool hasVDelta = _vDelta.size() == vel->vSize();
+    const bool hasWDelta = _wDelta.size() == vel->wSize();
+    vel->parallelForEachUIndex([&](size_t i, size_t j, size_t k) {
+        if (_uMarkers(i, j, k) == 0 &&
+            phiAt(prev(i), j, k) + phiAt(i, j, k) < 0.0) {
+            vel->u(i, j, k) = _interiorVelocity.u(i, j, k);
+            _uMarkers(i, j, k) = 1;
+            if (hasUDelta) {
+                _uDelta(i, j, k) = static_cast<float>(vel->u(i, j, k));
+            }
+        }
+    });
+    vel->parallelForEachVIndex([&](size_t i, size_t j, size_t k) {
+        if (_vMarkers(i, j, k) == 0 &&
+            phiAt(i, prev(j), k) + phiAt(i, j, k) < 0.0) {
+            vel->v(i, j, k) = _interiorVelocity.v(i, j, k);
+            _vMarkers(i, j, k) = 1;
+            if (hasVDelta) {
+                _vDelta(i, j, k) = static_cast<float>(vel->v(i, j, k));
+            }
+        }
+    });
+    vel->parallelForEachWIndex([&](size_t i, size_t j, size_t k) {
+        if (_wMarkers(i, j, k) == 0 &&
+            phiAt(i, j, prev(k)) + phiAt(i, j, k) < 0.0) {
+            vel->w(i, j, k) = _interiorVelocity.w(i, j, k);
+            _wMarkers(i, j, k) = 1;
+            if (hasWDelta) {
+                _wDelta(i, j, k) = static_cast<float>(vel->w(i, j, k));
+            }
+        }
+    });
+}
+
+inline void FlipSolver3::updateNarrowBandParticles() {
+    if (!_useNarrowBand || _interiorSdf.resolution() != resolution()) {
+        return;
+    }
+
+    const auto& particles = particleSystemData();
+    const Vector3D h = gridSpacing();
+    const Vector3D origin = gridOrigin();
+    const double band = _narrowBandWidth * min3(h.x, h.y, h.z);
+    const double cellWidth = max3(h.x, h.y, h.z);
+
+    // Remove the particles that drifted into the deep interior.
+    const LinearArraySampler3<double, double> phiSampler(
+        _interiorSdf.constDataAccessor(), h, _interiorSdf.dataOrigin());
+    {
+        const auto positions = particles->positions();
+        Array1<char> shouldRemove(positions.size());
+        parallelFor(kZeroSize, positions.size(), [&](size_t p) {
+            shouldRemove[p] = (phiSampler(positions[p]) < -band) ? 1 : 0;
+        });
+        removeParticles(shouldRemove.constAccessor());
+    }
+
+    // Seed empty cells in the innermost cell layer of the band.
+    Array3<uint32_t> counts;
+    countParticlesPerCell(&counts);
+
+    const auto boundarySdf = colliderSdf();
+    seedParticlesInCells(
+        [&](size_t i, size_t j, size_t k) -> size_t {
+            const double phi = _interiorSdf(i, j, k);
+            if (counts(i, j, k) > 0 || phi < -band ||
+                phi >= -band + cellWidth) {
+                return 0;
+            }
+
+            const Vector3D center =
+                origin + h * Vector3D(i + 0.5, j + 0.5, k + 0.5);
+            return (boundarySdf->sample(center) < 0.0) ? 0 : 8;
+        },
+        _interiorVelocity, static_cast<uint64_t>(currentFrame().index));
+}
+
+}  // namespace jet
+
+#endif  // INCLUDE_JET_DETAIL_FLIP_SOLVER3_INL_H_
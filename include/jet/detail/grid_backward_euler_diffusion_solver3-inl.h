@@ -0,0 +1,223 @@
+// Copyright (c) 2018 Doyub Kim
+//
+// I am making my contributions/submissions to this project solely in my
+// personal capacity and am not conveying any rights to any intellectual
+// property of any third parties.
+
+#ifndef INCLUDE_JET_DETAIL_GRID_BACKWARD_EULER_DIFFUSION_SOLVER3_INL_H_
+#define INCLUDE_JET_DETAIL_GRID_BACKWARD_EULER_DIFFUSION_SOLVER3_INL_H_
+
+#include <jet/cg.h>
+#include <jet/grid_backward_euler_diffusion_solver3.h>
+#include <jet/logging.h>
+#include <jet/parallel.h>
+
+namespace jet {
+
+inline void GridBackwardEulerDiffusionSolver3::solve(
+    const CollocatedVectorGrid3& source,
+    double diffusionCoefficient,
+    double timeIntervalInSeconds,
+    CollocatedVectorGrid3* dest,
+    const ScalarField3& boundarySdf,
+    const ScalarField3& fluidSdf) {
+    auto pos = source.dataPosition();
+    Vector3D h = source.gridSpacing();
+    Vector3D c = timeIntervalInSeconds * diffusionCoefficient / (h * h);
+
+    buildMarkers(source.dataSize(), pos, boundarySdf, fluidSdf);
+    buildMatrix(source.dataSize(), c);
+
+    if (_useBatchedComponentSolve) {
+        solveBatchedComponents(source, c, dest);
+        return;
+    }
+
+    for (size_t component = 0; component < 3; ++component) {
+        buildVectors(source.constDataAccessor(), c, component);
+
+        if (_systemSolver != nullptr) {
+            // Solve the system
+            _systemSolver->solve(&_system);
+
+            // Assign the solution
+            source.parallelForEachDataPointIndex(
+                [&](size_t i, size_t j, size_t k) {
+                    (*dest)(i, j, k)[component] = _system.x(i, j, k);
+                });
+        }
+    }
+}
+
+inline void GridBackwardEulerDiffusionSolver3::solve(
+    const FaceCenteredGrid3& source,
+    double diffusionCoefficient,
+    double timeIntervalInSeconds,
+    FaceCenteredGrid3* dest,
+    const ScalarField3& boundarySdf,
+    const ScalarField3& fluidSdf) {
+    Vector3D h = source.gridSpacing();
+    Vector3D c = timeIntervalInSeconds * diffusionCoefficient / (h * h);
+
+    if (_useBatchedComponentSolve) {
+        solveFaceComponentsConcurrently(source, c, dest, boundarySdf,
+                                        fluidSdf);
+        return;
+    }
+
+    const Size3 sizes[3] = {source.uSize(), source.vSize(), source.wSize()};
+    const FaceCenteredGrid3::DataPositionFunc positions[3] = {
+        source.uPosition(), source.vPosition(), source.wPosition()};
+    const FaceCenteredGrid3::ConstScalarDataAccessor values[3] = {
+        source.uConstAccessor(), source.vConstAccessor(),
+        source.wConstAccessor()};
+    FaceCenteredGrid3::ScalarDataAccessor results[3] = {
+        dest->uAccessor(), dest->vAccessor(), dest->wAccessor()};
+
+    for (size_t component = 0; component < 3; ++component) {
+        buildMarkers(sizes[component], positions[component], boundarySdf,
+                     fluidSdf);
+        buildMatrix(sizes[component], c);
+        buildVectors(values[component], c);
+
+        if (_systemSolver != nullptr) {
+            // Solve the system
+            _systemSolver->solve(&_system);
+
+            // Assign the solution
+            FaceCenteredGrid3::ScalarDataAccessor result = results[component];
+            result.parallelForEachIndex([&](size_t i, size_t j, size_t k) {
+                result(i, j, k) = _system.x(i, j, k);
+            });
+        }
+    }
+}
+
+inline bool GridBackwardEulerDiffusionSolver3::useBatchedComponentSolve()
+    const {
+    return _useBatchedComponentSolve;
+}
+
+inline void GridBackwardEulerDiffusionSolver3::setUseBatchedComponentSolve(
+    bool useBatchedSolve, unsigned int maxNumberOfIterations,
+    double tolerance) {
+    _useBatchedComponentSolve = useBatchedSolve;
+    _batchedMaxNumberOfIterations = maxNumberOfIterations;
+    _batchedTolerance = tolerance;
+
+    // The face component solvers are recreated with the new parameters.
+    for (size_t component = 0; component < 3; ++component) {
+        _faceSolvers[component] = nullptr;
+    }
+
+    if (!_useBatchedComponentSolve) {
+        clearBatchedVectors();
+    }
+}
+
+inline void GridBackwardEulerDiffusionSolver3::solveBatchedComponents(
+    const CollocatedVectorGrid3& source,
+    const Vector3D& c,
+    CollocatedVectorGrid3* dest) {
+    typedef FdmBatchBlas3<3> BatchBlas;
+
+    // The components only differ in their initial guesses and right-hand
+    // sides (Dirichlet boundary terms), so the matrix is built once.
+    for (size_t component = 0; component < 3; ++component) {
+        buildVectors(source.constDataAccessor(), c, component);
+        BatchBlas::setComponent(_system.x, component, &_batchedSystem.x);
+        BatchBlas::setComponent(_system.b, component, &_batchedSystem.b);
+    }
+    _batchedSystem.A.swap(_system.A);
+
+    const Size3 size = _batchedSystem.x.size();
+    _batchedR.resize(size);
+    _batchedD.resize(size);
+    _batchedQ.resize(size);
+    _batchedS.resize(size);
+
+    unsigned int lastNumberOfIterations = 0;
+    BatchBlas::ScalarType lastResidualNorms;
+    batchedCg<BatchBlas>(
+        _batchedSystem.A, _batchedSystem.b, _batchedMaxNumberOfIterations,
+        _batchedTolerance, &_batchedSystem.x, &_batchedR, &_batchedD,
+        &_batchedQ, &_batchedS, &lastNumberOfIterations, &lastResidualNorms);
+
+    JET_INFO << "Residuals after batched diffusion CG: "
+             << lastResidualNorms[0] << ", " << lastResidualNorms[1] << ", "
+             << lastResidualNorms[2]
+             << " Number of iterations: " << lastNumberOfIterations;
+
+    source.parallelForEachDataPointIndex([&](size_t i, size_t j, size_t k) {
+        const Vector<double, 3>& x = _batchedSystem.x(i, j, k);
+        (*dest)(i, j, k) = Vector3D(x[0], x[1], x[2]);
+    });
+}
+
+inline void GridBackwardEulerDiffusionSolver3::solveFaceComponentsConcurrently(
+    const FaceCenteredGrid3& source,
+    const Vector3D& c,
+    FaceCenteredGrid3* dest,
+    const ScalarField3& boundarySdf,
+    const ScalarField3& fluidSdf) {
+    const Size3 sizes[3] = {source.uSize(), source.vSize(), source.wSize()};
+    const FaceCenteredGrid3::DataPositionFunc positions[3] = {
+        source.uPosition(), source.vPosition(), source.wPosition()};
+    const FaceCenteredGrid3::ConstScalarDataAccessor values[3] = {
+        source.uConstAccessor(), source.vConstAccessor(),
+        source.wConstAccessor()};
+    FaceCenteredGrid3::ScalarDataAccessor results[3] = {
+        dest->uAccessor(), dest->vAccessor(), dest->wAccessor()};
+
+    // The builders fill _system, so build the components one by one and
+    // move each into its own system before solving them all at once.
+    for (size_t component = 0; component < 3; ++component) {
+        buildMarkers(sizes[component], positions[component], boundarySdf,
+                     fluidSdf);
+        buildMatrix(sizes[component], c);
+        buildVectors(values[component], c);
+
+        FdmLinearSystem3& system = _faceSystems[component];
+        system.A.swap(_system.A);
+        system.x.swap(_system.x);
+        system.b.swap(_system.b);
+
+        if (_faceSolvers[component] == nullptr) {
+            _faceSolvers[component] = std::make_shared<FdmCgSolver3>(
+                _batchedMaxNumberOfIterations, _batchedTolerance);
+        }
+    }
+
+    parallelFor(kZeroSize, _faceSystems.size(), [&](size_t component) {
+        _faceSolvers[component]->solve(&_faceSystems[component]);
+    });
+
+    JET_INFO << "Residuals after concurrent diffusion CG: "
+             << _faceSolvers[0]->lastResidual() << ", "
+             << _faceSolvers[1]->lastResidual() << ", "
+             << _faceSolvers[2]->lastResidual();
+
+    for (size_t component = 0; component < 3; ++component) {
+        const FdmVector3& x = _faceSystems[component].x;
+        FaceCenteredGrid3::ScalarDataAccessor result = results[component];
+        result.parallelForEachIndex([&](size_t i, size_t j, size_t k) {
+            result(i, j, k) = x(i, j, k);
+        });
+    }
+}
+
+inline void GridBackwardEulerDiffusionSolver3::clearBatchedVectors() {
+    _batchedSystem.clear();
+    _batchedR.clear();
+    _batchedD.clear();
+    _batchedQ.clear();
+    _batchedS.clear();
+    for (size_t component = 0; component < 3; ++component) {
+        _faceSystems[component].clear();
+        _faceSolvers[component] = nullptr;
+    }
+}
+
+}  // namespace jet
+
+#endif  // INCLUDE_JET_DETAIL_GRID_BACKWARD_EULER_DIFFUSION_SOLVER3_INL_H_
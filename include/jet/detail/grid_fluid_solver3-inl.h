@@ -0,0 +1,142 @@
+// Copyright (c) 2018 Doyub Kim
+//
+// I am making my contributions/submissions to this project solely in my
+// personal capacity and am not conveying any rights to any intellectual
+// property of any third parties.
+
+#ifndef INCLUDE_JET_DETAIL_GRID_FLUID_SOLVER3_INL_H_
+#define INCLUDE_JET_DETAIL_GRID_FLUID_SOLVER3_INL_H_
+
+#include <jet/grid_fluid_solver3.h>
+
+#include <algorithm>
+#include <vector>
+
+namespace jet {
+
+inline void GridFluidSolver3::setPressureSolver(
+    const GridPressureSolver3Ptr& newSolver) {
+    _pressureSolver = newSolver;
+    if (_pressureSolver != nullptr) {
+        _boundaryConditionSolver =
+            _pressureSolver->suggestedBoundaryConditionSolver();
+
+        // Apply domain boundary flag
+        _boundaryConditionSolver->setClosedDomainBoundaryFlag(
+            _closedDomainBoundaryFlag);
+    }
+
+    applyPressureSolveMode();
+}
+
+inline void GridFluidSolver3::computeAdvection(double timeIntervalInSeconds) {
+    auto vel = velocity();
+    if (_advectionSolver != nullptr) {
+        const ScalarField3Ptr sdf = colliderSdf();
+
+        // Gather the scalar and collocated fields so that the solver can
+        // advect them together; their inputs are snapshots since the grids
+        // are advected in place.
+        std::vector<ScalarGrid3Ptr> scalarSnapshots;
+        std::vector<const ScalarGrid3*> scalarInputs;
+        std::vector<ScalarGrid3*> scalarOutputs;
+        size_t n = _grids->numberOfAdvectableScalarData();
+        for (size_t i = 0; i < n; ++i) {
+            auto grid = _grids->advectableScalarDataAt(i);
+            scalarSnapshots.push_back(grid->clone());
+            scalarInputs.push_back(scalarSnapshots.back().get());
+            scalarOutputs.push_back(grid.get());
+        }
+
+        std::vector<VectorGrid3Ptr> vectorSnapshots;
+        std::vector<const CollocatedVectorGrid3*> collocatedInputs;
+        std::vector<CollocatedVectorGrid3*> collocatedOutputs;
+        n = _grids->numberOfAdvectableVectorData();
+        size_t velIdx = _grids->velocityIndex();
+        for (size_t i = 0; i < n; ++i) {
+            // Handle velocity layer separately.
+            if (i == velIdx) {
+                continue;
+            }
+
+            auto grid = _grids->advectableVectorDataAt(i);
+            auto grid0 = grid->clone();
+
+            auto collocated =
+                std::dynamic_pointer_cast<CollocatedVectorGrid3>(grid);
+            auto collocated0 =
+                std::dynamic_pointer_cast<CollocatedVectorGrid3>(grid0);
+            if (collocated != nullptr && collocated0 != nullptr) {
+                vectorSnapshots.push_back(grid0);
+                collocatedInputs.push_back(collocated0.get());
+                collocatedOutputs.push_back(collocated.get());
+                continue;
+            }
+
+            // Face-centered fields are not part of the group.
+            auto faceCentered =
+                std::dynamic_pointer_cast<FaceCenteredGrid3>(grid);
+            auto faceCentered0 =
+                std::dynamic_pointer_cast<FaceCenteredGrid3>(grid0);
+            if (faceCentered != nullptr && faceCentered0 != nullptr) {
+                _advectionSolver->advect(*faceCentered0, *vel,
+                                         timeIntervalInSeconds,
+                                         faceCentered.get(), *sdf);
+                extrapolateIntoCollider(faceCentered.get());
+            }
+        }
+
+        _advectionSolver->advectFields(scalarInputs, scalarOutputs,
+                                       collocatedInputs, collocatedOutputs,
+                                       *vel, timeIntervalInSeconds, *sdf);
+
+        for (ScalarGrid3* grid : scalarOutputs) {
+            extrapolateIntoCollider(grid);
+        }
+        for (CollocatedVectorGrid3* grid : collocatedOutputs) {
+            extrapolateIntoCollider(grid);
+        }
+
+        // Solve velocity advection
+        auto vel0 =
+            std::dynamic_pointer_cast<FaceCenteredGrid3>(vel->clone());
+        _advectionSolver->advect(*vel0, *vel0, timeIntervalInSeconds,
+                                 vel.get(), *sdf);
+        applyBoundaryCondition();
+    }
+}
+
+inline bool GridFluidSolver3::usePressureSolveTimeBudget() const {
+    return _usePressureSolveTimeBudget;
+}
+
+inline void GridFluidSolver3::setUsePressureSolveTimeBudget(bool onoff) {
+    _usePressureSolveTimeBudget = onoff;
+    applyPressureSolveMode();
+}
+
+inline double GridFluidSolver3::pressureSolveTimeBudget() const {
+    return _pressureSolveTimeBudget;
+}
+
+inline void GridFluidSolver3::setPressureSolveTimeBudget(double seconds) {
+    _pressureSolveTimeBudget = std::max(seconds, 0.0);
+    applyPressureSolveMode();
+}
+
+inline double GridFluidSolver3::lastPressureResidual() const {
+    return (_pressureSolver != nullptr) ? _pressureSolver->lastResidual() : 0.0;
+}
+
+inline void GridFluidSolver3::applyPressureSolveMode() {
+    if (_pressureSolver == nullptr) {
+        return;
+    }
+
+    _pressureSolver->setTimeBudget(
+        _usePressureSolveTimeBudget ? _pressureSolveTimeBudget : kMaxD);
+}
+
+}  // namespace jet
+
+#endif  // INCLUDE_JET_DETAIL_GRID_FLUID_SOLVER3_INL_H_
@@ -0,0 +1,270 @@
+// Copyright (c) 2018 Doyub Kim
+//
+// I am making my contributions/submissions to this project solely in my
+// personal capacity and am not conveying any rights to any intellectual
+// property of any third parties.
+
+#ifndef INCLUDE_JET_DETAIL_GRID_FRACTIONAL_SINGLE_PHASE_PRESSURE_SOLVER3_INL_H_
+#define INCLUDE_JET_DETAIL_GRID_FRACTIONAL_SINGLE_PHASE_PRESSURE_SOLVER3_INL_H_
+
+#include <jet/fdm_matrix_free3.h>
+#include <jet/grid_fractional_single_phase_pressure_solver3.h>
+#include <jet/level_set_utils.h>
+
+namespace jet {
+
+inline void GridFractionalSinglePhasePressureSolver3::solve(
+    const FaceCenteredGrid3& input, double timeIntervalInSeconds,
+    FaceCenteredGrid3* output, const ScalarField3& boundarySdf,
+    const VectorField3& boundaryVelocity, const ScalarField3& fluidSdf,
+    bool useCompressed) {
+    buildWeights(input, boundarySdf, boundaryVelocity, fluidSdf);
+    buildSystem(input, useCompressed);
+    buildInitialGuess(timeIntervalInSeconds, useCompressed);
+
+    if (_systemSolver != nullptr) {
+        // The linear system solver can be replaced at any time, so the
+        // budget is handed over right before solving.
+        _systemSolver->setTimeBudget(_timeBudget);
+
+        // Solve the system
+        if (_mgSystemSolver == nullptr) {
+            if (useCompressed) {
+                _system.clear();
+                _systemSolver->solveCompressed(&_compSystem);
+                decompressSolution();
+            } else {
+                _compSystem.clear();
+                _systemSolver->solve(&_system);
+            }
+        } else {
+            _mgSystemSolver->solve(&_mgSystem);
+        }
+
+        storeSolution(timeIntervalInSeconds);
+
+        // Apply pressure gradient
+        applyPressureGradient(input, output);
+    }
+}
+
+inline double GridFractionalSinglePhasePressureSolver3::lastResidual() const {
+    return (_systemSolver != nullptr) ? _systemSolver->lastResidual() : 0.0;
+}
+
+inline unsigned int
+GridFractionalSinglePhasePressureSolver3::lastNumberOfIterations() const {
+    return (_systemSolver != nullptr) ? _systemSolver->lastNumberOfIterations()
+                                      : 0;
+}
+
+inline bool GridFractionalSinglePhasePressureSolver3::lastSolveHitTimeBudget()
+    const {
+    return (_systemSolver != nullptr) &&
+           _systemSolver->lastSolveHitTimeBudget();
+}
+
+inline bool GridFractionalSinglePhasePressureSolver3::useWarmStart() const {
+    return _useWarmStart;
+}
+
+inline void GridFractionalSinglePhasePressureSolver3::setUseWarmStart(
+    bool useWarmStart) {
+    _useWarmStart = useWarmStart;
+    if (!_useWarmStart) {
+        _warmStart.clear();
+    }
+}
+
+inline const FdmWarmStart3&
+GridFractionalSinglePhasePressureSolver3::warmStart() const {
+    return _warmStart;
+}
+
+inline void GridFractionalSinglePhasePressureSolver3::buildSystem(
+    const FaceCenteredGrid3& input, bool useCompressed) {
+    const Size3 size = input.resolution();
+    const Vector3D h = input.gridSpacing();
+
+    FdmMatrixFree3 op(_uWeights[0].constAccessor(),
+                      _vWeights[0].constAccessor(),
+                      _wWeights[0].constAccessor(),
+                      _fluidSdf[0].constAccessor(), h);
+
+    if (_mgSystemSolver == nullptr) {
+        if (useCompressed) {
+            buildCompressedMatrix(h);
+            _compSystemBuilder.compress(
+                [&](size_t i, size_t j, size_t k) {
+                    return computeRhs(input, op, i, j, k);
+                },
+                &_compSystem.b);
+            return;
+        }
+
+        _system.resize(size);
+        op.toMatrix(&_system.A);
+        _system.b.parallelForEachIndex([&](size_t i, size_t j, size_t k) {
+            _system.b(i, j, k) = computeRhs(input, op, i, j, k);
+        });
+        return;
+    }
+
+    // Build levels
+    const size_t maxLevels = _mgSystemSolver->params().maxNumberOfLevels;
+    FdmMgUtils3::resizeArrayWithFinest(size, maxLevels, &_mgSystem.A.levels);
+    FdmMgUtils3::resizeArrayWithFinest(size, maxLevels, &_mgSystem.x.levels);
+    FdmMgUtils3::resizeArrayWithFinest(size, maxLevels, &_mgSystem.b.levels);
+
+    const size_t numLevels = _mgSystem.A.levels.size();
+    JET_ASSERT(_fluidSdf.size() == numLevels);
+
+    // The weights move with the fluid every step, so all the levels are
+    // rebuilt.
+    Vector3D levelH = h;
+    for (size_t l = 0; l < numLevels; ++l) {
+        FdmMatrixFree3 levelOp(
+            _uWeights[l].constAccessor(), _vWeights[l].constAccessor(),
+            _wWeights[l].constAccessor(), _fluidSdf[l].constAccessor(),
+            levelH);
+        levelOp.toMatrix(&_mgSystem.A.levels[l]);
+
+        levelH *= 2.0;
+    }
+    ++_mgSystem.matrixVersion;
+
+    // The coarser right-hand sides are restricted residuals of the V-cycle,
+    // so only the finest one is built.
+    FdmVector3& finestB = _mgSystem.b.levels.front();
+    finestB.parallelForEachIndex([&](size_t i, size_t j, size_t k) {
+        finestB(i, j, k) = computeRhs(input, op, i, j, k);
+    });
+}
+
+inline double GridFractionalSinglePhasePressureSolver3::computeRhs(
+    const FaceCenteredGrid3& input, const FdmMatrixFree3& op, size_t i,
+    size_t j, size_t k) const {
+    const Array3<float>& fluidSdf = _fluidSdf[0];
+    if (!isInsideSdf(fluidSdf(i, j, k)) || op.isDecoupled(i, j, k)) {
+        return 0.0;
+    }
+
+    const Array3<float>& uWeights = _uWeights[0];
+    const Array3<float>& vWeights = _vWeights[0];
+    const Array3<float>& wWeights = _wWeights[0];
+    const Size3 size = input.resolution();
+    const Vector3D h = input.gridSpacing();
+    const Vector3D invH = 1.0 / h;
+
+    // Velocity flux through the open fraction of each face. The domain
+    // boundary faces are fully open.
+    const auto flux = [](const Array3<float>& weights, double vel,
+                         bool interior, size_t fi, size_t fj, size_t fk) {
+        return interior ? weights(fi, fj, fk) * vel : vel;
+    };
+
+    double b = 0.0;
+    b += flux(uWeights, input.u(i + 1, j, k), i + 1 < size.x, i + 1, j, k) *
+         invH.x;
+    b -= flux(uWeights, input.u(i, j, k), i > 0, i, j, k) * invH.x;
+    b += flux(vWeights, input.v(i, j + 1, k), j + 1 < size.y, i, j + 1, k) *
+         invH.y;
+    b -= flux(vWeights, input.v(i, j, k), j > 0, i, j, k) * invH.y;
+    b += flux(wWeights, input.w(i, j, k + 1), k + 1 < size.z, i, j, k + 1) *
+         invH.z;
+    b -= flux(wWeights, input.w(i, j, k), k > 0, i, j, k) * invH.z;
+
+    // Accumulate contributions from the moving boundary
+    const Vector3D uOrigin = input.uOrigin();
+    const Vector3D vOrigin = input.vOrigin();
+    const Vector3D wOrigin = input.wOrigin();
+    const auto closedFlux = [&](const Array3<float>& weights,
+                                const Vector3D& origin, size_t axis,
+                                size_t fi, size_t fj, size_t fk) {
+        const Vector3D pt = origin + h * Vector3D(fi, fj, fk);
+        return (1.0 - weights(fi, fj, fk)) * _boundaryVel(pt)[axis];
+    };
+
+    b += closedFlux(uWeights, uOrigin, 0, i + 1, j, k) * invH.x -
+         closedFlux(uWeights, uOrigin, 0, i, j, k) * invH.x +
+         closedFlux(vWeights, vOrigin, 1, i, j + 1, k) * invH.y -
+         closedFlux(vWeights, vOrigin, 1, i, j, k) * invH.y +
+         closedFlux(wWeights, wOrigin, 2, i, j, k + 1) * invH.z -
+         closedFlux(wWeights, wOrigin, 2, i, j, k) * invH.z;
+
+    return b;
+}
+
+inline void GridFractionalSinglePhasePressureSolver3::decompressSolution() {
+    _compSystemBuilder.decompress(_compSystem.x, &_system.x);
+}
+
+inline void GridFractionalSinglePhasePressureSolver3::buildCompressedMatrix(
+    const Vector3D& gridSpacing) {
+    const Array3<float>& fluidSdf = _fluidSdf[0];
+
+    _compSystemBuilder.numberCells(
+        fluidSdf.size(), [&](size_t i, size_t j, size_t k) {
+            return isInsideSdf(fluidSdf(i, j, k));
+        });
+
+    FdmMatrixFree3 op(_uWeights[0].constAccessor(),
+                      _vWeights[0].constAccessor(),
+                      _wWeights[0].constAccessor(), fluidSdf.constAccessor(),
+                      gridSpacing);
+    _compSystemBuilder.buildMatrix(op, &_compSystem.A);
+
+    _compSystem.x.resize(_compSystemBuilder.numberOfRows());
+}
+
+inline void GridFractionalSinglePhasePressureSolver3::buildInitialGuess(
+    double timeIntervalInSeconds, bool useCompressed) {
+    const Array3<float>& fluidSdf = _fluidSdf[0];
+    const auto isUnknown = [&](size_t i, size_t j, size_t k) {
+        return isInsideSdf(fluidSdf(i, j, k));
+    };
+
+    if (_mgSystemSolver != nullptr) {
+        FdmVector3& x = _mgSystem.x.levels.front();
+        if (_useWarmStart) {
+            _warmStart.initialGuess(isUnknown, timeIntervalInSeconds, &x);
+        } else {
+            x.set(0.0);
+        }
+    } else if (useCompressed) {
+        if (_useWarmStart) {
+            _warmStart.initialGuessCompressed(fluidSdf.size(), isUnknown,
+                                              timeIntervalInSeconds,
+                                              &_compSystem.x);
+        } else {
+            _compSystem.x.set(0.0);
+        }
+    } else {
+        if (_useWarmStart) {
+            _warmStart.initialGuess(isUnknown, timeIntervalInSeconds,
+                                    &_system.x);
+        } else {
+            _system.x.set(0.0);
+        }
+    }
+}
+
+inline void GridFractionalSinglePhasePressureSolver3::storeSolution(
+    double timeIntervalInSeconds) {
+    if (!_useWarmStart) {
+        return;
+    }
+
+    const Array3<float>& fluidSdf = _fluidSdf[0];
+    _warmStart.store(
+        pressure(),
+        [&](size_t i, size_t j, size_t k) {
+            return isInsideSdf(fluidSdf(i, j, k));
+        },
+        timeIntervalInSeconds);
+    _warmStart.recordIterations(_systemSolver->lastNumberOfIterations());
+}
+
+}  // namespace jet
+
+#endif  // INCLUDE_JET_DETAIL_GRID_FRACTIONAL_SINGLE_PHASE_PRESSURE_SOLVER3_INL_H_
@@ -0,0 +1,274 @@
+// Copyright (c) 2018 Doyub Kim
+//
+// I am making my contributions/submissions to this project solely in my
+// personal capacity and am not conveying any rights to any intellectual
+// property of any third parties.
+
+#ifndef INCLUDE_JET_DETAIL_GRID_SINGLE_PHASE_PRESSURE_SOLVER3_INL_H_
+#define INCLUDE_JET_DETAIL_GRID_SINGLE_PHASE_PRESSURE_SOLVER3_INL_H_
+
+#include <jet/fdm_matrix_free3.h>
+#include <jet/grid_single_phase_pressure_solver3.h>
+#include <jet/level_set_utils.h>
+
+namespace jet {
+
+inline void GridSinglePhasePressureSolver3::solve(
+    const FaceCenteredGrid3& input, double timeIntervalInSeconds,
+    FaceCenteredGrid3* output, const ScalarField3& boundarySdf,
+    const VectorField3& boundaryVelocity, const ScalarField3& fluidSdf,
+    bool useCompressed) {
+    (void)boundaryVelocity;
+
+    auto pos = input.cellCenterPosition();
+    buildMarkers(input.resolution(), pos, boundarySdf, fluidSdf);
+    buildSystem(input, useCompressed);
+    buildInitialGuess(timeIntervalInSeconds, useCompressed);
+
+    if (_systemSolver != nullptr) {
+        // The linear system solver can be replaced at any time, so the
+        // budget is handed over right before solving.
+        _systemSolver->setTimeBudget(_timeBudget);
+
+        // Solve the system
+        if (_mgSystemSolver == nullptr) {
+            if (useCompressed) {
+                _system.clear();
+                _systemSolver->solveCompressed(&_compSystem);
+                decompressSolution();
+            } else {
+                _compSystem.clear();
+                _systemSolver->solve(&_system);
+            }
+        } else {
+            _mgSystemSolver->solve(&_mgSystem);
+        }
+
+        storeSolution(timeIntervalInSeconds);
+
+        // Apply pressure gradient
+        applyPressureGradient(input, output);
+    }
+}
+
+inline double GridSinglePhasePressureSolver3::lastResidual() const {
+    return (_systemSolver != nullptr) ? _systemSolver->lastResidual() : 0.0;
+}
+
+inline unsigned int GridSinglePhasePressureSolver3::lastNumberOfIterations()
+    const {
+    return (_systemSolver != nullptr) ? _systemSolver->lastNumberOfIterations()
+                                      : 0;
+}
+
+inline bool GridSinglePhasePressureSolver3::lastSolveHitTimeBudget() const {
+    return (_systemSolver != nullptr) &&
+           _systemSolver->lastSolveHitTimeBudget();
+}
+
+inline bool GridSinglePhasePressureSolver3::useWarmStart() const {
+    return _useWarmStart;
+}
+
+inline void GridSinglePhasePressureSolver3::setUseWarmStart(
+    bool useWarmStart) {
+    _useWarmStart = useWarmStart;
+    if (!_useWarmStart) {
+        _warmStart.clear();
+    }
+}
+
+inline const FdmWarmStart3& GridSinglePhasePressureSolver3::warmStart() const {
+    return _warmStart;
+}
+
+inline void GridSinglePhasePressureSolver3::buildMarkers(
+    const Size3& size,
+    const std::function<Vector3D(size_t, size_t, size_t)>& pos,
+    const ScalarField3& boundarySdf, const ScalarField3& fluidSdf) {
+    // Build levels
+    size_t maxLevels = 1;
+    if (_mgSystemSolver != nullptr) {
+        maxLevels = _mgSystemSolver->params().maxNumberOfLevels;
+    }
+    const bool reallocated =
+        FdmMgUtils3::resizeArrayWithFinest(size, maxLevels, &_markers);
+    FdmMgUtils3::resizeArrayWithFinest(size, maxLevels, &_markerChanges);
+
+    // Build top-level markers and record which of them have changed
+    Array3<char>& finest = _markers[0];
+    Array3<char>& finestChanges = _markerChanges[0];
+    finest.parallelForEachIndex([&](size_t i, size_t j, size_t k) {
+        const Vector3D pt = pos(i, j, k);
+        char marker = FdmMatrixFree3::kAir;
+        if (isInsideSdf(boundarySdf.sample(pt))) {
+            marker = FdmMatrixFree3::kBoundary;
+        } else if (isInsideSdf(fluidSdf.sample(pt))) {
+            marker = FdmMatrixFree3::kFluid;
+        }
+
+        finestChanges(i, j, k) =
+            (reallocated || finest(i, j, k) != marker) ? 1 : 0;
+        finest(i, j, k) = marker;
+    });
+
+    // Update sub-level markers under the changed cells only
+    for (size_t l = 1; l < _markers.size(); ++l) {
+        FdmMgUtils3::restrictMarkers(_markers[l - 1], _markerChanges[l - 1],
+                                     &_markers[l], &_markerChanges[l]);
+    }
+}
+
+inline void GridSinglePhasePressureSolver3::buildSystem(
+    const FaceCenteredGrid3& input, bool useCompressed) {
+    const Size3 size = input.resolution();
+    const Vector3D h = input.gridSpacing();
+    const Array3<char>& markers = _markers[0];
+
+    if (_mgSystemSolver == nullptr) {
+        if (useCompressed) {
+            buildCompressedSystem(input);
+            return;
+        }
+
+        _system.resize(size);
+
+        FdmMatrixFree3 op(markers.constAccessor(), h);
+        op.toMatrix(&_system.A);
+
+        _system.b.parallelForEachIndex([&](size_t i, size_t j, size_t k) {
+            _system.b(i, j, k) = (markers(i, j, k) == FdmMatrixFree3::kFluid)
+                                     ? input.divergenceAtCellCenter(i, j, k)
+                                     : 0.0;
+        });
+        return;
+    }
+
+    // Build levels
+    const size_t maxLevels = _mgSystemSolver->params().maxNumberOfLevels;
+    bool rebuildAll = FdmMgUtils3::resizeArrayWithFinest(size, maxLevels,
+                                                         &_mgSystem.A.levels);
+    FdmMgUtils3::resizeArrayWithFinest(size, maxLevels, &_mgSystem.x.levels);
+    FdmMgUtils3::resizeArrayWithFinest(size, maxLevels, &_mgSystem.b.levels);
+    rebuildAll = rebuildAll || h != _mgSystemGridSpacing;
+    _mgSystemGridSpacing = h;
+
+    const size_t numLevels = _mgSystem.A.levels.size();
+    JET_ASSERT(_markers.size() == numLevels);
+    _changedRows.resize(numLevels);
+
+    // A row depends only on the markers around it, so each level rebuilds
+    // the rows next to its changed markers.
+    bool matrixChanged = false;
+    Vector3D levelH = h;
+    for (size_t l = 0; l < numLevels; ++l) {
+        FdmMatrixFree3 op(_markers[l].constAccessor(), levelH);
+        FdmMatrix3& levelA = _mgSystem.A.levels[l];
+
+        if (rebuildAll) {
+            op.toMatrix(&levelA);
+            matrixChanged = true;
+        } else if (FdmMgUtils3::markChangedRows(_markerChanges[l],
+                                                &_changedRows[l]) > 0) {
+            const Array3<char>& changedRows = _changedRows[l];
+            levelA.parallelForEachIndex([&](size_t i, size_t j, size_t k) {
+                if (changedRows(i, j, k)) {
+                    levelA(i, j, k) = op.row(i, j, k);
+                }
+            });
+            matrixChanged = true;
+        }
+
+        levelH *= 2.0;
+    }
+
+    if (matrixChanged) {
+        ++_mgSystem.matrixVersion;
+    }
+
+    // The coarser right-hand sides are restricted residuals of the V-cycle,
+    // so only the finest one is built.
+    FdmVector3& finestB = _mgSystem.b.levels.front();
+    finestB.parallelForEachIndex([&](size_t i, size_t j, size_t k) {
+        finestB(i, j, k) = (markers(i, j, k) == FdmMatrixFree3::kFluid)
+                               ? input.divergenceAtCellCenter(i, j, k)
+                               : 0.0;
+    });
+}
+
+inline void GridSinglePhasePressureSolver3::buildCompressedSystem(
+    const FaceCenteredGrid3& input) {
+    const Array3<char>& markers = _markers[0];
+
+    _compSystemBuilder.numberCells(
+        markers.size(), [&](size_t i, size_t j, size_t k) {
+            return markers(i, j, k) == FdmMatrixFree3::kFluid;
+        });
+
+    FdmMatrixFree3 op(markers.constAccessor(), input.gridSpacing());
+    _compSystemBuilder.buildMatrix(op, &_compSystem.A);
+
+    _compSystemBuilder.compress(
+        [&](size_t i, size_t j, size_t k) {
+            return input.divergenceAtCellCenter(i, j, k);
+        },
+        &_compSystem.b);
+
+    _compSystem.x.resize(_compSystemBuilder.numberOfRows());
+}
+
+inline void GridSinglePhasePressureSolver3::decompressSolution() {
+    _compSystemBuilder.decompress(_compSystem.x, &_system.x);
+}
+
+inline void GridSinglePhasePressureSolver3::buildInitialGuess(
+    double timeIntervalInSeconds, bool useCompressed) {
+    const Array3<char>& markers = _markers[0];
+    const auto isUnknown = [&](size_t i, size_t j, size_t k) {
+        return markers(i, j, k) == FdmMatrixFree3::kFluid;
+    };
+
+    if (_mgSystemSolver != nullptr) {
+        FdmVector3& x = _mgSystem.x.levels.front();
+        if (_useWarmStart) {
+            _warmStart.initialGuess(isUnknown, timeIntervalInSeconds, &x);
+        } else {
+            x.set(0.0);
+        }
+    } else if (useCompressed) {
+        if (_useWarmStart) {
+            _warmStart.initialGuessCompressed(markers.size(), isUnknown,
+                                              timeIntervalInSeconds,
+                                              &_compSystem.x);
+        } else {
+            _compSystem.x.set(0.0);
+        }
+    } else {
+        if (_useWarmStart) {
+            _warmStart.initialGuess(isUnknown, timeIntervalInSeconds,
+                                    &_system.x);
+        } else {
+            _system.x.set(0.0);
+        }
+    }
+}
+
+inline void GridSinglePhasePressureSolver3::storeSolution(
+    double timeIntervalInSeconds) {
+    if (!_useWarmStart) {
+        return;
+    }
+
+    const Array3<char>& markers = _markers[0];
+    _warmStart.store(
+        pressure(),
+        [&](size_t i, size_t j, size_t k) {
+            return markers(i, j, k) == FdmMatrixFree3::kFluid;
+        },
+        timeIntervalInSeconds);
+    _warmStart.recordIterations(_systemSolver->lastNumberOfIterations());
+}
+
+}  // namespace jet
+
+#endif  // INCLUDE_JET_DETAIL_GRID_SINGLE_PHASE_PRESSURE_SOLVER3_INL_H_
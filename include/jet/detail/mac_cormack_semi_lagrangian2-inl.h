@@ -0,0 +1,230 @@
+// Copyright (c) 2018 Doyub Kim
+//
+// I am making my contributions/submissions to this project solely in my
+// personal capacity and am not conveying any rights to any intellectual
+// property of any third parties.
+
+#ifndef INCLUDE_JET_DETAIL_MAC_CORMACK_SEMI_LAGRANGIAN2_INL_H_
+#define INCLUDE_JET_DETAIL_MAC_CORMACK_SEMI_LAGRANGIAN2_INL_H_
+
+#include <jet/array_samplers2.h>
+#include <jet/mac_cormack_semi_lagrangian2.h>
+#include <jet/math_utils.h>
+#include <jet/parallel.h>
+#include <jet/semi_lagrangian2.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace jet {
+
+namespace internal {
+
+// Forward pass: semi-Lagrangian step into forward, together with the range
+// of the input values around each back-traced point.
+template <typename T, typename Flow, typename Sdf>
+void macCormackForward2(const Flow& flow, const Sdf& boundarySdf, double dt,
+                        const SemiLagrangianLayout2& layout,
+                        const ConstArrayAccessor2<T>& input,
+                        ArrayAccessor2<T> forward, ArrayAccessor2<T> minValues,
+                        ArrayAccessor2<T> maxValues) {
+    using std::max;
+    using std::min;
+
+    const double h = std::min(layout.gridSpacing.x, layout.gridSpacing.y);
+    const Size2 n = layout.size;
+    parallelFor(kZeroSize, n.x, kZeroSize, n.y, [&](size_t i, size_t j) {
+        const Vector2D pos =
+            layout.origin + layout.gridSpacing * Vector2D(i, j);
+        if (boundarySdf(pos) > 0.0) {
+            Vector2D pt =
+                semiLagrangianBackTrace(flow, boundarySdf, dt, h, pos);
+            const SemiLagrangianStencil2 s(pt, layout);
+            forward(i, j) = s(input);
+
+            const T& v00 = input(s.i, s.j);
+            const T& v10 = input(s.ip1, s.j);
+            const T& v01 = input(s.i, s.jp1);
+            const T& v11 = input(s.ip1, s.jp1);
+            minValues(i, j) = min(min(v00, v10), min(v01, v11));
+            maxValues(i, j) = max(max(v00, v10), max(v01, v11));
+        } else {
+            forward(i, j) = input(i, j);
+            minValues(i, j) = input(i, j);
+            maxValues(i, j) = input(i, j);
+        }
+    });
+}
+
+// Backward pass: traces forward in time, samples the forward result, and
+// writes the limited MacCormack correction to output.
+template <typename T, typename Flow, typename Sdf>
+void macCormackBackward2(const Flow& flow, const Sdf& boundarySdf, double dt,
+                         const SemiLagrangianLayout2& layout,
+                         MacCormackSemiLagrangian2::Limiter limiter,
+                         const ConstArrayAccessor2<T>& input,
+                         const ConstArrayAccessor2<T>& forward,
+                         const ConstArrayAccessor2<T>& minValues,
+                         const ConstArrayAccessor2<T>& maxValues,
+                         ArrayAccessor2<T> output) {
+    typedef MacCormackSemiLagrangian2::Limiter Limiter;
+
+    // Negating the flow instead of dt keeps the back-tracing loop running.
+    auto reversedFlow = [&](const Vector2D& pt) { return -flow(pt); };
+
+    const double h = std::min(layout.gridSpacing.x, layout.gridSpacing.y);
+    const Size2 n = layout.size;
+    parallelFor(kZeroSize, n.x, kZeroSize, n.y, [&](size_t i, size_t j) {
+        const Vector2D pos =
+            layout.origin + layout.gridSpacing * Vector2D(i, j);
+        if (boundarySdf(pos) > 0.0) {
+            Vector2D pt =
+                semiLagrangianBackTrace(reversedFlow, boundarySdf, dt, h, pos);
+            const SemiLagrangianStencil2 s(pt, layout);
+            const T& phiForward = forward(i, j);
+            T phi = phiForward + 0.5 * (input(i, j) - s(forward));
+
+            if (limiter != Limiter::kNone) {
+                const T clamped = clamp(phi, minValues(i, j), maxValues(i, j));
+                if (limiter == Limiter::kClamp) {
+                    phi = clamped;
+                } else if (clamped != phi) {
+                    phi = phiForward;
+                }
+            }
+
+            output(i, j) = phi;
+        }
+    });
+}
+
+// Plain semi-Lagrangian step for arrays whose input and output layouts
+// differ.
+template <typename T, typename Flow, typename Sdf>
+void macCormackFallback2(const Flow& flow, const Sdf& boundarySdf, double dt,
+                         const ConstArrayAccessor2<T>& input,
+                         const Vector2D& inputOrigin,
+                         const Vector2D& inputGridSpacing,
+                         const SemiLagrangianLayout2& layout,
+                         ArrayAccessor2<T> output) {
+    const double h = std::min(layout.gridSpacing.x, layout.gridSpacing.y);
+    const LinearArraySampler2<T, double> sampler(input, inputGridSpacing,
+                                                 inputOrigin);
+    parallelFor(kZeroSize, layout.size.x, kZeroSize, layout.size.y,
+                [&](size_t i, size_t j) {
+                    const Vector2D idx(i, j);
+                    if (boundarySdf(inputOrigin + inputGridSpacing * idx) >
+                        0.0) {
+                        Vector2D pt = semiLagrangianBackTrace(
+                            flow, boundarySdf, dt, h,
+                            layout.origin + layout.gridSpacing * idx);
+                        output(i, j) = sampler(pt);
+                    }
+                });
+}
+
+}  // namespace internal
+
+template <typename T>
+void MacCormackSemiLagrangian2::Scratch<T>::resize(const Size2& size) {
+    if (forward.size() != size) {
+        forward.resize(size);
+        minValues.resize(size);
+        maxValues.resize(size);
+    }
+}
+
+inline MacCormackSemiLagrangian2::MacCormackSemiLagrangian2(Limiter limiter)
+    : _limiter(limiter) {}
+
+inline MacCormackSemiLagrangian2::Limiter MacCormackSemiLagrangian2::limiter()
+    const {
+    return _limiter;
+}
+
+inline void MacCormackSemiLagrangian2::setLimiter(Limiter limiter) {
+    _limiter = limiter;
+}
+
+inline void MacCormackSemiLagrangian2::advect(const ScalarGrid2& input,
+                                              const VectorField2& flow,
+                                              double dt, ScalarGrid2* output,
+                                              const ScalarField2& boundarySdf) {
+    advectArray(input.constDataAccessor(), input.dataOrigin(),
+                input.gridSpacing(), flow, dt, output->dataAccessor(),
+                output->dataOrigin(), output->gridSpacing(), boundarySdf,
+                &_scalarScratch);
+}
+
+inline void MacCormackSemiLagrangian2::advect(
+    const CollocatedVectorGrid2& input, const VectorField2& flow, double dt,
+    CollocatedVectorGrid2* output, const ScalarField2& boundarySdf) {
+    advectArray(input.constDataAccessor(), input.dataOrigin(),
+                input.gridSpacing(), flow, dt, output->dataAccessor(),
+                output->dataOrigin(), output->gridSpacing(), boundarySdf,
+                &_vectorScratch);
+}
+
+inline void MacCormackSemiLagrangian2::advect(const FaceCenteredGrid2& input,
+                                              const VectorField2& flow,
+                                              double dt,
+                                              FaceCenteredGrid2* output,
+                                              const ScalarField2& boundarySdf) {
+    const Vector2D& hIn = input.gridSpacing();
+    const Vector2D& hOut = output->gridSpacing();
+    advectArray(input.uConstAccessor(), input.uOrigin(), hIn, flow, dt,
+                output->uAccessor(), output->uOrigin(), hOut, boundarySdf,
+                &_faceScratch[0]);
+    advectArray(input.vConstAccessor(), input.vOrigin(), hIn, flow, dt,
+                output->vAccessor(), output->vOrigin(), hOut, boundarySdf,
+                &_faceScratch[1]);
+}
+
+template <typename T>
+void MacCormackSemiLagrangian2::advectArray(
+    const ConstArrayAccessor2<T>& input, const Vector2D& inputOrigin,
+    const Vector2D& inputGridSpacing, const VectorField2& flow, double dt,
+    ArrayAccessor2<T> output, const Vector2D& outputOrigin,
+    const Vector2D& outputGridSpacing,
+    const ScalarField2& boundarySdf, Scratch<T>* scratch) {
+    const internal::SemiLagrangianLayout2 layout{
+        output.size(), outputGridSpacing, outputOrigin};
+    const Limiter limiter = _limiter;
+    const bool sameLayout = input.size() == output.size() &&
+                            inputOrigin == outputOrigin &&
+                            inputGridSpacing == outputGridSpacing;
+
+    if (sameLayout) {
+        scratch->resize(layout.size);
+    }
+
+    auto kernel = [&](const auto& flowSampler, const auto& sdf) {
+        if (!sameLayout) {
+            // The correction needs the input and the output at the same
+            // points, so fall back to a plain semi-Lagrangian step.
+            internal::macCormackFallback2(flowSampler, sdf, dt, input,
+                                          inputOrigin, inputGridSpacing,
+                                          layout, output);
+            return;
+        }
+
+        internal::macCormackForward2(flowSampler, sdf, dt, layout, input,
+                                     scratch->forward.accessor(),
+                                     scratch->minValues.accessor(),
+                                     scratch->maxValues.accessor());
+        internal::macCormackBackward2(
+            flowSampler, sdf, dt, layout, limiter, input,
+            scratch->forward.constAccessor(),
+            scratch->minValues.constAccessor(),
+            scratch->maxValues.constAccessor(), output);
+    };
+
+    if (!internal::dispatchSemiLagrangianLinear2(flow, boundarySdf, kernel)) {
+        kernel([&](const Vector2D& pt) { return flow.sample(pt); },
+               [&](const Vector2D& pt) { return boundarySdf.sample(pt); });
+    }
+}
+
+}  // namespace jet
+
+#endif  // INCLUDE_JET_DETAIL_MAC_CORMACK_SEMI_LAGRANGIAN2_INL_H_
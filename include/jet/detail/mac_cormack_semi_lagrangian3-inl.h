@@ -0,0 +1,223 @@
+// Copyright (c) 2018 Doyub Kim
+//
+// I am making my contributions/submissions to this project solely in my
+// personal capacity and am not conveying any rights to any intellectual
+// property of any third parties.
+
+#ifndef INCLUDE_JET_DETAIL_MAC_CORMACK_SEMI_LAGRANGIAN3_INL_H_
+#define INCLUDE_JET_DETAIL_MAC_CORMACK_SEMI_LAGRANGIAN3_INL_H_
+
+#include <jet/array_samplers3.h>
+#include <jet/mac_cormack_semi_lagrangian3.h>
+#include <jet/math_utils.h>
+#include <jet/parallel.h>
+#include <jet/semi_lagrangian3.h>
+
+#include <algorithm>
+
+namespace jet {
+
+namespace internal {
+
+// Forward pass: semi-Lagrangian step into forward, together with the range
+// of the input values around each back-traced point.
+template <typename T, typename Flow, typename Sdf>
+void macCormackForward3(const Flow& flow, const Sdf& boundarySdf, double dt,
+                        const SemiLagrangianLayout3& layout,
+                        const ConstArrayAccessor3<T>& input,
+                        ArrayAccessor3<T> forward, ArrayAccessor3<T> minValues,
+                        ArrayAccessor3<T> maxValues) {
+    using std::max;
+    using std::min;
+
+    const double h =
+        min3(layout.gridSpacing.x, layout.gridSpacing.y, layout.gridSpacing.z);
+    const Size3 n = layout.size;
+    parallelFor(
+        kZeroSize, n.x, kZeroSize, n.y, kZeroSize, n.z,
+        [&](size_t i, size_t j, size_t k) {
+            const Vector3D pos =
+                layout.origin + layout.gridSpacing * Vector3D(i, j, k);
+            if (boundarySdf(pos) > 0.0) {
+                Vector3D pt =
+                    semiLagrangianBackTrace(flow, boundarySdf, dt, h, pos);
+                const SemiLagrangianStencil3 s(pt, layout);
+                forward(i, j, k) = s(input);
+
+                const T& v000 = input(s.i, s.j, s.k);
+                const T& v100 = input(s.ip1, s.j, s.k);
+                const T& v010 = input(s.i, s.jp1, s.k);
+                const T& v110 = input(s.ip1, s.jp1, s.k);
+                const T& v001 = input(s.i, s.j, s.kp1);
+                const T& v101 = input(s.ip1, s.j, s.kp1);
+                const T& v011 = input(s.i, s.jp1, s.kp1);
+                const T& v111 = input(s.ip1, s.jp1, s.kp1);
+                minValues(i, j, k) =
+                    min(min(min(v000, v100), min(v010, v110)),
+                        min(min(v001, v101), min(v011, v111)));
+                maxValues(i, j, k) =
+                    max(max(max(v000, v100), max(v010, v110)),
+                        max(max(v001, v101), max(v011, v111)));
+            } else {
+                forward(i, j, k) = input(i, j, k);
+                minValues(i, j, k) = input(i, j, k);
+                maxValues(i, j, k) = input(i, j, k);
+            }
+        });
+}
+
+// Backward pass: traces forward in time, samples the forward result, and
+// writes the limited MacCormack correction to output.
+template <typename T, typename Flow, typename Sdf>
+void macCormackBackward3(const Flow& flow, const Sdf& boundarySdf, double dt,
+                         const SemiLagrangianLayout3& layout,
+                         MacCormackSemiLagrangian3::Limiter limiter,
+                         const ConstArrayAccessor3<T>& input,
+                         const ConstArrayAccessor3<T>& forward,
+                         const ConstArrayAccessor3<T>& minValues,
+                         const ConstArrayAccessor3<T>& maxValues,
+                         ArrayAccessor3<T> output) {
+    typedef MacCormackSemiLagrangian3::Limiter Limiter;
+
+    // Negating the flow instead of dt keeps the back-tracing loop running.
+    auto reversedFlow = [&](const Vector3D& pt) { return -flow(pt); };
+
+    const double h =
+        min3(layout.gridSpacing.x, layout.gridSpacing.y, layout.gridSpacing.z);
+    const Size3 n = layout.size;
+    parallelFor(
+        kZeroSize, n.x, kZeroSize, n.y, kZeroSize, n.z,
+        [&](size_t i, size_t j, size_t k) {
+            const Vector3D pos =
+                layout.origin + layout.gridSpacing * Vector3D(i, j, k);
+            if (boundarySdf(pos) > 0.0) {
+                Vector3D pt = semiLagrangianBackTrace(reversedFlow,
+                                                      boundarySdf, dt, h, pos);
+                const SemiLagrangianStencil3 s(pt, layout);
+                const T& phiForward = forward(i, j, k);
+                T phi = phiForward + 0.5 * (input(i, j, k) - s(forward));
+
+                if (limiter != Limiter::kNone) {
+                    const T clamped =
+                        clamp(phi, minValues(i, j, k), maxValues(i, j, k));
+                    if (limiter == Limiter::kClamp) {
+                        phi = clamped;
+                    } else if (clamped != phi) {
+                        phi = phiForward;
+                    }
+                }
+
+                output(i, j, k) = phi;
+            }
+        });
+}
+
+}  // namespace internal
+
+template <typename T>
+void MacCormackSemiLagrangian3::Scratch<T>::resize(const Size3& size) {
+    if (forward.size() != size) {
+        forward.resize(size);
+        minValues.resize(size);
+        maxValues.resize(size);
+    }
+}
+
+inline MacCormackSemiLagrangian3::MacCormackSemiLagrangian3(Limiter limiter)
+    : _limiter(limiter) {}
+
+inline MacCormackSemiLagrangian3::Limiter MacCormackSemiLagrangian3::limiter()
+    const {
+    return _limiter;
+}
+
+inline void MacCormackSemiLagrangian3::setLimiter(Limiter limiter) {
+    _limiter = limiter;
+}
+
+inline void MacCormackSemiLagrangian3::advect(const ScalarGrid3& input,
+                                              const VectorField3& flow,
+                                              double dt, ScalarGrid3* output,
+                                              const ScalarField3& boundarySdf) {
+    advectArray(input.constDataAccessor(), input.dataOrigin(),
+                input.gridSpacing(), flow, dt, output->dataAccessor(),
+                output->dataOrigin(), output->gridSpacing(), boundarySdf,
+                &_scalarScratch);
+}
+
+inline void MacCormackSemiLagrangian3::advect(
+    const CollocatedVectorGrid3& input, const VectorField3& flow, double dt,
+    CollocatedVectorGrid3* output, const ScalarField3& boundarySdf) {
+    advectArray(input.constDataAccessor(), input.dataOrigin(),
+                input.gridSpacing(), flow, dt, output->dataAccessor(),
+                output->dataOrigin(), output->gridSpacing(), boundarySdf,
+                &_vectorScratch);
+}
+
+inline void MacCormackSemiLagrangian3::advect(const FaceCenteredGrid3& input,
+                                              const VectorField3& flow,
+                                              double dt,
+                                              FaceCenteredGrid3* output,
+                                              const ScalarField3& boundarySdf) {
+    const Vector3D& hIn = input.gridSpacing();
+    const Vector3D& hOut = output->gridSpacing();
+    advectArray(input.uConstAccessor(), input.uOrigin(), hIn, flow, dt,
+                output->uAccessor(), output->uOrigin(), hOut, boundarySdf,
+                &_faceScratch[0]);
+    advectArray(input.vConstAccessor(), input.vOrigin(), hIn, flow, dt,
+                output->vAccessor(), output->vOrigin(), hOut, boundarySdf,
+                &_faceScratch[1]);
+    advectArray(input.wConstAccessor(), input.wOrigin(), hIn, flow, dt,
+                output->wAccessor(), output->wOrigin(), hOut, boundarySdf,
+                &_faceScratch[2]);
+}
+
+template <typename T>
+void MacCormackSemiLagrangian3::advectArray(
+    const ConstArrayAccessor3<T>& input, const Vector3D& inputOrigin,
+    const Vector3D& inputGridSpacing, const VectorField3& flow, double dt,
+    ArrayAccessor3<T> output, const Vector3D& outputOrigin,
+    const Vector3D& outputGridSpacing,
+    const ScalarField3& boundarySdf, Scratch<T>* scratch) {
+    const internal::SemiLagrangianLayout3 layout{
+        output.size(), outputGridSpacing, outputOrigin};
+    const Limiter limiter = _limiter;
+    const bool sameLayout = input.size() == output.size() &&
+                            inputOrigin == outputOrigin &&
+                            inputGridSpacing == outputGridSpacing;
+
+    if (sameLayout) {
+        scratch->resize(layout.size);
+    }
+
+    auto kernel = [&](const auto& flowSampler, const auto& sdf) {
+        if (!sameLayout) {
+            // The correction needs the input and the output at the same
+            // points, so fall back to a plain semi-Lagrangian step.
+            internal::SemiLagrangianGroup3 group;
+            group.source = {input.size(), inputGridSpacing, inputOrigin};
+            group.target = layout;
+            group.add(input, output);
+            internal::semiLagrangianAdvectGroup(flowSampler, sdf, dt, &group);
+            return;
+        }
+
+        internal::macCormackForward3(
+            flowSampler, sdf, dt, layout, input, scratch->forward.accessor(),
+            scratch->minValues.accessor(), scratch->maxValues.accessor());
+        internal::macCormackBackward3(
+            flowSampler, sdf, dt, layout, limiter, input,
+            scratch->forward.constAccessor(),
+            scratch->minValues.constAccessor(),
+            scratch->maxValues.constAccessor(), output);
+    };
+
+    if (!internal::dispatchSemiLagrangianLinear3(flow, boundarySdf, kernel)) {
+        kernel([&](const Vector3D& pt) { return flow.sample(pt); },
+               [&](const Vector3D& pt) { return boundarySdf.sample(pt); });
+    }
+}
+
+}  // namespace jet
+
+#endif  // INCLUDE_JET_DETAIL_MAC_CORMACK_SEMI_LAGRANGIAN3_INL_H_
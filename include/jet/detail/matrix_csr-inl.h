@@ -529,6 +529,55 @@ MatrixCsr<T> MatrixCsr<T>::div(const T& s) const {
     return ret;
 }
 
+template <typename T>
+void MatrixCsr<T>::mul(const VectorN<T>& v, VectorN<T>* result) const {
+    JET_ASSERT(cols() == v.size());
+
+    result->resize(rows());
+
+    const T* nnz = _nonZeros.data();
+    const size_t* rp = _rowPointers.data();
+    const size_t* ci = _columnIndices.data();
+    const T* x = v.data();
+    T* y = result->data();
+
+    parallelRangeFor(kZeroSize, rows(), [&](size_t rowBegin, size_t rowEnd) {
+        for (size_t i = rowBegin; i < rowEnd; ++i) {
+            T sum = 0;
+            for (size_t jj = rp[i]; jj < rp[i + 1]; ++jj) {
+                sum += nnz[jj] * x[ci[jj]];
+            }
+            y[i] = sum;
+        }
+    });
+}
+
+template <typename T>
+void MatrixCsr<T>::residual(const VectorN<T>& x, const VectorN<T>& b,
+                            VectorN<T>* result) const {
+    JET_ASSERT(cols() == x.size());
+    JET_ASSERT(rows() == b.size());
+
+    result->resize(rows());
+
+    const T* nnz = _nonZeros.data();
+    const size_t* rp = _rowPointers.data();
+    const size_t* ci = _columnIndices.data();
+    const T* xData = x.data();
+    const T* bData = b.data();
+    T* r = result->data();
+
+    parallelRangeFor(kZeroSize, rows(), [&](size_t rowBegin, size_t rowEnd) {
+        for (size_t i = rowBegin; i < rowEnd; ++i) {
+            T sum = 0;
+            for (size_t jj = rp[i]; jj < rp[i + 1]; ++jj) {
+                sum += nnz[jj] * xData[ci[jj]];
+            }
+            r[i] = bData[i] - sum;
+        }
+    });
+}
+
 template <typename T>
 MatrixCsr<T> MatrixCsr<T>::radd(const T& s) const {
     return add(s);
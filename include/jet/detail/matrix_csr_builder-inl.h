@@ -0,0 +1,248 @@
+// Copyright (c) 2018 Doyub Kim
+//
+// I am making my contributions/submissions to this project solely in my
+// personal capacity and am not conveying any rights to any intellectual
+// property of any third parties.
+
+#ifndef INCLUDE_JET_DETAIL_MATRIX_CSR_BUILDER_INL_H_
+#define INCLUDE_JET_DETAIL_MATRIX_CSR_BUILDER_INL_H_
+
+#include <jet/matrix_csr_builder.h>
+#include <jet/parallel.h>
+
+#include <algorithm>
+#include <numeric>
+
+namespace jet {
+
+template <typename T>
+MatrixCsrBuilder<T>::MatrixCsrBuilder() {}
+
+template <typename T>
+MatrixCsrBuilder<T>::MatrixCsrBuilder(size_t rows, size_t cols,
+                                      size_t numberOfPartitions) {
+    reset(rows, cols, numberOfPartitions);
+}
+
+template <typename T>
+void MatrixCsrBuilder<T>::reset(size_t rows, size_t cols,
+                                size_t numberOfPartitions) {
+    if (_size != Size2(rows, cols)) {
+        clear();
+    }
+
+    _size = Size2(rows, cols);
+    _partitions.resize(std::max(numberOfPartitions, kOneSize));
+    clearElements();
+}
+
+template <typename T>
+void MatrixCsrBuilder<T>::clearElements() {
+    for (auto& p : _partitions) {
+        p.clear();
+    }
+}
+
+template <typename T>
+void MatrixCsrBuilder<T>::clear() {
+    _size = Size2();
+    _partitions.clear();
+    _lastBuildReusedPattern = false;
+    _elements.clear();
+    _order.clear();
+    _segmentPointers.clear();
+    _rowPointers.clear();
+    _columnIndices.clear();
+}
+
+template <typename T>
+Size2 MatrixCsrBuilder<T>::size() const {
+    return _size;
+}
+
+template <typename T>
+size_t MatrixCsrBuilder<T>::numberOfPartitions() const {
+    return _partitions.size();
+}
+
+template <typename T>
+size_t MatrixCsrBuilder<T>::numberOfElements() const {
+    size_t n = 0;
+    for (const auto& p : _partitions) {
+        n += p.size();
+    }
+    return n;
+}
+
+template <typename T>
+void MatrixCsrBuilder<T>::addElement(size_t partition, size_t i, size_t j,
+                                     const T& value) {
+    JET_ASSERT(partition < _partitions.size());
+    JET_ASSERT(i < _size.x && j < _size.y);
+
+    _partitions[partition].emplace_back(i, j, value);
+}
+
+template <typename T>
+typename MatrixCsrBuilder<T>::ElementContainerType&
+MatrixCsrBuilder<T>::partition(size_t partition) {
+    return _partitions[partition];
+}
+
+template <typename T>
+const typename MatrixCsrBuilder<T>::ElementContainerType&
+MatrixCsrBuilder<T>::partition(size_t partition) const {
+    return _partitions[partition];
+}
+
+template <typename T>
+void MatrixCsrBuilder<T>::build(MatrixCsr<T>* matrix) {
+    bool isSamePattern;
+    gatherElements(&isSamePattern);
+
+    _lastBuildReusedPattern = isSamePattern;
+    if (!isSamePattern) {
+        buildPattern();
+    }
+
+    writeMatrix(matrix);
+}
+
+template <typename T>
+bool MatrixCsrBuilder<T>::lastBuildReusedPattern() const {
+    return _lastBuildReusedPattern;
+}
+
+template <typename T>
+void MatrixCsrBuilder<T>::gatherElements(bool* isSamePattern) {
+    const size_t numPartitions = _partitions.size();
+
+    std::vector<size_t> counts(numPartitions);
+    for (size_t p = 0; p < numPartitions; ++p) {
+        counts[p] = _partitions[p].size();
+    }
+
+    std::vector<size_t> offsets;
+    const size_t n = parallelExclusiveScan(counts, &offsets);
+
+    // The pattern can be reused only if the (i, j) sequence is identical.
+    // Compare while gathering and record the mismatches per partition.
+    const bool hasPattern = !_order.empty() && _elements.size() == n;
+    if (!hasPattern) {
+        _elements.resize(n);
+    }
+
+    std::vector<char> mismatch(numPartitions, 0);
+    parallelFor(kZeroSize, numPartitions, [&](size_t p) {
+        const auto& src = _partitions[p];
+        Element* dst = _elements.data() + offsets[p];
+        bool same = hasPattern;
+        for (size_t e = 0; e < src.size(); ++e) {
+            same = same && dst[e].i == src[e].i && dst[e].j == src[e].j;
+            dst[e] = src[e];
+        }
+        mismatch[p] = same ? 0 : 1;
+    });
+
+    *isSamePattern =
+        hasPattern && std::none_of(mismatch.begin(), mismatch.end(),
+                                   [](char c) { return c != 0; });
+}
+
+template <typename T>
+void MatrixCsrBuilder<T>::buildPattern() {
+    const size_t n = _elements.size();
+
+    // Sort triplet indices by (i, j). Ties are broken by the triplet index so
+    // that duplicates are always summed in the same order.
+    _order.resize(n);
+    std::iota(_order.begin(), _order.end(), kZeroSize);
+    const Element* elements = _elements.data();
+    parallelSort(_order.begin(), _order.end(), [elements](size_t a, size_t b) {
+        const Element& ea = elements[a];
+        const Element& eb = elements[b];
+        if (ea.i != eb.i) {
+            return ea.i < eb.i;
+        }
+        if (ea.j != eb.j) {
+            return ea.j < eb.j;
+        }
+        return a < b;
+    });
+
+    // Mark the first triplet of each unique (i, j) and scan to get the
+    // non-zero index of each segment.
+    std::vector<size_t> heads(n);
+    parallelFor(kZeroSize, n, [&](size_t k) {
+        if (k == 0) {
+            heads[k] = 1;
+        } else {
+            const Element& prev = elements[_order[k - 1]];
+            const Element& curr = elements[_order[k]];
+            heads[k] = (prev.i != curr.i || prev.j != curr.j) ? 1 : 0;
+        }
+    });
+
+    std::vector<size_t> nonZeroIndices;
+    const size_t numNonZeros =
+        parallelExclusiveScan(heads, &nonZeroIndices);
+
+    _segmentPointers.resize(numNonZeros + 1);
+    _columnIndices.resize(numNonZeros);
+    _segmentPointers[numNonZeros] = n;
+    parallelFor(kZeroSize, n, [&](size_t k) {
+        if (heads[k]) {
+            const size_t nz = nonZeroIndices[k];
+            _segmentPointers[nz] = k;
+            _columnIndices[nz] = elements[_order[k]].j;
+        }
+    });
+
+    // Row pointers: each non-zero that starts a new row fills the pointers of
+    // the rows between the previous non-zero's row and its own.
+    _rowPointers.resize(_size.x + 1);
+    parallelFor(kZeroSize, numNonZeros + 1, [&](size_t nz) {
+        const size_t rowEnd =
+            (nz < numNonZeros) ? elements[_order[_segmentPointers[nz]]].i + 1
+                               : _size.x + 1;
+        const size_t rowBegin =
+            (nz > 0) ? elements[_order[_segmentPointers[nz - 1]]].i + 1 : 0;
+        for (size_t row = rowBegin; row < rowEnd; ++row) {
+            _rowPointers[row] = nz;
+        }
+    });
+}
+
+template <typename T>
+void MatrixCsrBuilder<T>::writeMatrix(MatrixCsr<T>* matrix) const {
+    const size_t numNonZeros = _columnIndices.size();
+
+    const bool isSameStructure =
+        _lastBuildReusedPattern && matrix->size() == _size &&
+        matrix->numberOfNonZeros() == numNonZeros;
+
+    if (!isSameStructure) {
+        matrix->reserve(_size.x, _size.y, numNonZeros);
+
+        auto ci = matrix->columnIndicesBegin();
+        auto rp = matrix->rowPointersBegin();
+        parallelFor(kZeroSize, numNonZeros,
+                    [&](size_t nz) { ci[nz] = _columnIndices[nz]; });
+        parallelFor(kZeroSize, _rowPointers.size(),
+                    [&](size_t row) { rp[row] = _rowPointers[row]; });
+    }
+
+    auto nnz = matrix->nonZeroBegin();
+    parallelFor(kZeroSize, numNonZeros, [&](size_t nz) {
+        T sum = 0;
+        for (size_t k = _segmentPointers[nz]; k < _segmentPointers[nz + 1];
+             ++k) {
+            sum += _elements[_order[k]].value;
+        }
+        nnz[nz] = sum;
+    });
+}
+
+}  // namespace jet
+
+#endif  // INCLUDE_JET_DETAIL_MATRIX_CSR_BUILDER_INL_H_
@@ -0,0 +1,191 @@
+// Copyright (c) 2018 Doyub Kim
+//
+// I am making my contributions/submissions to this project solely in my
+// personal capacity and am not conveying any rights to any intellectual
+// property of any third parties.
+
+#ifndef INCLUDE_JET_DETAIL_MATRIX_SELL_INL_H_
+#define INCLUDE_JET_DETAIL_MATRIX_SELL_INL_H_
+
+#include <jet/matrix_sell.h>
+#include <jet/parallel.h>
+
+#include <algorithm>
+#include <limits>
+#include <numeric>
+
+namespace jet {
+
+template <typename T, size_t C>
+MatrixSell<T, C>::MatrixSell() {
+    clear();
+}
+
+template <typename T, size_t C>
+MatrixSell<T, C>::MatrixSell(const MatrixCsr<T>& csr, size_t sigma) {
+    set(csr, sigma);
+}
+
+template <typename T, size_t C>
+void MatrixSell<T, C>::clear() {
+    _size = {0, 0};
+    _numberOfNonZeros = 0;
+    _values.clear();
+    _columnIndices.clear();
+    _chunkPointers.clear();
+    _rowPermutation.clear();
+    _csrToSell.clear();
+    _chunkPointers.push_back(0);
+}
+
+template <typename T, size_t C>
+void MatrixSell<T, C>::set(const MatrixCsr<T>& csr, size_t sigma) {
+    JET_THROW_INVALID_ARG_WITH_MESSAGE_IF(
+        csr.cols() > std::numeric_limits<uint32_t>::max(),
+        "Number of columns exceeds the 32-bit column index range.");
+
+    const size_t numRows = csr.rows();
+    const size_t numChunks = (numRows + C - 1) / C;
+    const size_t* rp = csr.rowPointersData();
+    const size_t* ci = csr.columnIndicesData();
+
+    _size = csr.size();
+    _numberOfNonZeros = csr.numberOfNonZeros();
+
+    // Sort rows by descending length within each sigma window
+    sigma = std::max(C, ((sigma + C - 1) / C) * C);
+    _rowPermutation.resize(numRows);
+    std::iota(_rowPermutation.begin(), _rowPermutation.end(), kZeroSize);
+
+    const size_t numWindows = (numRows + sigma - 1) / sigma;
+    parallelFor(kZeroSize, numWindows, [&](size_t w) {
+        auto begin = _rowPermutation.begin() + w * sigma;
+        auto end = _rowPermutation.begin() + std::min((w + 1) * sigma, numRows);
+        std::stable_sort(begin, end, [&](size_t a, size_t b) {
+            return rp[a + 1] - rp[a] > rp[b + 1] - rp[b];
+        });
+    });
+
+    // Chunk widths and offsets
+    _chunkPointers.resize(numChunks + 1);
+    _chunkPointers[0] = 0;
+    for (size_t c = 0; c < numChunks; ++c) {
+        size_t width = 0;
+        for (size_t r = c * C; r < std::min((c + 1) * C, numRows); ++r) {
+            size_t row = _rowPermutation[r];
+            width = std::max(width, rp[row + 1] - rp[row]);
+        }
+        _chunkPointers[c + 1] = _chunkPointers[c] + width * C;
+    }
+
+    // Fill column-major chunks. Padded entries have zero value and point to
+    // the first column so that the kernel can run without branches.
+    _values.assign(_chunkPointers[numChunks], T(0));
+    _columnIndices.assign(_chunkPointers[numChunks], 0);
+    _csrToSell.resize(_numberOfNonZeros);
+
+    parallelFor(kZeroSize, numChunks, [&](size_t c) {
+        const size_t offset = _chunkPointers[c];
+        for (size_t r = 0; r < C && c * C + r < numRows; ++r) {
+            const size_t row = _rowPermutation[c * C + r];
+            for (size_t jj = rp[row]; jj < rp[row + 1]; ++jj) {
+                const size_t k = jj - rp[row];
+                const size_t idx = offset + k * C + r;
+                _values[idx] = csr.nonZero(jj);
+                _columnIndices[idx] = static_cast<uint32_t>(ci[jj]);
+                _csrToSell[jj] = idx;
+            }
+        }
+    });
+}
+
+template <typename T, size_t C>
+void MatrixSell<T, C>::updateValues(const MatrixCsr<T>& csr) {
+    JET_THROW_INVALID_ARG_IF(csr.size() != _size);
+    JET_THROW_INVALID_ARG_IF(csr.numberOfNonZeros() != _numberOfNonZeros);
+
+    const T* nnz = csr.nonZeroData();
+    parallelFor(kZeroSize, _numberOfNonZeros,
+                [&](size_t jj) { _values[_csrToSell[jj]] = nnz[jj]; });
+}
+
+template <typename T, size_t C>
+Size2 MatrixSell<T, C>::size() const {
+    return _size;
+}
+
+template <typename T, size_t C>
+size_t MatrixSell<T, C>::rows() const {
+    return _size.x;
+}
+
+template <typename T, size_t C>
+size_t MatrixSell<T, C>::cols() const {
+    return _size.y;
+}
+
+template <typename T, size_t C>
+size_t MatrixSell<T, C>::numberOfNonZeros() const {
+    return _numberOfNonZeros;
+}
+
+template <typename T, size_t C>
+size_t MatrixSell<T, C>::numberOfStoredElements() const {
+    return _values.size();
+}
+
+template <typename T, size_t C>
+template <typename Callback>
+void MatrixSell<T, C>::forEachChunkRow(const VectorN<T>& x,
+                                       const Callback& func) const {
+    JET_ASSERT(cols() == x.size());
+
+    const size_t numRows = rows();
+    const size_t numChunks = _chunkPointers.size() - 1;
+    const T* xData = x.data();
+
+    parallelRangeFor(kZeroSize, numChunks, [&](size_t cBegin, size_t cEnd) {
+        for (size_t c = cBegin; c < cEnd; ++c) {
+            const size_t offset = _chunkPointers[c];
+            const size_t width = (_chunkPointers[c + 1] - offset) / C;
+            const T* val = _values.data() + offset;
+            const uint32_t* col = _columnIndices.data() + offset;
+
+            T sum[C] = {};
+            for (size_t k = 0; k < width; ++k) {
+                for (size_t r = 0; r < C; ++r) {
+                    sum[r] += val[r] * xData[col[r]];
+                }
+                val += C;
+                col += C;
+            }
+
+            const size_t rEnd = std::min(C, numRows - c * C);
+            for (size_t r = 0; r < rEnd; ++r) {
+                func(_rowPermutation[c * C + r], sum[r]);
+            }
+        }
+    });
+}
+
+template <typename T, size_t C>
+void MatrixSell<T, C>::mul(const VectorN<T>& v, VectorN<T>* result) const {
+    result->resize(rows());
+    T* y = result->data();
+    forEachChunkRow(v, [&](size_t i, T sum) { y[i] = sum; });
+}
+
+template <typename T, size_t C>
+void MatrixSell<T, C>::residual(const VectorN<T>& x, const VectorN<T>& b,
+                                VectorN<T>* result) const {
+    JET_ASSERT(rows() == b.size());
+
+    result->resize(rows());
+    const T* bData = b.data();
+    T* r = result->data();
+    forEachChunkRow(x, [&](size_t i, T sum) { r[i] = bData[i] - sum; });
+}
+
+}  // namespace jet
+
+#endif  // INCLUDE_JET_DETAIL_MATRIX_SELL_INL_H_
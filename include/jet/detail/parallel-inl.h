@@ -476,6 +476,41 @@ void parallelSort(RandomIterator begin, RandomIterator end,
         policy);
 }
 
+inline size_t parallelExclusiveScan(const std::vector<size_t>& input,
+                                    std::vector<size_t>* output,
+                                    ExecutionPolicy policy) {
+    static const size_t kBlockSize = 1 << 14;
+
+    const size_t n = input.size();
+    const size_t numBlocks = (n + kBlockSize - 1) / kBlockSize;
+    output->resize(n);
+
+    std::vector<size_t> blockSums(numBlocks + 1, 0);
+    parallelFor(kZeroSize, numBlocks, [&](size_t b) {
+        const size_t end = std::min((b + 1) * kBlockSize, n);
+        size_t sum = 0;
+        for (size_t i = b * kBlockSize; i < end; ++i) {
+            sum += input[i];
+        }
+        blockSums[b + 1] = sum;
+    }, policy);
+
+    for (size_t b = 0; b < numBlocks; ++b) {
+        blockSums[b + 1] += blockSums[b];
+    }
+
+    parallelFor(kZeroSize, numBlocks, [&](size_t b) {
+        const size_t end = std::min((b + 1) * kBlockSize, n);
+        size_t sum = blockSums[b];
+        for (size_t i = b * kBlockSize; i < end; ++i) {
+            (*output)[i] = sum;
+            sum += input[i];
+        }
+    }, policy);
+
+    return blockSums[numBlocks];
+}
+
 }  // namespace jet
 
 #endif  // INCLUDE_JET_DETAIL_PARALLEL_INL_H_
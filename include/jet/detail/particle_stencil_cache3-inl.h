@@ -0,0 +1,166 @@
+// Copyright (c) 2018 Doyub Kim
+//
+// I am making my contributions/submissions to this project solely in my
+// personal capacity and am not conveying any rights to any intellectual
+// property of any third parties.
+
+#ifndef INCLUDE_JET_DETAIL_PARTICLE_STENCIL_CACHE3_INL_H_
+#define INCLUDE_JET_DETAIL_PARTICLE_STENCIL_CACHE3_INL_H_
+
+#include <jet/macros.h>
+#include <jet/math_utils.h>
+#include <jet/parallel.h>
+#include <jet/particle_stencil_cache3.h>
+
+#include <algorithm>
+
+namespace jet {
+
+inline void ParticleStencilCache3::build(
+    const ConstArrayAccessor1<Vector3D>& positions, const Size3& dataSize,
+    const Vector3D& gridSpacing, const Vector3D& dataOrigin) {
+    JET_ASSERT(gridSpacing.x > 0.0 && gridSpacing.y > 0.0 &&
+               gridSpacing.z > 0.0);
+
+    _dataSize = dataSize;
+    _gridSpacing = gridSpacing;
+    _dataOrigin = dataOrigin;
+    if (_stencils.size() != positions.size()) {
+        _stencils.resize(positions.size());
+    }
+
+    const ssize_t iSize = static_cast<ssize_t>(dataSize.x);
+    const ssize_t jSize = static_cast<ssize_t>(dataSize.y);
+    const ssize_t kSize = static_cast<ssize_t>(dataSize.z);
+
+    parallelFor(kZeroSize, positions.size(), [&](size_t p) {
+        ssize_t i, j, k;
+        double fx, fy, fz;
+
+        const Vector3D normalizedX = (positions[p] - dataOrigin) / gridSpacing;
+        getBarycentric(normalizedX.x, 0, iSize - 1, &i, &fx);
+        getBarycentric(normalizedX.y, 0, jSize - 1, &j, &fy);
+        getBarycentric(normalizedX.z, 0, kSize - 1, &k, &fz);
+
+        Stencil& s = _stencils[p];
+        s.i = static_cast<uint32_t>(i);
+        s.j = static_cast<uint32_t>(j);
+        s.k = static_cast<uint32_t>(k);
+        s.fx = static_cast<float>(fx);
+        s.fy = static_cast<float>(fy);
+        s.fz = static_cast<float>(fz);
+    });
+}
+
+inline bool ParticleStencilCache3::isValid(size_t numberOfParticles,
+                                           const Size3& dataSize,
+                                           const Vector3D& gridSpacing,
+                                           const Vector3D& dataOrigin) const {
+    return _stencils.size() == numberOfParticles && _dataSize == dataSize &&
+           _gridSpacing == gridSpacing && _dataOrigin == dataOrigin;
+}
+
+inline size_t ParticleStencilCache3::numberOfParticles() const {
+    return _stencils.size();
+}
+
+inline const ParticleStencilCache3::Stencil& ParticleStencilCache3::operator[](
+    size_t i) const {
+    return _stencils[i];
+}
+
+template <typename T>
+T ParticleStencilCache3::interpolate(size_t i,
+                                     const ConstArrayAccessor3<T>& data) const {
+    JET_ASSERT(data.size() == _dataSize);
+
+    const Stencil& s = _stencils[i];
+    const size_t ip1 = std::min<size_t>(s.i + 1, _dataSize.x - 1);
+    const size_t jp1 = std::min<size_t>(s.j + 1, _dataSize.y - 1);
+    const size_t kp1 = std::min<size_t>(s.k + 1, _dataSize.z - 1);
+
+    return trilerp(data(s.i, s.j, s.k), data(ip1, s.j, s.k),
+                   data(s.i, jp1, s.k), data(ip1, jp1, s.k),
+                   data(s.i, s.j, kp1), data(ip1, s.j, kp1),
+                   data(s.i, jp1, kp1), data(ip1, jp1, kp1),
+                   static_cast<double>(s.fx), static_cast<double>(s.fy),
+                   static_cast<double>(s.fz));
+}
+
+inline void ParticleStencilCache3::getCoordinates(
+    const Stencil& s, std::array<Point3UI, 8>* indices) const {
+    const size_t ip1 = std::min<size_t>(s.i + 1, _dataSize.x - 1);
+    const size_t jp1 = std::min<size_t>(s.j + 1, _dataSize.y - 1);
+    const size_t kp1 = std::min<size_t>(s.k + 1, _dataSize.z - 1);
+
+    (*indices)[0] = Point3UI(s.i, s.j, s.k);
+    (*indices)[1] = Point3UI(ip1, s.j, s.k);
+    (*indices)[2] = Point3UI(s.i, jp1, s.k);
+    (*indices)[3] = Point3UI(ip1, jp1, s.k);
+    (*indices)[4] = Point3UI(s.i, s.j, kp1);
+    (*indices)[5] = Point3UI(ip1, s.j, kp1);
+    (*indices)[6] = Point3UI(s.i, jp1, kp1);
+    (*indices)[7] = Point3UI(ip1, jp1, kp1);
+}
+
+inline void ParticleStencilCache3::getCoordinatesAndWeights(
+    size_t i, std::array<Point3UI, 8>* indices,
+    std::array<double, 8>* weights) const {
+    const Stencil& s = _stencils[i];
+    getCoordinates(s, indices);
+
+    const double fx = s.fx;
+    const double fy = s.fy;
+    const double fz = s.fz;
+
+    (*weights)[0] = (1 - fx) * (1 - fy) * (1 - fz);
+    (*weights)[1] = fx * (1 - fy) * (1 - fz);
+    (*weights)[2] = (1 - fx) * fy * (1 - fz);
+    (*weights)[3] = fx * fy * (1 - fz);
+    (*weights)[4] = (1 - fx) * (1 - fy) * fz;
+    (*weights)[5] = fx * (1 - fy) * fz;
+    (*weights)[6] = (1 - fx) * fy * fz;
+    (*weights)[7] = fx * fy * fz;
+}
+
+inline void ParticleStencilCache3::getCoordinatesAndGradientWeights(
+    size_t i, std::array<Point3UI, 8>* indices,
+    std::array<Vector3D, 8>* weights) const {
+    const Stencil& s = _stencils[i];
+    getCoordinates(s, indices);
+
+    const double fx = s.fx;
+    const double fy = s.fy;
+    const double fz = s.fz;
+    const Vector3D invH = 1.0 / _gridSpacing;
+
+    (*weights)[0] = Vector3D(-invH.x * (1 - fy) * (1 - fz),
+                             -invH.y * (1 - fx) * (1 - fz),
+                             -invH.z * (1 - fx) * (1 - fy));
+    (*weights)[1] = Vector3D(invH.x * (1 - fy) * (1 - fz),
+                             fx * (-invH.y) * (1 - fz),
+                             fx * (1 - fy) * (-invH.z));
+    (*weights)[2] = Vector3D((-invH.x) * fy * (1 - fz),
+                             (1 - fx) * invH.y * (1 - fz),
+                             (1 - fx) * fy * (-invH.z));
+    (*weights)[3] = Vector3D(invH.x * fy * (1 - fz), fx * invH.y * (1 - fz),
+                             fx * fy * (-invH.z));
+    (*weights)[4] = Vector3D((-invH.x) * (1 - fy) * fz,
+                             (1 - fx) * (-invH.y) * fz,
+                             (1 - fx) * (1 - fy) * invH.z);
+    (*weights)[5] = Vector3D(invH.x * (1 - fy) * fz, fx * (-invH.y) * fz,
+                             fx * (1 - fy) * invH.z);
+    (*weights)[6] = Vector3D((-invH.x) * fy * fz, (1 - fx) * invH.y * fz,
+                             (1 - fx) * fy * invH.z);
+    (*weights)[7] = Vector3D(invH.x * fy * fz, fx * invH.y * fz,
+                             fx * fy * invH.z);
+}
+
+inline void ParticleStencilCache3::clear() {
+    _stencils.clear();
+    _dataSize = Size3();
+}
+
+}  // namespace jet
+
+#endif  // INCLUDE_JET_DETAIL_PARTICLE_STENCIL_CACHE3_INL_H_
@@ -0,0 +1,68 @@
+// Copyright (c) 2018 Doyub Kim
+//
+// I am making my contributions/submissions to this project solely in my
+// personal capacity and am not conveying any rights to any intellectual
+// property of any third parties.
+
+#ifndef INCLUDE_JET_DETAIL_PARTICLE_SYSTEM_DATA3_INL_H_
+#define INCLUDE_JET_DETAIL_PARTICLE_SYSTEM_DATA3_INL_H_
+
+#include <jet/macros.h>
+#include <jet/parallel.h>
+#include <jet/particle_system_data3.h>
+
+#include <type_traits>
+#include <vector>
+
+namespace jet {
+
+inline void ParticleSystemData3::removeParticles(
+    const ConstArrayAccessor1<char>& shouldRemove) {
+    JET_ASSERT(shouldRemove.size() == _numberOfParticles);
+
+    const size_t n = _numberOfParticles;
+    std::vector<size_t> keep(n);
+    parallelFor(kZeroSize, n,
+                [&](size_t i) { keep[i] = shouldRemove[i] ? 0 : 1; });
+
+    std::vector<size_t> newIndices;
+    const size_t newNumberOfParticles =
+        parallelExclusiveScan(keep, &newIndices);
+    if (newNumberOfParticles == n) {
+        return;
+    }
+
+    auto compact = [&](auto& data) {
+        typename std::decay<decltype(data)>::type compacted(
+            newNumberOfParticles);
+        parallelFor(kZeroSize, n, [&](size_t i) {
+            if (keep[i]) {
+                compacted[newIndices[i]] = data[i];
+            }
+        });
+        data.swap(compacted);
+    };
+
+    for (auto& data : _scalarDataList) {
+        compact(data);
+    }
+    for (auto& data : _vectorDataList) {
+        compact(data);
+    }
+
+    _numberOfParticles = newNumberOfParticles;
+    _neighborLists.clear();
+    notifyPositionsChanged();
+}
+
+inline uint64_t ParticleSystemData3::positionGeneration() const {
+    return _positionGeneration;
+}
+
+inline void ParticleSystemData3::notifyPositionsChanged() {
+    ++_positionGeneration;
+}
+
+}  // namespace jet
+
+#endif  // INCLUDE_JET_DETAIL_PARTICLE_SYSTEM_DATA3_INL_H_
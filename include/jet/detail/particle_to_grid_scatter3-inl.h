@@ -0,0 +1,191 @@
+// Copyright (c) 2018 Doyub Kim
+//
+// I am making my contributions/submissions to this project solely in my
+// personal capacity and am not conveying any rights to any intellectual
+// property of any third parties.
+
+#ifndef INCLUDE_JET_DETAIL_PARTICLE_TO_GRID_SCATTER3_INL_H_
+#define INCLUDE_JET_DETAIL_PARTICLE_TO_GRID_SCATTER3_INL_H_
+
+#include <jet/constants.h>
+#include <jet/macros.h>
+#include <jet/parallel.h>
+#include <jet/particle_to_grid_scatter3.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace jet {
+
+inline ParticleToGridScatter3::ParticleToGridScatter3(size_t blockSize) {
+    setBlockSize(blockSize);
+}
+
+inline size_t ParticleToGridScatter3::blockSize() const { return _blockSize; }
+
+inline void ParticleToGridScatter3::setBlockSize(size_t blockSize) {
+    JET_THROW_INVALID_ARG_IF(blockSize < 2);
+
+    if (blockSize != _blockSize) {
+        // The bins no longer match the block size.
+        _numberOfBlocks = Size3();
+    }
+    _blockSize = blockSize;
+}
+
+inline void ParticleToGridScatter3::build(
+    const ConstArrayAccessor1<Vector3D>& positions, const Size3& resolution,
+    const Vector3D& gridSpacing, const Vector3D& origin) {
+    JET_ASSERT(resolution.x > 0 && resolution.y > 0 && resolution.z > 0);
+
+    const size_t numberOfParticles = positions.size();
+    const Size3 numberOfBlocks((resolution.x + _blockSize - 1) / _blockSize,
+                               (resolution.y + _blockSize - 1) / _blockSize,
+                               (resolution.z + _blockSize - 1) / _blockSize);
+    const size_t totalBlocks =
+        numberOfBlocks.x * numberOfBlocks.y * numberOfBlocks.z;
+
+    // Block of each particle, from its cell index clamped to the grid
+    std::vector<size_t> particleBlocks(numberOfParticles);
+    parallelFor(kZeroSize, numberOfParticles, [&](size_t p) {
+        const Vector3D x = (positions[p] - origin) / gridSpacing;
+        auto blockIndex = [&](double v, size_t res) {
+            const double cell =
+                clamp(std::floor(v), 0.0, static_cast<double>(res - 1));
+            return static_cast<size_t>(cell) / _blockSize;
+        };
+        const size_t bi = blockIndex(x.x, resolution.x);
+        const size_t bj = blockIndex(x.y, resolution.y);
+        const size_t bk = blockIndex(x.z, resolution.z);
+        particleBlocks[p] =
+            bi + numberOfBlocks.x * (bj + numberOfBlocks.y * bk);
+    });
+
+    // Stable counting sort: each chunk of particles counts its blocks, and
+    // the chunks are laid out in order within every block.
+    const size_t numberOfChunks = std::max<size_t>(
+        1, std::min<size_t>(maxNumberOfThreads(), numberOfParticles));
+    const size_t chunkSize =
+        (numberOfParticles + numberOfChunks - 1) / numberOfChunks;
+    std::vector<std::vector<size_t>> chunkCounts(numberOfChunks);
+    parallelFor(kZeroSize, numberOfChunks, [&](size_t c) {
+        std::vector<size_t>& counts = chunkCounts[c];
+        counts.assign(totalBlocks, 0);
+        const size_t end = std::min(numberOfParticles, (c + 1) * chunkSize);
+        for (size_t p = c * chunkSize; p < end; ++p) {
+            ++counts[particleBlocks[p]];
+        }
+    });
+
+    _blockStarts.resize(totalBlocks + 1);
+    size_t offset = 0;
+    for (size_t b = 0; b < totalBlocks; ++b) {
+        _blockStarts[b] = offset;
+        for (size_t c = 0; c < numberOfChunks; ++c) {
+            const size_t count = chunkCounts[c][b];
+            chunkCounts[c][b] = offset;
+            offset += count;
+        }
+    }
+    _blockStarts[totalBlocks] = offset;
+
+    _sortedParticles.resize(numberOfParticles);
+    parallelFor(kZeroSize, numberOfChunks, [&](size_t c) {
+        std::vector<size_t>& offsets = chunkCounts[c];
+        const size_t end = std::min(numberOfParticles, (c + 1) * chunkSize);
+        for (size_t p = c * chunkSize; p < end; ++p) {
+            _sortedParticles[offsets[particleBlocks[p]]++] = p;
+        }
+    });
+
+    // Non-empty blocks grouped by the parity of their block coordinates
+    for (auto& blocks : _coloredBlocks) {
+        blocks.clear();
+    }
+    for (size_t b = 0; b < totalBlocks; ++b) {
+        if (_blockStarts[b] == _blockStarts[b + 1]) {
+            continue;
+        }
+        const size_t bi = b % numberOfBlocks.x;
+        const size_t bj = (b / numberOfBlocks.x) % numberOfBlocks.y;
+        const size_t bk = b / (numberOfBlocks.x * numberOfBlocks.y);
+        _coloredBlocks[(bi & 1) | ((bj & 1) << 1) | ((bk & 1) << 2)]
+            .push_back(b);
+    }
+
+    _numberOfParticles = numberOfParticles;
+    _numberOfBlocks = numberOfBlocks;
+    _resolution = resolution;
+    _gridSpacing = gridSpacing;
+    _origin = origin;
+}
+
+inline bool ParticleToGridScatter3::isValid(size_t numberOfParticles,
+                                            const Size3& resolution,
+                                            const Vector3D& gridSpacing,
+                                            const Vector3D& origin) const {
+    const Size3 numberOfBlocks((resolution.x + _blockSize - 1) / _blockSize,
+                               (resolution.y + _blockSize - 1) / _blockSize,
+                               (resolution.z + _blockSize - 1) / _blockSize);
+    return _numberOfParticles == numberOfParticles &&
+           _numberOfBlocks == numberOfBlocks && _resolution == resolution &&
+           _gridSpacing == gridSpacing && _origin == origin;
+}
+
+inline size_t ParticleToGridScatter3::numberOfParticles() const {
+    return _numberOfParticles;
+}
+
+inline Size3 ParticleToGridScatter3::numberOfBlocks() const {
+    return _numberOfBlocks;
+}
+
+template <typename Function>
+void ParticleToGridScatter3::forEachParticleInBlock(
+    size_t bi, size_t bj, size_t bk, const Function& func) const {
+    JET_ASSERT(bi < _numberOfBlocks.x && bj < _numberOfBlocks.y &&
+               bk < _numberOfBlocks.z);
+
+    const size_t b =
+        bi + _numberOfBlocks.x * (bj + _numberOfBlocks.y * bk);
+    for (size_t s = _blockStarts[b]; s < _blockStarts[b + 1]; ++s) {
+        func(_sortedParticles[s]);
+    }
+}
+
+template <typename Function>
+void ParticleToGridScatter3::forEachParticle(const Function& func) const {
+    for (const auto& blocks : _coloredBlocks) {
+        parallelFor(kZeroSize, blocks.size(), [&](size_t n) {
+            const size_t b = blocks[n];
+            for (size_t s = _blockStarts[b]; s < _blockStarts[b + 1]; ++s) {
+                func(_sortedParticles[s]);
+            }
+        });
+    }
+}
+
+template <typename T, typename ValueFunction>
+void ParticleToGridScatter3::scatter(const ParticleStencilCache3& stencils,
+                                     const ValueFunction& value,
+                                     ArrayAccessor3<T> data,
+                                     ArrayAccessor3<double> weights,
+                                     ArrayAccessor3<char> markers) const {
+    JET_ASSERT(stencils.numberOfParticles() == _numberOfParticles);
+
+    forEachParticle([&](size_t p) {
+        std::array<Point3UI, 8> indices;
+        std::array<double, 8> w;
+        stencils.getCoordinatesAndWeights(p, &indices, &w);
+        const T v = value(p);
+        for (int q = 0; q < 8; ++q) {
+            data(indices[q]) += v * w[q];
+            weights(indices[q]) += w[q];
+            markers(indices[q]) = 1;
+        }
+    });
+}
+
+}  // namespace jet
+
+#endif  // INCLUDE_JET_DETAIL_PARTICLE_TO_GRID_SCATTER3_INL_H_
@@ -0,0 +1,579 @@
+// Copyright (c) 2018 Doyub Kim
+//
+// I am making my contributions/submissions to this project solely in my
+// personal capacity and am not conveying any rights to any intellectual
+// property of any third parties.
+
+#ifndef INCLUDE_JET_DETAIL_PIC_SOLVER3_INL_H_
+#define INCLUDE_JET_DETAIL_PIC_SOLVER3_INL_H_
+
+#include <jet/constants.h>
+#include <jet/fast_sweeping_level_set_solver3.h>
+#include <jet/macros.h>
+#include <jet/math_utils.h>
+#include <jet/parallel.h>
+#include <jet/pic_solver3.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace jet {
+
+namespace internal {
+
+// Mixes the bits of an integer key (SplitMix64 finalizer).
+inline uint64_t particleSeedHash(uint64_t key) {
+    key += 0x9e3779b97f4a7c15ULL;
+    key = (key ^ (key >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    key = (key ^ (key >> 27)) * 0x94d049bb133111ebULL;
+    return key ^ (key >> 31);
+}
+
+// Deterministic pseudo-random number in [0, 1) from an integer key.
+inline double particleSeedJitter(uint64_t key) {
+    return static_cast<double>(particleSeedHash(key) >> 11) *
+           (1.0 / 9007199254740992.0);
+}
+
+// Cell index of coordinate x along one axis, clamped to the grid.
+inline size_t particleCellIndex(double x, size_t resolution) {
+    const double cell = clamp(std::floor(x), 0.0,
+                              static_cast<double>(resolution) - 1.0);
+    return static_cast<size_t>(cell);
+}
+
+// Linear index of the grid cell containing x, clamped to the grid.
+inline size_t particleLinearCellIndex(const Vector3D& x,
+                                      const Vector3D& origin,
+                                      const Vector3D& gridSpacing,
+                                      const Size3& res) {
+    const Vector3D p = (x - origin) / gridSpacing;
+    return particleCellIndex(p.x, res.x) +
+           res.x * (particleCellIndex(p.y, res.y) +
+                    res.y * particleCellIndex(p.z, res.z));
+}
+
+}  // namespace internal
+
+inline size_t PicSolver3::minParticlesPerCell() const {
+    return _minParticlesPerCell;
+}
+
+inline size_t PicSolver3::maxParticlesPerCell() const {
+    return _maxParticlesPerCell;
+}
+
+inline void PicSolver3::setParticlesPerCellRange(size_t minCount,
+                                                 size_t maxCount) {
+    JET_THROW_INVALID_ARG_IF(minCount > maxCount || maxCount == 0);
+
+    _minParticlesPerCell = minCount;
+    _maxParticlesPerCell = maxCount;
+}
+
+inline void PicSolver3::updateParticleStencils() {
+    const auto& flow = gridSystemData()->velocity();
+    const ParticleSystemData3& particles = *_particles;
+    const auto positions = particles.positions();
+    const Vector3D& h = flow->gridSpacing();
+
+    _uStencils.build(positions, flow->uSize(), h, flow->uOrigin());
+    _vStencils.build(positions, flow->vSize(), h, flow->vOrigin());
+    _wStencils.build(positions, flow->wSize(), h, flow->wOrigin());
+    _particleScatter.build(positions, flow->resolution(), h, flow->origin());
+    _particleStencilGeneration = particles.positionGeneration();
+}
+
+inline bool PicSolver3::hasValidParticleStencils() const {
+    const auto& flow = gridSystemData()->velocity();
+    const size_t n = _particles->numberOfParticles();
+    const Vector3D& h = flow->gridSpacing();
+
+    return _particleStencilGeneration == _particles->positionGeneration() &&
+           _uStencils.isValid(n, flow->uSize(), h, flow->uOrigin()) &&
+           _vStencils.isValid(n, flow->vSize(), h, flow->vOrigin()) &&
+           _wStencils.isValid(n, flow->wSize(), h, flow->wOrigin()) &&
+           _particleScatter.isValid(n, flow->resolution(), h, flow->origin());
+}
+
+inline void PicSolver3::controlParticleCount() {
+    if (_minParticlesPerCell == 0 && _maxParticlesPerCell == kMaxSize) {
+        return;
+    }
+
+    // Delete the particles beyond the maximum count of their cell.
+    Array3<uint32_t> counts;
+    if (_maxParticlesPerCell != kMaxSize) {
+        std::vector<uint32_t> ranks;
+        countParticlesPerCell(&counts, &ranks);
+
+        Array1<char> shouldRemove(ranks.size());
+        parallelFor(kZeroSize, ranks.size(), [&](size_t p) {
+            shouldRemove[p] = (ranks[p] >= _maxParticlesPerCell) ? 1 : 0;
+        });
+        removeParticles(shouldRemove.constAccessor());
+
+        counts.parallelForEachIndex([&](size_t i, size_t j, size_t k) {
+            counts(i, j, k) = static_cast<uint32_t>(std::min<size_t>(
+                counts(i, j, k), _maxParticlesPerCell));
+        });
+    } else {
+        countParticlesPerCell(&counts);
+    }
+
+    // Seed the underfull fluid cells.
+    if (_minParticlesPerCell > 0) {
+        const auto sdf = signedDistanceField();
+        const auto boundarySdf = colliderSdf();
+        const double depth = particleSeedingDepth();
+        const Vector3D h = gridSpacing();
+        const Vector3D origin = gridOrigin();
+
+        seedParticlesInCells(
+            [&](size_t i, size_t j, size_t k) -> size_t {
+                const double phi = (*sdf)(i, j, k);
+                if (counts(i, j, k) >= _minParticlesPerCell || phi >= 0.0 ||
+                    phi < -depth) {
+                    return 0;
+                }
+
+                const Vector3D center =
+                    origin + h * Vector3D(i + 0.5, j + 0.5, k + 0.5);
+                if (boundarySdf->sample(center) < 0.0) {
+                    return 0;
+                }
+
+                return _minParticlesPerCell - counts(i, j, k);
+            },
+            *gridSystemData()->velocity(),
+            static_cast<uint64_t>(currentFrame().index));
+    }
+}
+
+inline void PicSolver3::removeParticles(
+    const ConstArrayAccessor1<char>& shouldRemove) {
+    _particles->removeParticles(shouldRemove);
+}
+
+inline void PicSolver3::countParticlesPerCell(
+    Array3<uint32_t>* counts, std::vector<uint32_t>* ranks) const {
+    const Size3 res = resolution();
+    const Vector3D h = gridSpacing();
+    const Vector3D origin = gridOrigin();
+    const ParticleSystemData3& particles = *_particles;
+    const auto positions = particles.positions();
+
+    std::vector<size_t> cells(positions.size());
+    parallelFor(kZeroSize, positions.size(), [&](size_t p) {
+        cells[p] =
+            internal::particleLinearCellIndex(positions[p], origin, h, res);
+    });
+
+    // Counting sort in chunks of particles: each chunk counts its cells,
+    // and the ranks of a chunk start after the counts of earlier chunks.
+    // The chunk count is bounded so that the per-chunk arrays do not
+    // outweigh the particles.
+    const size_t numberOfParticles = positions.size();
+    const size_t numberOfCells = res.x * res.y * res.z;
+    const size_t particlesPerCell =
+        numberOfParticles / std::max<size_t>(numberOfCells, 1);
+    const size_t numberOfChunks = std::max<size_t>(
+        1, std::min<size_t>(particlesPerCell, maxNumberOfThreads()));
+    const size_t chunkSize =
+        (numberOfParticles + numberOfChunks - 1) / numberOfChunks;
+    std::vector<std::vector<uint32_t>> chunkCounts(numberOfChunks);
+    parallelFor(kZeroSize, numberOfChunks, [&](size_t c) {
+        std::vector<uint32_t>& chunk = chunkCounts[c];
+        chunk.assign(numberOfCells, 0);
+        const size_t end = std::min(numberOfParticles, (c + 1) * chunkSize);
+        for (size_t p = c * chunkSize; p < end; ++p) {
+            ++chunk[cells[p]];
+        }
+    });
+
+    counts->resize(res);
+    uint32_t* data = counts->data();
+    parallelFor(kZeroSize, numberOfCells, [&](size_t cell) {
+        uint32_t count = 0;
+        for (size_t c = 0; c < numberOfChunks; ++c) {
+            const uint32_t chunkCount = chunkCounts[c][cell];
+            chunkCounts[c][cell] = count;
+            count += chunkCount;
+        }
+        data[cell] = count;
+    });
+
+    if (ranks != nullptr) {
+        ranks->resize(numberOfParticles);
+        parallelFor(kZeroSize, numberOfChunks, [&](size_t c) {
+            std::vector<uint32_t>& next = chunkCounts[c];
+            const size_t end =
+                std::min(numberOfParticles, (c + 1) * chunkSize);
+            for (size_t p = c * chunkSize; p < end; ++p) {
+                (*ranks)[p] = next[cells[p]]++;
+            }
+        });
+    }
+}
+
+template <typename SeedCountFunction>
+void PicSolver3::seedParticlesInCells(const SeedCountFunction& func,
+                                      const VectorField3& velocity,
+                                      uint64_t seed) {
+    const Size3 res = resolution();
+    const Vector3D h = gridSpacing();
+    const Vector3D origin = gridOrigin();
+
+    std::vector<std::vector<Vector3D>> slicePositions(res.z);
+    parallelFor(kZeroSize, res.z, [&](size_t k) {
+        for (size_t j = 0; j < res.y; ++j) {
+            for (size_t i = 0; i < res.x; ++i) {
+                const size_t n = func(i, j, k);
+                const uint64_t cellHash = internal::particleSeedHash(
+                    (seed * res.z + k) * res.x * res.y + j * res.x + i);
+                for (uint64_t s = 0; s < n; ++s) {
+                    // Hashing (cell, s) keeps the keys of all seeds distinct.
+                    const uint64_t key =
+                        internal::particleSeedHash(cellHash + s);
+                    const uint64_t octant = s % 8;
+                    const Vector3D offset(
+                        (octant & 1) + internal::particleSeedJitter(key),
+                        ((octant >> 1) & 1) +
+                            internal::particleSeedJitter(key + 1),
+                        ((octant >> 2) & 1) +
+                            internal::particleSeedJitter(key + 2));
+                    slicePositions[k].push_back(
+                        origin + h * (Vector3D(i, j, k) + 0.5 * offset));
+                }
+            }
+        }
+    });
+
+    Array1<Vector3D> newPositions;
+    for (const auto& slice : slicePositions) {
+        for (const auto& x : slice) {
+            newPositions.append(x);
+        }
+    }
+
+    if (newPositions.size() == 0) {
+        return;
+    }
+
+    Array1<Vector3D> newVelocities(newPositions.size());
+    parallelFor(kZeroSize, newPositions.size(), [&](size_t p) {
+        newVelocities[p] = velocity.sample(newPositions[p]);
+    });
+
+    _particles->addParticles(newPositions.constAccessor(),
+                             newVelocities.constAccessor());
+    _particles->notifyPositionsChanged();
+}
+
+inline double PicSolver3::particleSeedingDepth() const { return kMaxD; }
+
+inline void PicSolver3::transferFromParticlesToGrids() {
+    if (!hasValidParticleStencils()) {
+        updateParticleStencils();
+    }
+
+    auto flow = gridSystemData()->velocity();
+    const ParticleSystemData3& particles = *_particles;
+    const auto velocities = particles.velocities();
+
+    // Clear velocity to zero
+    flow->fill(Vector3D());
+
+    // Weighted-average velocity
+    auto u = flow->uAccessor();
+    auto v = flow->vAccessor();
+    auto w = flow->wAccessor();
+    Array3<double> uWeight(u.size());
+    Array3<double> vWeight(v.size());
+    Array3<double> wWeight(w.size());
+    _uMarkers.resize(u.size());
+    _vMarkers.resize(v.size());
+    _wMarkers.resize(w.size());
+    _uMarkers.set(0);
+    _vMarkers.set(0);
+    _wMarkers.set(0);
+
+    // The scatter visits the particles in parallel without write conflicts,
+    // in an order that does not depend on the number of threads.
+    _particleScatter.scatter(
+        _uStencils, [&](size_t i) { return velocities[i].x; }, u,
+        uWeight.accessor(), _uMarkers.accessor());
+    _particleScatter.scatter(
+        _vStencils, [&](size_t i) { return velocities[i].y; }, v,
+        vWeight.accessor(), _vMarkers.accessor());
+    _particleScatter.scatter(
+        _wStencils, [&](size_t i) { return velocities[i].z; }, w,
+        wWeight.accessor(), _wMarkers.accessor());
+
+    uWeight.parallelForEachIndex([&](size_t i, size_t j, size_t k) {
+        if (uWeight(i, j, k) > 0.0) {
+            u(i, j, k) /= uWeight(i, j, k);
+        }
+    });
+    vWeight.parallelForEachIndex([&](size_t i, size_t j, size_t k) {
+        if (vWeight(i, j, k) > 0.0) {
+            v(i, j, k) /= vWeight(i, j, k);
+        }
+    });
+    wWeight.parallelForEachIndex([&](size_t i, size_t j, size_t k) {
+        if (wWeight(i, j, k) > 0.0) {
+            w(i, j, k) /= wWeight(i, j, k);
+        }
+    });
+}
+
+inline void PicSolver3::transferFromGridsToParticles() {
+    if (!hasValidParticleStencils()) {
+        updateParticleStencils();
+    }
+
+    auto flow = gridSystemData()->velocity();
+    const auto u = flow->uConstAccessor();
+    const auto v = flow->vConstAccessor();
+    const auto w = flow->wConstAccessor();
+    auto velocities = _particles->velocities();
+    const size_t numberOfParticles = _particles->numberOfParticles();
+
+    parallelFor(kZeroSize, numberOfParticles, [&](size_t i) {
+        velocities[i] = Vector3D(_uStencils.interpolate(i, u),
+                                 _vStencils.interpolate(i, v),
+                                 _wStencils.interpolate(i, w));
+    });
+}
+
+inline void PicSolver3::moveParticles(double timeIntervalInSeconds) {
+    auto flow = gridSystemData()->velocity();
+    auto positions = _particles->positions();
+    auto velocities = _particles->velocities();
+    const size_t numberOfParticles = _particles->numberOfParticles();
+    const int domainBoundaryFlag = closedDomainBoundaryFlag();
+    const BoundingBox3D boundingBox = flow->boundingBox();
+
+    parallelFor(kZeroSize, numberOfParticles, [&](size_t i) {
+        Vector3D pt0 = positions[i];
+        Vector3D pt1 = pt0;
+        Vector3D vel = velocities[i];
+
+        // Adaptive time-stepping
+        const unsigned int numSubSteps =
+            static_cast<unsigned int>(std::max(maxCfl(), 1.0));
+        const double dt = timeIntervalInSeconds / numSubSteps;
+        for (unsigned int t = 0; t < numSubSteps; ++t) {
+            const Vector3D vel0 = flow->sample(pt0);
+
+            // Mid-point rule
+            const Vector3D midPt = pt0 + 0.5 * dt * vel0;
+            const Vector3D midVel = flow->sample(midPt);
+            pt1 = pt0 + dt * midVel;
+
+            pt0 = pt1;
+        }
+
+        if ((domainBoundaryFlag & kDirectionLeft) &&
+            pt1.x <= boundingBox.lowerCorner.x) {
+            pt1.x = boundingBox.lowerCorner.x;
+            vel.x = 0.0;
+        }
+        if ((domainBoundaryFlag & kDirectionRight) &&
+            pt1.x >= boundingBox.upperCorner.x) {
+            pt1.x = boundingBox.upperCorner.x;
+            vel.x = 0.0;
+        }
+        if ((domainBoundaryFlag & kDirectionDown) &&
+            pt1.y <= boundingBox.lowerCorner.y) {
+            pt1.y = boundingBox.lowerCorner.y;
+            vel.y = 0.0;
+        }
+        if ((domainBoundaryFlag & kDirectionUp) &&
+            pt1.y >= boundingBox.upperCorner.y) {
+            pt1.y = boundingBox.upperCorner.y;
+            vel.y = 0.0;
+        }
+        if ((domainBoundaryFlag & kDirectionBack) &&
+            pt1.z <= boundingBox.lowerCorner.z) {
+            pt1.z = boundingBox.lowerCorner.z;
+            vel.z = 0.0;
+        }
+        if ((domainBoundaryFlag & kDirectionFront) &&
+            pt1.z >= boundingBox.upperCorner.z) {
+            pt1.z = boundingBox.upperCorner.z;
+            vel.z = 0.0;
+        }
+
+        positions[i] = pt1;
+        velocities[i] = vel;
+    });
+
+    const Collider3Ptr& col = collider();
+    if (col != nullptr) {
+        parallelFor(kZeroSize, numberOfParticles, [&](size_t i) {
+            col->resolveCollision(0.0, 0.0, &positions[i], &velocities[i]);
+        });
+    }
+
+    _particles->notifyPositionsChanged();
+
+    controlParticleCount();
+}
+
+inline void PicSolver3::buildSignedDistanceField() {
+    static const size_t kTileSize = 8;
+
+    auto sdf = signedDistanceField();
+    const Size3 res = resolution();
+    const Size3 size = sdf->dataSize();
+    const Vector3D h = sdf->gridSpacing();
+    const Vector3D dataOrigin = sdf->dataOrigin();
+    const double maxH = max3(h.x, h.y, h.z);
+    const double radius = 1.2 * maxH / std::sqrt(2.0);
+    const double sdfBandRadius = 2.0 * radius;
+    const ParticleSystemData3& particles = *_particles;
+    const auto positions = particles.positions();
+
+    JET_ASSERT(size == res);
+
+    if (positions.size() == 0) {
+        sdf->fill(sdfBandRadius - radius);
+        extrapolateIntoCollider(sdf.get());
+        return;
+    }
+
+    // The particles are found through the bins of _particleScatter, which
+    // cover the cells of this grid.
+    if (!hasValidParticleStencils()) {
+        updateParticleStencils();
+    }
+    const ParticleToGridScatter3& bins = _particleScatter;
+    const ssize_t blockSize = static_cast<ssize_t>(bins.blockSize());
+    const Size3 numberOfBlocks = bins.numberOfBlocks();
+
+    // A particle reaches the data points within this many cells of its own.
+    const ssize_t reach =
+        static_cast<ssize_t>(std::ceil(sdfBandRadius / min3(h.x, h.y, h.z))) +
+        1;
+
+    // Splat the particles to the data points in their band, one tile at a
+    // time. Points out of reach of any particle are marked unknown.
+    const Size3 numberOfTiles((size.x + kTileSize - 1) / kTileSize,
+                              (size.y + kTileSize - 1) / kTileSize,
+                              (size.z + kTileSize - 1) / kTileSize);
+    Array3<char> known(size, 0);
+    parallelFor(kZeroSize, numberOfTiles.x, kZeroSize, numberOfTiles.y,
+                kZeroSize, numberOfTiles.z, [&](size_t ti, size_t tj,
+                                                size_t tk) {
+        const ssize_t lo[3] = {static_cast<ssize_t>(ti * kTileSize),
+                               static_cast<ssize_t>(tj * kTileSize),
+                               static_cast<ssize_t>(tk * kTileSize)};
+        const ssize_t hi[3] = {
+            std::min<ssize_t>(lo[0] + kTileSize, size.x),
+            std::min<ssize_t>(lo[1] + kTileSize, size.y),
+            std::min<ssize_t>(lo[2] + kTileSize, size.z)};
+
+        for (ssize_t k = lo[2]; k < hi[2]; ++k) {
+            for (ssize_t j = lo[1]; j < hi[1]; ++j) {
+                for (ssize_t i = lo[0]; i < hi[0]; ++i) {
+                    (*sdf)(i, j, k) = sdfBandRadius;
+                }
+            }
+        }
+
+        auto splat = [&](const Vector3D& x) {
+            const Vector3D p = (x - dataOrigin) / h;
+            const Vector3D r = sdfBandRadius / h;
+            const ssize_t pBegin[3] = {
+                std::max<ssize_t>(lo[0], std::ceil(p.x - r.x)),
+                std::max<ssize_t>(lo[1], std::ceil(p.y - r.y)),
+                std::max<ssize_t>(lo[2], std::ceil(p.z - r.z))};
+            const ssize_t pEnd[3] = {
+                std::min<ssize_t>(hi[0], std::floor(p.x + r.x) + 1),
+                std::min<ssize_t>(hi[1], std::floor(p.y + r.y) + 1),
+                std::min<ssize_t>(hi[2], std::floor(p.z + r.z) + 1)};
+            for (ssize_t k = pBegin[2]; k < pEnd[2]; ++k) {
+                for (ssize_t j = pBegin[1]; j < pEnd[1]; ++j) {
+                    for (ssize_t i = pBegin[0]; i < pEnd[0]; ++i) {
+                        const Vector3D pt =
+                            dataOrigin + h * Vector3D(i, j, k);
+                        double& phi = (*sdf)(i, j, k);
+                        phi = std::min(phi, pt.distanceTo(x));
+                    }
+                }
+            }
+        };
+
+        // Blocks that hold cells within reach of the tile.
+        ssize_t bBegin[3];
+        ssize_t bEnd[3];
+        const size_t nb[3] = {numberOfBlocks.x, numberOfBlocks.y,
+                              numberOfBlocks.z};
+        for (int a = 0; a < 3; ++a) {
+            bBegin[a] = std::max<ssize_t>(0, lo[a] - reach) / blockSize;
+            bEnd[a] = std::min<ssize_t>((hi[a] + reach - 1) / blockSize + 1,
+                                        nb[a]);
+        }
+        for (ssize_t bk = bBegin[2]; bk < bEnd[2]; ++bk) {
+            for (ssize_t bj = bBegin[1]; bj < bEnd[1]; ++bj) {
+                for (ssize_t bi = bBegin[0]; bi < bEnd[0]; ++bi) {
+                    bins.forEachParticleInBlock(
+                        bi, bj, bk,
+                        [&](size_t p) { splat(positions[p]); });
+                }
+            }
+        }
+
+        for (ssize_t k = lo[2]; k < hi[2]; ++k) {
+            for (ssize_t j = lo[1]; j < hi[1]; ++j) {
+                for (ssize_t i = lo[0]; i < hi[0]; ++i) {
+                    double& phi = (*sdf)(i, j, k);
+                    if (phi < sdfBandRadius) {
+                        phi -= radius;
+                        known(i, j, k) = 1;
+                    } else {
+                        phi = kMaxD;
+                    }
+                }
+            }
+        }
+    });
+
+    // Fill the far field with the distance to the band, which is outside.
+    const size_t numberOfCells = res.x * res.y * res.z;
+    bool hasKnownPoints = false;
+    for (size_t n = 0; n < numberOfCells && !hasKnownPoints; ++n) {
+        hasKnownPoints = known.data()[n] != 0;
+    }
+    if (hasKnownPoints) {
+        auto phiAt = [&](size_t i, size_t j, size_t k) {
+            return (*sdf)(i, j, k);
+        };
+        internal::fastSweep3(size, kTileSize, [&](size_t i, size_t j,
+                                                  size_t k) {
+            if (known(i, j, k)) {
+                return;
+            }
+            const double ux =
+                std::min((i > 0) ? phiAt(i - 1, j, k) : kMaxD,
+                         (i + 1 < size.x) ? phiAt(i + 1, j, k) : kMaxD);
+            const double uy =
+                std::min((j > 0) ? phiAt(i, j - 1, k) : kMaxD,
+                         (j + 1 < size.y) ? phiAt(i, j + 1, k) : kMaxD);
+            const double uz =
+                std::min((k > 0) ? phiAt(i, j, k - 1) : kMaxD,
+                         (k + 1 < size.z) ? phiAt(i, j, k + 1) : kMaxD);
+            double& phi = (*sdf)(i, j, k);
+            phi = std::min(phi, internal::fastSweepingDistance3(ux, uy, uz, h));
+        });
+    } else {
+        sdf->fill(sdfBandRadius - radius);
+    }
+
+    extrapolateIntoCollider(sdf.get());
+}
+
+}  // namespace jet
+
+#endif  // INCLUDE_JET_DETAIL_PIC_SOLVER3_INL_H_
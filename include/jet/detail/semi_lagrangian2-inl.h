@@ -0,0 +1,153 @@
+// Copyright (c) 2018 Doyub Kim
+//
+// I am making my contributions/submissions to this project solely in my
+// personal capacity and am not conveying any rights to any intellectual
+// property of any third parties.
+
+#ifndef INCLUDE_JET_DETAIL_SEMI_LAGRANGIAN2_INL_H_
+#define INCLUDE_JET_DETAIL_SEMI_LAGRANGIAN2_INL_H_
+
+#include <jet/array_samplers2.h>
+#include <jet/constant_scalar_field2.h>
+#include <jet/math_utils.h>
+#include <jet/semi_lagrangian2.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace jet {
+
+namespace internal {
+
+// Boundary SDF that has the same value everywhere.
+struct SemiLagrangianConstantSdf2 {
+    double value;
+
+    double operator()(const Vector2D&) const { return value; }
+};
+
+// Samples a FaceCenteredGrid2 without going through VectorField2::sample.
+struct SemiLagrangianFaceFlow2 {
+    LinearArraySampler2<double, double> u;
+    LinearArraySampler2<double, double> v;
+
+    explicit SemiLagrangianFaceFlow2(const FaceCenteredGrid2& flow)
+        : u(flow.uConstAccessor(), flow.gridSpacing(), flow.uOrigin()),
+          v(flow.vConstAccessor(), flow.gridSpacing(), flow.vOrigin()) {}
+
+    Vector2D operator()(const Vector2D& pt) const {
+        return Vector2D(u(pt), v(pt));
+    }
+};
+
+// Same back-tracing as SemiLagrangian2::backTrace with the flow and the
+// boundary SDF resolved at compile time.
+template <typename Flow, typename Sdf>
+Vector2D semiLagrangianBackTrace(const Flow& flow, const Sdf& boundarySdf,
+                                 double dt, double h,
+                                 const Vector2D& startPt) {
+    double remainingT = dt;
+    Vector2D pt0 = startPt;
+    Vector2D pt1 = startPt;
+
+    while (remainingT > kEpsilonD) {
+        // Adaptive time-stepping
+        Vector2D vel0 = flow(pt0);
+        double numSubSteps =
+            std::max(std::ceil(vel0.length() * remainingT / h), 1.0);
+        dt = remainingT / numSubSteps;
+
+        // Mid-point rule
+        Vector2D midPt = pt0 - 0.5 * dt * vel0;
+        Vector2D midVel = flow(midPt);
+        pt1 = pt0 - dt * midVel;
+
+        // Boundary handling
+        double phi0 = boundarySdf(pt0);
+        double phi1 = boundarySdf(pt1);
+
+        if (phi0 * phi1 < 0.0) {
+            double w = std::fabs(phi1) / (std::fabs(phi0) + std::fabs(phi1));
+            pt1 = w * pt0 + (1.0 - w) * pt1;
+            break;
+        }
+
+        remainingT -= dt;
+        pt0 = pt1;
+    }
+
+    return pt1;
+}
+
+// Resolves the concrete flow and boundary SDF types and calls
+// kernel(flowSampler, sdfSampler). Returns false if either type is not
+// supported.
+template <typename Kernel>
+bool dispatchSemiLagrangianLinear2(const VectorField2& flow,
+                                   const ScalarField2& boundarySdf,
+                                   const Kernel& kernel) {
+    auto faceFlow = dynamic_cast<const FaceCenteredGrid2*>(&flow);
+    if (faceFlow == nullptr) {
+        return false;
+    }
+
+    const SemiLagrangianFaceFlow2 flowSampler(*faceFlow);
+
+    auto constSdf = dynamic_cast<const ConstantScalarField2*>(&boundarySdf);
+    if (constSdf != nullptr) {
+        kernel(flowSampler,
+               SemiLagrangianConstantSdf2{constSdf->sample(Vector2D())});
+        return true;
+    }
+
+    auto gridSdf = dynamic_cast<const ScalarGrid2*>(&boundarySdf);
+    if (gridSdf != nullptr) {
+        kernel(flowSampler, LinearArraySampler2<double, double>(
+                                gridSdf->constDataAccessor(),
+                                gridSdf->gridSpacing(), gridSdf->dataOrigin()));
+        return true;
+    }
+
+    return false;
+}
+
+// Data layout of an advected array.
+struct SemiLagrangianLayout2 {
+    Size2 size;
+    Vector2D gridSpacing;
+    Vector2D origin;
+};
+
+// Bilinear interpolation stencil of a point, computed exactly as in
+// LinearArraySampler2::operator() so that it can be applied to several
+// arrays of the same layout.
+struct SemiLagrangianStencil2 {
+    ssize_t i, j;
+    ssize_t ip1, jp1;
+    double fx, fy;
+
+    SemiLagrangianStencil2(const Vector2D& x,
+                           const SemiLagrangianLayout2& layout) {
+        Vector2D normalizedX = (x - layout.origin) / layout.gridSpacing;
+
+        ssize_t iSize = static_cast<ssize_t>(layout.size.x);
+        ssize_t jSize = static_cast<ssize_t>(layout.size.y);
+
+        getBarycentric(normalizedX.x, 0, iSize - 1, &i, &fx);
+        getBarycentric(normalizedX.y, 0, jSize - 1, &j, &fy);
+
+        ip1 = std::min(i + 1, iSize - 1);
+        jp1 = std::min(j + 1, jSize - 1);
+    }
+
+    template <typename T>
+    T operator()(const ConstArrayAccessor2<T>& a) const {
+        return bilerp(a(i, j), a(ip1, j), a(i, jp1), a(ip1, jp1), fx, fy);
+    }
+};
+
+}  // namespace internal
+
+}  // namespace jet
+
+#endif  // INCLUDE_JET_DETAIL_SEMI_LAGRANGIAN2_INL_H_
@@ -0,0 +1,375 @@
+// Copyright (c) 2018 Doyub Kim
+//
+// I am making my contributions/submissions to this project solely in my
+// personal capacity and am not conveying any rights to any intellectual
+// property of any third parties.
+
+#ifndef INCLUDE_JET_DETAIL_SEMI_LAGRANGIAN3_INL_H_
+#define INCLUDE_JET_DETAIL_SEMI_LAGRANGIAN3_INL_H_
+
+#include <jet/array_samplers3.h>
+#include <jet/constant_scalar_field3.h>
+#include <jet/macros.h>
+#include <jet/math_utils.h>
+#include <jet/parallel.h>
+#include <jet/semi_lagrangian3.h>
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <vector>
+
+namespace jet {
+
+namespace internal {
+
+// Boundary SDF that has the same value everywhere.
+struct SemiLagrangianConstantSdf3 {
+    double value;
+
+    double operator()(const Vector3D&) const { return value; }
+};
+
+// Samples a FaceCenteredGrid3 without going through VectorField3::sample.
+struct SemiLagrangianFaceFlow3 {
+    LinearArraySampler3<double, double> u;
+    LinearArraySampler3<double, double> v;
+    LinearArraySampler3<double, double> w;
+
+    explicit SemiLagrangianFaceFlow3(const FaceCenteredGrid3& flow)
+        : u(flow.uConstAccessor(), flow.gridSpacing(), flow.uOrigin()),
+          v(flow.vConstAccessor(), flow.gridSpacing(), flow.vOrigin()),
+          w(flow.wConstAccessor(), flow.gridSpacing(), flow.wOrigin()) {}
+
+    Vector3D operator()(const Vector3D& pt) const {
+        return Vector3D(u(pt), v(pt), w(pt));
+    }
+};
+
+// Same back-tracing as SemiLagrangian3::backTrace with the flow and the
+// boundary SDF resolved at compile time.
+template <typename Flow, typename Sdf>
+Vector3D semiLagrangianBackTrace(const Flow& flow, const Sdf& boundarySdf,
+                                 double dt, double h,
+                                 const Vector3D& startPt) {
+    double remainingT = dt;
+    Vector3D pt0 = startPt;
+    Vector3D pt1 = startPt;
+
+    while (remainingT > kEpsilonD) {
+        // Adaptive time-stepping
+        Vector3D vel0 = flow(pt0);
+        double numSubSteps =
+            std::max(std::ceil(vel0.length() * remainingT / h), 1.0);
+        dt = remainingT / numSubSteps;
+
+        // Mid-point rule
+        Vector3D midPt = pt0 - 0.5 * dt * vel0;
+        Vector3D midVel = flow(midPt);
+        pt1 = pt0 - dt * midVel;
+
+        // Boundary handling
+        double phi0 = boundarySdf(pt0);
+        double phi1 = boundarySdf(pt1);
+
+        if (phi0 * phi1 < 0.0) {
+            double w = std::fabs(phi1) / (std::fabs(phi0) + std::fabs(phi1));
+            pt1 = w * pt0 + (1.0 - w) * pt1;
+            break;
+        }
+
+        remainingT -= dt;
+        pt0 = pt1;
+    }
+
+    return pt1;
+}
+
+// Resolves the concrete flow and boundary SDF types and calls
+// kernel(flowSampler, sdfSampler). Returns false if either type is not
+// supported.
+template <typename Kernel>
+bool dispatchSemiLagrangianLinear3(const VectorField3& flow,
+                                   const ScalarField3& boundarySdf,
+                                   const Kernel& kernel) {
+    auto faceFlow = dynamic_cast<const FaceCenteredGrid3*>(&flow);
+    if (faceFlow == nullptr) {
+        return false;
+    }
+
+    const SemiLagrangianFaceFlow3 flowSampler(*faceFlow);
+
+    auto constSdf = dynamic_cast<const ConstantScalarField3*>(&boundarySdf);
+    if (constSdf != nullptr) {
+        kernel(flowSampler,
+               SemiLagrangianConstantSdf3{constSdf->sample(Vector3D())});
+        return true;
+    }
+
+    auto gridSdf = dynamic_cast<const ScalarGrid3*>(&boundarySdf);
+    if (gridSdf != nullptr) {
+        kernel(flowSampler, LinearArraySampler3<double, double>(
+                                gridSdf->constDataAccessor(),
+                                gridSdf->gridSpacing(), gridSdf->dataOrigin()));
+        return true;
+    }
+
+    return false;
+}
+
+// Data layout of the arrays of a group.
+struct SemiLagrangianLayout3 {
+    Size3 size;
+    Vector3D gridSpacing;
+    Vector3D origin;
+
+    bool operator==(const SemiLagrangianLayout3& other) const {
+        return size == other.size && gridSpacing == other.gridSpacing &&
+               origin == other.origin;
+    }
+};
+
+// Arrays advected together. All inputs share the source layout and all
+// outputs share the target layout, so each target point is back-traced once.
+struct SemiLagrangianGroup3 {
+    SemiLagrangianLayout3 source;
+    SemiLagrangianLayout3 target;
+
+    // Samples the inputs through the sampler functions instead of the
+    // trilinear stencil.
+    bool useSamplers = false;
+
+    std::vector<ConstArrayAccessor3<double>> scalarInputs;
+    std::vector<ArrayAccessor3<double>> scalarOutputs;
+    std::vector<std::function<double(const Vector3D&)>> scalarSamplers;
+
+    std::vector<ConstArrayAccessor3<Vector3D>> vectorInputs;
+    std::vector<ArrayAccessor3<Vector3D>> vectorOutputs;
+    std::vector<std::function<Vector3D(const Vector3D&)>> vectorSamplers;
+
+    void add(const ConstArrayAccessor3<double>& input,
+             const ArrayAccessor3<double>& output) {
+        scalarInputs.push_back(input);
+        scalarOutputs.push_back(output);
+    }
+
+    void add(const ConstArrayAccessor3<Vector3D>& input,
+             const ArrayAccessor3<Vector3D>& output) {
+        vectorInputs.push_back(input);
+        vectorOutputs.push_back(output);
+    }
+};
+
+// Trilinear interpolation stencil of a point, computed exactly as in
+// LinearArraySampler3::operator() so that it can be applied to several
+// arrays of the same layout.
+struct SemiLagrangianStencil3 {
+    ssize_t i, j, k;
+    ssize_t ip1, jp1, kp1;
+    double fx, fy, fz;
+
+    SemiLagrangianStencil3(const Vector3D& x,
+                           const SemiLagrangianLayout3& layout) {
+        Vector3D normalizedX = (x - layout.origin) / layout.gridSpacing;
+
+        ssize_t iSize = static_cast<ssize_t>(layout.size.x);
+        ssize_t jSize = static_cast<ssize_t>(layout.size.y);
+        ssize_t kSize = static_cast<ssize_t>(layout.size.z);
+
+        getBarycentric(normalizedX.x, 0, iSize - 1, &i, &fx);
+        getBarycentric(normalizedX.y, 0, jSize - 1, &j, &fy);
+        getBarycentric(normalizedX.z, 0, kSize - 1, &k, &fz);
+
+        ip1 = std::min(i + 1, iSize - 1);
+        jp1 = std::min(j + 1, jSize - 1);
+        kp1 = std::min(k + 1, kSize - 1);
+    }
+
+    template <typename T>
+    T operator()(const ConstArrayAccessor3<T>& a) const {
+        return trilerp(a(i, j, k), a(ip1, j, k), a(i, jp1, k), a(ip1, jp1, k),
+                       a(i, j, kp1), a(ip1, j, kp1), a(i, jp1, kp1),
+                       a(ip1, jp1, kp1), fx, fy, fz);
+    }
+};
+
+// Advects a group with one back-trace per target point. A target point is
+// updated only if the source point with the same index is outside the
+// boundary.
+template <typename Flow, typename Sdf>
+void semiLagrangianAdvectGroup(const Flow& flow, const Sdf& boundarySdf,
+                               double dt, SemiLagrangianGroup3* group) {
+    const SemiLagrangianLayout3& source = group->source;
+    const SemiLagrangianLayout3& target = group->target;
+    const double h =
+        min3(target.gridSpacing.x, target.gridSpacing.y, target.gridSpacing.z);
+    const Size3 n = target.size;
+    parallelFor(
+        kZeroSize, n.x, kZeroSize, n.y, kZeroSize, n.z,
+        [&](size_t i, size_t j, size_t k) {
+            const Vector3D idx(i, j, k);
+            if (boundarySdf(source.origin + source.gridSpacing * idx) <= 0.0) {
+                return;
+            }
+
+            Vector3D pt = semiLagrangianBackTrace(
+                flow, boundarySdf, dt, h,
+                target.origin + target.gridSpacing * idx);
+
+            if (group->useSamplers) {
+                for (size_t s = 0; s < group->scalarSamplers.size(); ++s) {
+                    group->scalarOutputs[s](i, j, k) =
+                        group->scalarSamplers[s](pt);
+                }
+                for (size_t v = 0; v < group->vectorSamplers.size(); ++v) {
+                    group->vectorOutputs[v](i, j, k) =
+                        group->vectorSamplers[v](pt);
+                }
+                return;
+            }
+
+            const SemiLagrangianStencil3 stencil(pt, source);
+            for (size_t s = 0; s < group->scalarInputs.size(); ++s) {
+                group->scalarOutputs[s](i, j, k) =
+                    stencil(group->scalarInputs[s]);
+            }
+            for (size_t v = 0; v < group->vectorInputs.size(); ++v) {
+                group->vectorOutputs[v](i, j, k) =
+                    stencil(group->vectorInputs[v]);
+            }
+        });
+}
+
+// Advects a group, sampling a FaceCenteredGrid3 flow and a constant or grid
+// boundary without virtual calls and any other flow or boundary through
+// their sample() functions.
+inline void semiLagrangianAdvectGroup(const VectorField3& flow, double dt,
+                                      const ScalarField3& boundarySdf,
+                                      SemiLagrangianGroup3* group) {
+    auto kernel = [&](const auto& flowSampler, const auto& sdf) {
+        semiLagrangianAdvectGroup(flowSampler, sdf, dt, group);
+    };
+
+    if (!dispatchSemiLagrangianLinear3(flow, boundarySdf, kernel)) {
+        kernel([&](const Vector3D& pt) { return flow.sample(pt); },
+               [&](const Vector3D& pt) { return boundarySdf.sample(pt); });
+    }
+}
+
+}  // namespace internal
+
+inline void SemiLagrangian3::advect(const ScalarGrid3& input,
+                                    const VectorField3& flow, double dt,
+                                    ScalarGrid3* output,
+                                    const ScalarField3& boundarySdf) {
+    advectFields({&input}, {output}, {}, {}, flow, dt, boundarySdf);
+}
+
+inline void SemiLagrangian3::advect(const CollocatedVectorGrid3& input,
+                                    const VectorField3& flow, double dt,
+                                    CollocatedVectorGrid3* output,
+                                    const ScalarField3& boundarySdf) {
+    advectFields({}, {}, {&input}, {output}, flow, dt, boundarySdf);
+}
+
+inline void SemiLagrangian3::advect(const FaceCenteredGrid3& input,
+                                    const VectorField3& flow, double dt,
+                                    FaceCenteredGrid3* output,
+                                    const ScalarField3& boundarySdf) {
+    std::function<Vector3D(const Vector3D&)> sampler;
+    if (!hasLinearSamplers()) {
+        sampler = getVectorSamplerFunc(input);
+    }
+
+    // The components have different layouts, so each one is a group.
+    auto advectComponent = [&](const ConstArrayAccessor3<double>& in,
+                               const Vector3D& inOrigin,
+                               ArrayAccessor3<double> out,
+                               const Vector3D& outOrigin, size_t axis) {
+        internal::SemiLagrangianGroup3 group;
+        group.source = {in.size(), input.gridSpacing(), inOrigin};
+        group.target = {out.size(), output->gridSpacing(), outOrigin};
+        group.add(in, out);
+        if (!hasLinearSamplers()) {
+            group.useSamplers = true;
+            group.scalarSamplers.push_back(
+                [&sampler, axis](const Vector3D& pt) {
+                    return sampler(pt)[axis];
+                });
+        }
+        internal::semiLagrangianAdvectGroup(flow, dt, boundarySdf, &group);
+    };
+
+    advectComponent(input.uConstAccessor(), input.uOrigin(),
+                    output->uAccessor(), output->uOrigin(), 0);
+    advectComponent(input.vConstAccessor(), input.vOrigin(),
+                    output->vAccessor(), output->vOrigin(), 1);
+    advectComponent(input.wConstAccessor(), input.wOrigin(),
+                    output->wAccessor(), output->wOrigin(), 2);
+}
+
+inline void SemiLagrangian3::advectFields(
+    const std::vector<const ScalarGrid3*>& scalarInputs,
+    const std::vector<ScalarGrid3*>& scalarOutputs,
+    const std::vector<const CollocatedVectorGrid3*>& vectorInputs,
+    const std::vector<CollocatedVectorGrid3*>& vectorOutputs,
+    const VectorField3& flow, double dt, const ScalarField3& boundarySdf) {
+    JET_THROW_INVALID_ARG_IF(scalarInputs.size() != scalarOutputs.size());
+    JET_THROW_INVALID_ARG_IF(vectorInputs.size() != vectorOutputs.size());
+
+    const bool useSamplers = !hasLinearSamplers();
+
+    // Group the grids by input and output data layout.
+    std::vector<internal::SemiLagrangianGroup3> groups;
+    auto findGroup = [&](const Grid3& input, const Grid3& output,
+                         const Size3& inputSize, const Size3& outputSize,
+                         const Vector3D& inputOrigin,
+                         const Vector3D& outputOrigin) {
+        const internal::SemiLagrangianLayout3 source{
+            inputSize, input.gridSpacing(), inputOrigin};
+        const internal::SemiLagrangianLayout3 target{
+            outputSize, output.gridSpacing(), outputOrigin};
+        for (auto& group : groups) {
+            if (group.source == source && group.target == target) {
+                return &group;
+            }
+        }
+        groups.emplace_back();
+        groups.back().source = source;
+        groups.back().target = target;
+        groups.back().useSamplers = useSamplers;
+        return &groups.back();
+    };
+
+    for (size_t s = 0; s < scalarInputs.size(); ++s) {
+        const ScalarGrid3& input = *scalarInputs[s];
+        ScalarGrid3* output = scalarOutputs[s];
+        auto group =
+            findGroup(input, *output, input.dataSize(), output->dataSize(),
+                      input.dataOrigin(), output->dataOrigin());
+        group->add(input.constDataAccessor(), output->dataAccessor());
+        if (useSamplers) {
+            group->scalarSamplers.push_back(getScalarSamplerFunc(input));
+        }
+    }
+
+    for (size_t v = 0; v < vectorInputs.size(); ++v) {
+        const CollocatedVectorGrid3& input = *vectorInputs[v];
+        CollocatedVectorGrid3* output = vectorOutputs[v];
+        auto group =
+            findGroup(input, *output, input.dataSize(), output->dataSize(),
+                      input.dataOrigin(), output->dataOrigin());
+        group->add(input.constDataAccessor(), output->dataAccessor());
+        if (useSamplers) {
+            group->vectorSamplers.push_back(getVectorSamplerFunc(input));
+        }
+    }
+
+    for (auto& group : groups) {
+        internal::semiLagrangianAdvectGroup(flow, dt, boundarySdf, &group);
+    }
+}
+
+}  // namespace jet
+
+#endif  // INCLUDE_JET_DETAIL_SEMI_LAGRANGIAN3_INL_H_
@@ -238,6 +238,18 @@ class FaceCenteredGrid3 final : public VectorGrid3 {
     //! Returns sampled value at given position \p x.
     Vector3D sample(const Vector3D& x) const override;
 
+    //!
+    //! \brief Samples the points \p x and writes the values to \p results.
+    //!
+    //! The results are identical to calling sample() per point. Along each
+    //! axis, two of the three data components are cell-centered and share
+    //! their fractional coordinates, so a point needs six instead of nine
+    //! coordinate computations. The points are processed in blocks as in
+    //! the batch version of LinearArraySampler3::operator().
+    //!
+    void sample(const ConstArrayAccessor1<Vector3D>& x,
+                ArrayAccessor1<Vector3D> results) const;
+
     //! Returns divergence at given position \p x.
     double divergence(const Vector3D& x) const override;
 
@@ -341,4 +353,6 @@ class FaceCenteredGrid3::Builder final : public VectorGridBuilder3 {
 
 }  // namespace jet
 
+#include "detail/face_centered_grid3-inl.h"
+
 #endif  // INCLUDE_JET_FACE_CENTERED_GRID3_H_
@@ -0,0 +1,159 @@
+// Copyright (c) 2018 Doyub Kim
+//
+// I am making my contributions/submissions to this project solely in my
+// personal capacity and am not conveying any rights to any intellectual
+// property of any third parties.
+
+#ifndef INCLUDE_JET_FDM_AUTO_TUNING_SOLVER3_H_
+#define INCLUDE_JET_FDM_AUTO_TUNING_SOLVER3_H_
+
+#include <jet/fdm_mg_solver3.h>
+
+#include <vector>
+
+namespace jet {
+
+//!
+//! \brief 3-D finite difference-type linear system solver that picks the
+//!        fastest of several candidate solvers.
+//!
+//! While tuning, successive solves are handed to the candidates in turn and
+//! timed on the actual systems. Each candidate is measured on
+//! numberOfTuningSolves() solves, and its cost is the total wall-clock time
+//! divided by the total decades of residual reduction. Once every candidate
+//! has been measured, the cheapest one that reached the tolerance in all of
+//! its solves is locked in and used for all subsequent solves. Tuning
+//! restarts when the grid resolution changes or the fraction of fluid cells
+//! drifts by more than fluidFractionTolerance() relative to the tuned state.
+//!
+//! The solver derives from FdmMgSolver3 so that pressure solvers build the
+//! multigrid hierarchy for it. Multigrid candidates solve the hierarchy while
+//! the other candidates solve its finest level for the correction of the
+//! current solution, so every candidate starts from the same initial guess.
+//! Only the multigrid entry point is supported: solve(FdmLinearSystem3*) is
+//! the no-op of FdmMgSolver3 and solveCompressed() throws.
+//!
+//! The hierarchy is only needed while tuning or by a multigrid candidate.
+//! Once a non-multigrid candidate is locked in, params() reports a single
+//! level so that the pressure solvers stop building the coarse levels, and
+//! the full depth is requested again when tuning restarts.
+//!
+class FdmAutoTuningSolver3 final : public FdmMgSolver3 {
+ public:
+    //!
+    //! Constructs the solver with CG, ICCG, MG and MGPCG as candidates.
+    //!
+    //! \param maxNumberOfIterations - Max number of iterations of the Krylov
+    //!                               candidates.
+    //! \param tolerance - Residual tolerance of all candidates.
+    //! \param maxNumberOfLevels - Number of multigrid levels.
+    //!
+    FdmAutoTuningSolver3(unsigned int maxNumberOfIterations, double tolerance,
+                         size_t maxNumberOfLevels);
+
+    //! Solves the given linear system with the selected or next candidate.
+    bool solve(FdmMgLinearSystem3* system) override;
+
+    //! Throws std::invalid_argument; compressed systems are not supported.
+    bool solveCompressed(FdmCompressedLinearSystem3* system) override;
+
+    //! Returns the last number of iterations of the last used candidate.
+    unsigned int lastNumberOfIterations() const override;
+
+    //! Returns the last residual of the last used candidate.
+    double lastResidual() const override;
+
+    //! Sets the wall-clock budget of every candidate.
+    void setTimeBudget(double seconds) override;
+
+    //! Returns true if the last used candidate hit the time budget.
+    bool lastSolveHitTimeBudget() const override;
+
+    //! Adds a candidate solver, hands it the time budget and restarts tuning.
+    void addCandidate(const FdmLinearSystemSolver3Ptr& solver);
+
+    //! Removes all candidate solvers.
+    void clearCandidates();
+
+    //! Returns the number of candidate solvers.
+    size_t numberOfCandidates() const;
+
+    //! Returns the i-th candidate solver.
+    const FdmLinearSystemSolver3Ptr& candidate(size_t i) const;
+
+    //!
+    //! Returns the measured cost of the i-th candidate in seconds per decade
+    //! of residual reduction, or a negative value if not measured yet.
+    //!
+    double candidateCost(size_t i) const;
+
+    //!
+    //! Returns the average number of iterations of the i-th candidate over
+    //! its tuning solves, or a negative value if not measured yet.
+    //!
+    double candidateIterations(size_t i) const;
+
+    //! Returns the number of solves each candidate is measured on.
+    unsigned int numberOfTuningSolves() const;
+
+    //! Sets the number of solves each candidate is measured on and retunes.
+    void setNumberOfTuningSolves(unsigned int numberOfSolves);
+
+    //! Returns true if the candidates are still being measured.
+    bool isTuning() const;
+
+    //! Returns the locked-in solver, or nullptr while tuning.
+    FdmLinearSystemSolver3Ptr selectedSolver() const;
+
+    //! Discards the measurements and starts tuning again.
+    void retune();
+
+    //! Returns the relative fluid fraction change that triggers retuning.
+    double fluidFractionTolerance() const;
+
+    //! Sets the relative fluid fraction change that triggers retuning.
+    void setFluidFractionTolerance(double tolerance);
+
+ private:
+    struct Candidate {
+        FdmLinearSystemSolver3Ptr solver;
+        unsigned int numberOfSolves = 0;
+        double seconds = 0.0;
+        double decades = 0.0;
+        double iterations = 0.0;
+        bool converged = true;
+    };
+
+    std::vector<Candidate> _candidates;
+    size_t _maxNumberOfLevels;
+    size_t _selected = kMaxSize;
+    size_t _nextCandidate = 0;
+    size_t _numberOfMeasurements = 0;
+    unsigned int _numberOfTuningSolves = 3;
+    FdmLinearSystemSolver3Ptr _lastSolver;
+
+    Size3 _tunedResolution;
+    double _tunedFluidFraction = 0.0;
+    double _fluidFractionTolerance = 0.25;
+
+    FdmLinearSystem3 _finestSystem;
+    FdmVector3 _residual;
+
+    bool solveWith(const FdmLinearSystemSolver3Ptr& solver,
+                   FdmMgLinearSystem3* system);
+
+    void selectCandidate();
+
+    static double cost(const Candidate& candidate);
+
+    static double fluidFraction(const FdmMatrix3& A);
+};
+
+//! Shared pointer type for the FdmAutoTuningSolver3.
+typedef std::shared_ptr<FdmAutoTuningSolver3> FdmAutoTuningSolver3Ptr;
+
+}  // namespace jet
+
+#include "detail/fdm_auto_tuning_solver3-inl.h"
+
+#endif  // INCLUDE_JET_FDM_AUTO_TUNING_SOLVER3_H_
@@ -0,0 +1,100 @@
+// Copyright (c) 2018 Doyub Kim
+//
+// I am making my contributions/submissions to this project solely in my
+// personal capacity and am not conveying any rights to any intellectual
+// property of any third parties.
+
+#ifndef INCLUDE_JET_FDM_BATCH_LINEAR_SYSTEM3_H_
+#define INCLUDE_JET_FDM_BATCH_LINEAR_SYSTEM3_H_
+
+#include <jet/fdm_linear_system3.h>
+#include <jet/vector.h>
+
+namespace jet {
+
+//!
+//! \brief Batched vector type for 3-D finite differencing.
+//!
+//! Each grid point stores the values of K right-hand sides (or solutions)
+//! next to each other, so a single pass over the matrix serves all of them.
+//!
+template <size_t K>
+using FdmBatchVector3 = Array3<Vector<double, K>>;
+
+//! Linear system (AX=B) for 3-D finite differencing with K right-hand sides
+//! sharing one matrix.
+template <size_t K>
+struct FdmBatchLinearSystem3 {
+    //! System matrix.
+    FdmMatrix3 A;
+
+    //! Solution vectors.
+    FdmBatchVector3<K> x;
+
+    //! RHS vectors.
+    FdmBatchVector3<K> b;
+
+    //! Clears all the data.
+    void clear();
+
+    //! Resizes the arrays with given grid size.
+    void resize(const Size3& size);
+};
+
+//!
+//! \brief Batched BLAS operator wrapper for 3-D finite differencing.
+//!
+//! This wrapper follows FdmBlas3 except that the scalars are K-vectors; dot
+//! products and norms are evaluated per right-hand side, and axpy takes a
+//! separate coefficient for each of them.
+//!
+template <size_t K>
+struct FdmBatchBlas3 {
+    typedef Vector<double, K> ScalarType;
+    typedef FdmBatchVector3<K> VectorType;
+    typedef FdmMatrix3 MatrixType;
+
+    //! Number of right-hand sides.
+    static constexpr size_t kNumberOfRhs = K;
+
+    //! Sets entire element of given vector \p result with scalar \p s.
+    static void set(double s, VectorType* result);
+
+    //! Copies entire element of given vector \p result with other vector \p v.
+    static void set(const VectorType& v, VectorType* result);
+
+    //! Performs dot products of each right-hand side of \p a and \p b.
+    static ScalarType dot(const VectorType& a, const VectorType& b);
+
+    //! Performs ax + y operation per right-hand side.
+    static void axpy(const ScalarType& a, const VectorType& x,
+                     const VectorType& y, VectorType* result);
+
+    //! Performs matrix-vector multiplication for all right-hand sides.
+    static void mvm(const MatrixType& m, const VectorType& v,
+                    VectorType* result);
+
+    //! Computes residual vectors (b - ax) for all right-hand sides.
+    static void residual(const MatrixType& a, const VectorType& x,
+                         const VectorType& b, VectorType* result);
+
+    //! Returns L2-norm of each right-hand side of \p v.
+    static ScalarType l2Norm(const VectorType& v);
+
+    //! Returns Linf-norm of each right-hand side of \p v.
+    static ScalarType lInfNorm(const VectorType& v);
+
+    //! Copies \p v into the \p k-th right-hand side of \p result.
+    static void setComponent(const FdmVector3& v, size_t k,
+                             VectorType* result);
+
+    //! Copies the \p k-th right-hand side of \p v into \p result.
+    static void getComponent(const VectorType& v, size_t k,
+                             FdmVector3* result);
+};
+
+}  // namespace jet
+
+#include "detail/fdm_batch_linear_system3-inl.h"
+
+#endif  // INCLUDE_JET_FDM_BATCH_LINEAR_SYSTEM3_H_
@@ -0,0 +1,62 @@
+// Copyright (c) 2018 Doyub Kim
+//
+// I am making my contributions/submissions to this project solely in my
+// personal capacity and am not conveying any rights to any intellectual
+// property of any third parties.
+
+#ifndef INCLUDE_JET_FDM_BLOCKED_SMOOTHER3_H_
+#define INCLUDE_JET_FDM_BLOCKED_SMOOTHER3_H_
+
+#include <jet/fdm_gauss_seidel_solver3.h>
+#include <jet/fdm_jacobi_solver3.h>
+#include <jet/mg.h>
+
+namespace jet {
+
+//!
+//! \brief Temporally blocked relaxation smoother for Multigrid.
+//!
+//! relaxFunc() returns a function that can be plugged into
+//! MgParameters::relaxFunc. All the iterations of a relax call run as a
+//! single wavefront through FdmJacobiSolver3::relaxBlocked,
+//! FdmGaussSeidelSolver3::relaxBlocked, or
+//! FdmGaussSeidelSolver3::relaxRedBlackBlocked, which gives the same result
+//! as the per-iteration relaxation with much less memory traffic.
+//!
+class FdmBlockedSmoother3 final {
+ public:
+    //! Relaxation method of the smoother.
+    enum class Method {
+        //! Jacobi; uses the Multigrid buffer as the second iterate.
+        kJacobi,
+
+        //! Gauss-Seidel in natural order with SOR.
+        kGaussSeidel,
+
+        //! Red-black Gauss-Seidel with SOR.
+        kRedBlackGaussSeidel
+    };
+
+    //! Constructs the smoother with given parameters.
+    explicit FdmBlockedSmoother3(Method method = Method::kGaussSeidel,
+                                 double sorFactor = 1.5);
+
+    //! Returns the relaxation method.
+    Method method() const;
+
+    //! Returns the SOR (Successive Over Relaxation) factor.
+    double sorFactor() const;
+
+    //! Returns the relax function.
+    MgRelaxFunc<FdmBlas3> relaxFunc() const;
+
+ private:
+    Method _method;
+    double _sorFactor;
+};
+
+}  // namespace jet
+
+#include "detail/fdm_blocked_smoother3-inl.h"
+
+#endif  // INCLUDE_JET_FDM_BLOCKED_SMOOTHER3_H_
@@ -8,11 +8,17 @@
 #define INCLUDE_JET_FDM_CG_SOLVER3_H_
 
 #include <jet/fdm_linear_system_solver3.h>
+#include <jet/fdm_solver_workspace3.h>
 
 namespace jet {
 
 //! \brief 3-D finite difference-type linear system solver using conjugate
 //!        gradient.
+//!
+//! \note solve(), solveCompressed(), clearUncompressedVectors() and
+//!     clearCompressedVectors() are defined in detail/fdm_cg_solver3-inl.h,
+//!     not in fdm_cg_solver3.cpp.
+//!
 class FdmCgSolver3 final : public FdmLinearSystemSolver3 {
  public:
     //! Constructs the solver with given parameters.
@@ -24,17 +30,26 @@ class FdmCgSolver3 final : public FdmLinearSystemSolver3 {
     //! Solves the given compressed linear system.
     bool solveCompressed(FdmCompressedLinearSystem3* system) override;
 
+    //! Returns the shared scratch vector workspace, if any.
+    const FdmSolverWorkspace3Ptr& workspace() const;
+
+    //!
+    //! Sets the workspace to borrow scratch vectors from. If nullptr, the
+    //! solver keeps its own scratch vectors.
+    //!
+    void setWorkspace(const FdmSolverWorkspace3Ptr& workspace);
+
     //! Returns the max number of CG iterations.
     unsigned int maxNumberOfIterations() const;
 
     //! Returns the last number of CG iterations the solver made.
-    unsigned int lastNumberOfIterations() const;
+    unsigned int lastNumberOfIterations() const override;
 
     //! Returns the max residual tolerance for the CG method.
     double tolerance() const;
 
     //! Returns the last residual after the CG iterations.
-    double lastResidual() const;
+    double lastResidual() const override;
 
  private:
     unsigned int _maxNumberOfIterations;
@@ -42,17 +57,13 @@ class FdmCgSolver3 final : public FdmLinearSystemSolver3 {
     double _tolerance;
     double _lastResidual;
 
+    FdmSolverWorkspace3Ptr _workspace;
+
     // Uncompressed vectors
-    FdmVector3 _r;
-    FdmVector3 _d;
-    FdmVector3 _q;
-    FdmVector3 _s;
+    FdmPcgScratch3<FdmBlas3> _pcg;
 
     // Compressed vectors
-    VectorND _rComp;
-    VectorND _dComp;
-    VectorND _qComp;
-    VectorND _sComp;
+    FdmPcgScratch3<FdmCompressedBlas3> _pcgComp;
 
     void clearUncompressedVectors();
     void clearCompressedVectors();
@@ -63,4 +74,6 @@ typedef std::shared_ptr<FdmCgSolver3> FdmCgSolver3Ptr;
 
 }  // namespace jet
 
+#include "detail/fdm_cg_solver3-inl.h"
+
 #endif  // INCLUDE_JET_FDM_CG_SOLVER3_H_
@@ -0,0 +1,91 @@
+// Copyright (c) 2018 Doyub Kim
+//
+// I am making my contributions/submissions to this project solely in my
+// personal capacity and am not conveying any rights to any intellectual
+// property of any third parties.
+
+#ifndef INCLUDE_JET_FDM_CHEBYSHEV_SOLVER3_H_
+#define INCLUDE_JET_FDM_CHEBYSHEV_SOLVER3_H_
+
+#include <jet/chebyshev.h>
+#include <jet/fdm_linear_system_solver3.h>
+#include <jet/fdm_solver_workspace3.h>
+
+namespace jet {
+
+//!
+//! \brief 3-D finite difference-type linear system solver using conjugate
+//!        gradient with Chebyshev polynomial preconditioner.
+//!
+//! Unlike ICCG, applying the preconditioner only needs matrix-vector products
+//! and vector updates, so every step parallelizes without coloring.
+//!
+class FdmChebyshevSolver3 final : public FdmLinearSystemSolver3 {
+ public:
+    //! Constructs the solver with given parameters.
+    FdmChebyshevSolver3(
+        unsigned int maxNumberOfIterations, double tolerance,
+        unsigned int polynomialDegree = 4,
+        const ChebyshevParameters& params = ChebyshevParameters());
+
+    //! Solves the given linear system.
+    bool solve(FdmLinearSystem3* system) override;
+
+    //! Solves the given compressed linear system.
+    bool solveCompressed(FdmCompressedLinearSystem3* system) override;
+
+    //! Returns the shared scratch vector workspace, if any.
+    const FdmSolverWorkspace3Ptr& workspace() const;
+
+    //!
+    //! Sets the workspace to borrow scratch vectors from. If nullptr, the
+    //! solver keeps its own scratch vectors.
+    //!
+    void setWorkspace(const FdmSolverWorkspace3Ptr& workspace);
+
+    //! Returns the max number of CG iterations.
+    unsigned int maxNumberOfIterations() const;
+
+    //! Returns the last number of CG iterations the solver made.
+    unsigned int lastNumberOfIterations() const override;
+
+    //! Returns the max residual tolerance for the CG method.
+    double tolerance() const;
+
+    //! Returns the last residual after the CG iterations.
+    double lastResidual() const override;
+
+    //! Returns the number of Chebyshev iterations per preconditioner solve.
+    unsigned int polynomialDegree() const;
+
+    //! Returns the Chebyshev parameters.
+    const ChebyshevParameters& params() const;
+
+ private:
+    unsigned int _maxNumberOfIterations;
+    unsigned int _lastNumberOfIterations = 0;
+    double _tolerance;
+    double _lastResidualNorm = 0.0;
+
+    FdmSolverWorkspace3Ptr _workspace;
+
+    // Uncompressed vectors and preconditioner
+    FdmPcgScratch3<FdmBlas3> _pcg;
+    ChebyshevPreconditioner<FdmBlas3> _precond;
+
+    // Compressed vectors and preconditioner
+    FdmPcgScratch3<FdmCompressedBlas3> _pcgComp;
+    ChebyshevPreconditioner<FdmCompressedBlas3> _precondComp;
+
+    void clearUncompressedVectors();
+    void clearCompressedVectors();
+};
+
+//! Shared pointer type for the FdmChebyshevSolver3.
+typedef std::shared_ptr<FdmChebyshevSolver3> FdmChebyshevSolver3Ptr;
+
+}  // namespace jet
+
+#include "detail/fdm_chebyshev_solver3-inl.h"
+
+#endif  // INCLUDE_JET_FDM_CHEBYSHEV_SOLVER3_H_
@@ -0,0 +1,104 @@
+// Copyright (c) 2018 Doyub Kim
+//
+// I am making my contributions/submissions to this project solely in my
+// personal capacity and am not conveying any rights to any intellectual
+// property of any third parties.
+
+#ifndef INCLUDE_JET_FDM_COMPRESSED_LINEAR_SYSTEM_BUILDER3_H_
+#define INCLUDE_JET_FDM_COMPRESSED_LINEAR_SYSTEM_BUILDER3_H_
+
+#include <jet/array3.h>
+#include <jet/fdm_linear_system3.h>
+#include <jet/point3.h>
+
+#include <vector>
+
+namespace jet {
+
+//!
+//! \brief Parallel builder for FdmCompressedLinearSystem3.
+//!
+//! This class maps the active cells of a grid (typically the fluid cells) to
+//! the rows of a compressed linear system and assembles the system without
+//! any serial pass over the grid. Cells are numbered in the same i-fastest
+//! order as a serial walk, using a parallel count and prefix sum over the
+//! grid lines. The CSR matrix is then filled directly: each row counts its
+//! active neighbors, a prefix sum gives the row pointers, and every row writes
+//! its own column indices and values. The columns of a row are sorted.
+//!
+//! The numbering is kept so that vectors can be compressed and decompressed
+//! in parallel as well.
+//!
+//! \code{.cpp}
+//! FdmMatrixFree3 op(markers.constAccessor(), gridSpacing);
+//!
+//! FdmCompressedLinearSystemBuilder3 builder;
+//! builder.numberCells(markers.size(), [&](size_t i, size_t j, size_t k) {
+//!     return markers(i, j, k) == FdmMatrixFree3::kFluid;
+//! });
+//! builder.buildMatrix(op, &system.A);
+//! builder.compress(divergenceFunc, &system.b);
+//! \endcode
+//!
+class FdmCompressedLinearSystemBuilder3 {
+ public:
+    //!
+    //! \brief Numbers the cells for which \p isActive returns true.
+    //!
+    //! \param size - The resolution of the grid.
+    //! \param isActive - Function (i, j, k) -> bool that selects the cells.
+    //!
+    template <typename ActiveFunction>
+    void numberCells(const Size3& size, const ActiveFunction& isActive);
+
+    //! Returns the resolution of the numbered grid.
+    Size3 size() const;
+
+    //! Returns the number of active cells, i.e. rows of the system.
+    size_t numberOfRows() const;
+
+    //! Returns the row of the cell (i, j, k), or kMaxSize if inactive.
+    size_t row(size_t i, size_t j, size_t k) const;
+
+    //! Returns the row index per cell, with kMaxSize for inactive cells.
+    const Array3<size_t>& coordToIndex() const;
+
+    //! Returns the cell index per row.
+    const std::vector<Point3UI>& indexToCoord() const;
+
+    //!
+    //! \brief Assembles the compressed matrix from a 7-point operator.
+    //!
+    //! The operator provides center(i, j, k), right(i, j, k), up(i, j, k) and
+    //! front(i, j, k) as in FdmMatrixFree3, and is assumed to be symmetric.
+    //! Each row gets the diagonal and one entry per active face neighbor.
+    //!
+    template <typename Operator>
+    void buildMatrix(const Operator& op, MatrixCsrD* matrix) const;
+
+    //! Assembles the compressed matrix from an uncompressed matrix.
+    void buildMatrix(const FdmMatrix3& matrix, MatrixCsrD* result) const;
+
+    //! Evaluates \p func (i, j, k) -> double at every active cell.
+    template <typename Function>
+    void compress(const Function& func, VectorND* result) const;
+
+    //! Gathers the active cells of \p vector.
+    void compress(const FdmVector3& vector, VectorND* result) const;
+
+    //! Scatters \p vector to the active cells and zeros the others.
+    void decompress(const VectorND& vector, FdmVector3* result) const;
+
+    //! Clears the numbering.
+    void clear();
+
+ private:
+    Array3<size_t> _coordToIndex;
+    std::vector<Point3UI> _indexToCoord;
+};
+
+}  // namespace jet
+
+#include "detail/fdm_compressed_linear_system_builder3-inl.h"
+
+#endif  // INCLUDE_JET_FDM_COMPRESSED_LINEAR_SYSTEM_BUILDER3_H_
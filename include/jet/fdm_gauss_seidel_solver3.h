@@ -31,13 +31,13 @@ class FdmGaussSeidelSolver3 final : public FdmLinearSystemSolver3 {
     unsigned int maxNumberOfIterations() const;
 
     //! Returns the last number of Gauss-Seidel iterations the solver made.
-    unsigned int lastNumberOfIterations() const;
+    unsigned int lastNumberOfIterations() const override;
 
     //! Returns the max residual tolerance for the Gauss-Seidel method.
     double tolerance() const;
 
     //! Returns the last residual after the Gauss-Seidel iterations.
-    double lastResidual() const;
+    double lastResidual() const override;
 
     //! Returns the SOR (Successive Over Relaxation) factor.
     double sorFactor() const;
@@ -58,6 +58,32 @@ class FdmGaussSeidelSolver3 final : public FdmLinearSystemSolver3 {
     static void relaxRedBlack(const FdmMatrix3& A, const FdmVector3& b,
                               double sorFactor, FdmVector3* x);
 
+    //!
+    //! \brief Performs multiple natural Gauss-Seidel relaxation steps with
+    //!        temporal blocking.
+    //!
+    //! The result is the same as calling relax() \p numberOfIterations
+    //! times. The iterations are pipelined over the z-layers as a wavefront,
+    //! which keeps the active layers in cache and lets layers of different
+    //! iterations run in parallel. Each layer is split into x/y tiles that
+    //! run in parallel along tile diagonals.
+    //!
+    static void relaxBlocked(const FdmMatrix3& A, const FdmVector3& b,
+                             double sorFactor, unsigned int numberOfIterations,
+                             FdmVector3* x);
+
+    //!
+    //! \brief Performs multiple Red-Black Gauss-Seidel relaxation steps with
+    //!        temporal blocking.
+    //!
+    //! The result is the same as calling relaxRedBlack()
+    //! \p numberOfIterations times.
+    //!
+    static void relaxRedBlackBlocked(const FdmMatrix3& A, const FdmVector3& b,
+                                     double sorFactor,
+                                     unsigned int numberOfIterations,
+                                     FdmVector3* x);
+
  private:
     unsigned int _maxNumberOfIterations;
     unsigned int _lastNumberOfIterations;
@@ -82,4 +108,6 @@ typedef std::shared_ptr<FdmGaussSeidelSolver3> FdmGaussSeidelSolver3Ptr;
 
 }  // namespace jet
 
+#include "detail/fdm_gauss_seidel_solver3-inl.h"
+
 #endif  // INCLUDE_JET_FDM_GAUSS_SEIDEL_SOLVER3_H_
@@ -15,6 +15,10 @@ namespace jet {
 //! \brief 3-D finite difference-type linear system solver using incomplete
 //!        Cholesky conjugate gradient (ICCG).
 //!
+//! \note solve(), solveCompressed(), clearUncompressedVectors() and
+//!     clearCompressedVectors() are defined in
+//!     detail/fdm_iccg_solver3-inl.h, not in fdm_iccg_solver3.cpp.
+//!
 class FdmIccgSolver3 final : public FdmLinearSystemSolver3 {
  public:
     //! Constructs the solver with given parameters.
@@ -26,17 +30,26 @@ class FdmIccgSolver3 final : public FdmLinearSystemSolver3 {
     //! Solves the given compressed linear system.
     bool solveCompressed(FdmCompressedLinearSystem3* system) override;
 
+    //! Returns the shared scratch vector workspace, if any.
+    const FdmSolverWorkspace3Ptr& workspace() const;
+
+    //!
+    //! Sets the workspace to borrow scratch vectors from. If nullptr, the
+    //! solver keeps its own scratch vectors.
+    //!
+    void setWorkspace(const FdmSolverWorkspace3Ptr& workspace);
+
     //! Returns the max number of ICCG iterations.
     unsigned int maxNumberOfIterations() const;
 
     //! Returns the last number of ICCG iterations the solver made.
-    unsigned int lastNumberOfIterations() const;
+    unsigned int lastNumberOfIterations() const override;
 
     //! Returns the max residual tolerance for the ICCG method.
     double tolerance() const;
 
     //! Returns the last residual after the ICCG iterations.
-    double lastResidual() const;
+    double lastResidual() const override;
 
  private:
     struct Preconditioner final {
@@ -64,18 +77,14 @@ class FdmIccgSolver3 final : public FdmLinearSystemSolver3 {
     double _tolerance;
     double _lastResidualNorm;
 
+    FdmSolverWorkspace3Ptr _workspace;
+
     // Uncompressed vectors and preconditioner
-    FdmVector3 _r;
-    FdmVector3 _d;
-    FdmVector3 _q;
-    FdmVector3 _s;
+    FdmPcgScratch3<FdmBlas3> _pcg;
     Preconditioner _precond;
 
     // Compressed vectors and preconditioner
-    VectorND _rComp;
-    VectorND _dComp;
-    VectorND _qComp;
-    VectorND _sComp;
+    FdmPcgScratch3<FdmCompressedBlas3> _pcgComp;
     PreconditionerCompressed _precondComp;
 
     void clearUncompressedVectors();
@@ -87,4 +96,6 @@ typedef std::shared_ptr<FdmIccgSolver3> FdmIccgSolver3Ptr;
 
 }  // namespace jet
 
+#include "detail/fdm_iccg_solver3-inl.h"
+
 #endif  // INCLUDE_JET_FDM_ICCG_SOLVER3_H_
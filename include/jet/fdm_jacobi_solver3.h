@@ -28,13 +28,13 @@ class FdmJacobiSolver3 final : public FdmLinearSystemSolver3 {
     unsigned int maxNumberOfIterations() const;
 
     //! Returns the last number of Jacobi iterations the solver made.
-    unsigned int lastNumberOfIterations() const;
+    unsigned int lastNumberOfIterations() const override;
 
     //! Returns the max residual tolerance for the Jacobi method.
     double tolerance() const;
 
     //! Returns the last residual after the Jacobi iterations.
-    double lastResidual() const;
+    double lastResidual() const override;
 
     //! Performs single Jacobi relaxation step.
     static void relax(const FdmMatrix3& A, const FdmVector3& b, FdmVector3* x,
@@ -44,6 +44,20 @@ class FdmJacobiSolver3 final : public FdmLinearSystemSolver3 {
     static void relax(const MatrixCsrD& A, const VectorND& b, VectorND* x,
                       VectorND* xTemp);
 
+    //!
+    //! \brief Performs multiple Jacobi relaxation steps with temporal
+    //!        blocking.
+    //!
+    //! The result is the same as calling relax() \p numberOfIterations
+    //! times, but the iterations are pipelined over the z-layers so that each
+    //! layer is relaxed several times while it stays in cache, instead of
+    //! streaming the whole matrix and vectors from memory per iteration. Each
+    //! layer is split into x/y tiles that run in parallel.
+    //!
+    static void relaxBlocked(const FdmMatrix3& A, const FdmVector3& b,
+                             unsigned int numberOfIterations, FdmVector3* x,
+                             FdmVector3* xTemp);
+
  private:
     unsigned int _maxNumberOfIterations;
     unsigned int _lastNumberOfIterations;
@@ -68,4 +82,6 @@ typedef std::shared_ptr<FdmJacobiSolver3> FdmJacobiSolver3Ptr;
 
 }  // namespace jet
 
+#include "detail/fdm_jacobi_solver3-inl.h"
+
 #endif  // INCLUDE_JET_FDM_JACOBI_SOLVER3_H_
@@ -35,6 +35,27 @@ typedef Array3<double> FdmVector3;
 //! Matrix type for 3-D finite differencing.
 typedef Array3<FdmMatrixRow3> FdmMatrix3;
 
+//! Single-precision row of FdmMatrix3F.
+struct FdmMatrixRow3F {
+    //! Diagonal component of the matrix (row, row).
+    float center = 0.f;
+
+    //! Off-diagonal element where colum refers to (i+1, j, k) grid point.
+    float right = 0.f;
+
+    //! Off-diagonal element where column refers to (i, j+1, k) grid point.
+    float up = 0.f;
+
+    //! OFf-diagonal element where column refers to (i, j, k+1) grid point.
+    float front = 0.f;
+};
+
+//! Single-precision vector type for 3-D finite differencing.
+typedef Array3<float> FdmVector3F;
+
+//! Single-precision matrix type for 3-D finite differencing.
+typedef Array3<FdmMatrixRow3F> FdmMatrix3F;
+
 //! Linear system (Ax=b) for 3-D finite differencing.
 struct FdmLinearSystem3 {
     //! System matrix.
@@ -130,6 +151,95 @@ struct FdmCompressedBlas3 {
     //! Performs dot product with vector \p a and \p b.
     static double dot(const VectorType& a, const VectorType& b);
 
+    //! Performs ax + y operation where \p a is a matrix and \p x and \p y are
+    //! vectors.
+    static void axpy(double a, const VectorType& x, const VectorType& y,
+                     VectorType* result);
+
+    //! Performs matrix-vector multiplication using the row-parallel CSR
+    //! kernel.
+    static void mvm(const MatrixType& m, const VectorType& v,
+                    VectorType* result);
+
+    //! Computes residual vector (b - ax) using the row-parallel CSR kernel.
+    static void residual(const MatrixType& a, const VectorType& x,
+                         const VectorType& b, VectorType* result);
+
+    //! Returns L2-norm of the given vector \p v.
+    static ScalarType l2Norm(const VectorType& v);
+
+    //! Returns Linf-norm of the given vector \p v.
+    static ScalarType lInfNorm(const VectorType& v);
+};
+
+//!
+//! \brief Single-precision BLAS operator wrapper for 3-D finite differencing.
+//!
+//! Vectors and matrices are stored in float to halve the memory traffic while
+//! dot products and norms are accumulated in double.
+//!
+struct FdmBlas3F {
+    typedef float ScalarType;
+    typedef FdmVector3F VectorType;
+    typedef FdmMatrix3F MatrixType;
+
+    //! Sets entire element of given vector \p result with scalar \p s.
+    static void set(ScalarType s, VectorType* result);
+
+    //! Copies entire element of given vector \p result with other vector \p v.
+    static void set(const VectorType& v, VectorType* result);
+
+    //! Sets entire element of given matrix \p result with scalar \p s.
+    static void set(ScalarType s, MatrixType* result);
+
+    //! Copies entire element of given matrix \p result with other matrix \p v.
+    static void set(const MatrixType& m, MatrixType* result);
+
+    //! Performs dot product with vector \p a and \p b.
+    static double dot(const VectorType& a, const VectorType& b);
+
+    //! Performs ax + y operation where \p a is a matrix and \p x and \p y are
+    //! vectors.
+    static void axpy(double a, const VectorType& x, const VectorType& y,
+                     VectorType* result);
+
+    //! Performs matrix-vector multiplication.
+    static void mvm(const MatrixType& m, const VectorType& v,
+                    VectorType* result);
+
+    //! Computes residual vector (b - ax).
+    static void residual(const MatrixType& a, const VectorType& x,
+                         const VectorType& b, VectorType* result);
+
+    //! Returns L2-norm of the given vector \p v.
+    static ScalarType l2Norm(const VectorType& v);
+
+    //! Returns Linf-norm of the given vector \p v.
+    static ScalarType lInfNorm(const VectorType& v);
+};
+
+//! Single-precision BLAS operator wrapper for compressed 3-D finite
+//! differencing.
+struct FdmCompressedBlas3F {
+    typedef float ScalarType;
+    typedef VectorNF VectorType;
+    typedef MatrixCsrF MatrixType;
+
+    //! Sets entire element of given vector \p result with scalar \p s.
+    static void set(ScalarType s, VectorType* result);
+
+    //! Copies entire element of given vector \p result with other vector \p v.
+    static void set(const VectorType& v, VectorType* result);
+
+    //! Sets entire element of given matrix \p result with scalar \p s.
+    static void set(ScalarType s, MatrixType* result);
+
+    //! Copies entire element of given matrix \p result with other matrix \p v.
+    static void set(const MatrixType& m, MatrixType* result);
+
+    //! Performs dot product with vector \p a and \p b.
+    static double dot(const VectorType& a, const VectorType& b);
+
     //! Performs ax + y operation where \p a is a matrix and \p x and \p y are
     //! vectors.
     static void axpy(double a, const VectorType& x, const VectorType& y,
@@ -152,4 +262,6 @@ struct FdmCompressedBlas3 {
 
 }  // namespace jet
 
+#include "detail/fdm_linear_system3-inl.h"
+
 #endif  // INCLUDE_JET_FDM_LINEAR_SYSTEM3_H_
@@ -7,7 +7,11 @@
 #ifndef INCLUDE_JET_FDM_LINEAR_SYSTEM_SOLVER3_H_
 #define INCLUDE_JET_FDM_LINEAR_SYSTEM_SOLVER3_H_
 
+#include <jet/constants.h>
 #include <jet/fdm_linear_system3.h>
+#include <jet/timer.h>
+
+#include <algorithm>
 
 #include <memory>
 
@@ -25,6 +29,44 @@ class FdmLinearSystemSolver3 {
 
     //! Solves the given compressed linear system.
     virtual bool solveCompressed(FdmCompressedLinearSystem3*) { return false; }
+
+    //! Returns the last number of iterations the solver made.
+    virtual unsigned int lastNumberOfIterations() const { return 0; }
+
+    //! Returns the last residual after the iterations.
+    virtual double lastResidual() const { return 0.0; }
+
+    //! Returns the wall-clock budget of a single solve in seconds.
+    double timeBudget() const { return _timeBudget; }
+
+    //!
+    //! \brief Sets the wall-clock budget of a single solve in seconds.
+    //!
+    //! A solver that honors the budget stops iterating once the budget runs
+    //! out, even if neither the tolerance nor the max number of iterations
+    //! has been reached, and reports the achieved residual through
+    //! lastResidual(). kMaxD (default) disables the budget.
+    //!
+    virtual void setTimeBudget(double seconds) {
+        _timeBudget = std::max(seconds, 0.0);
+    }
+
+    //! Returns true if the last solve was cut short by the time budget.
+    virtual bool lastSolveHitTimeBudget() const {
+        return _lastSolveHitTimeBudget;
+    }
+
+ protected:
+    double _timeBudget = kMaxD;
+    bool _lastSolveHitTimeBudget = false;
+
+    //! Returns the budget left for the solve that started at \p timer.
+    double remainingTimeBudget(const Timer& timer) const {
+        if (_timeBudget >= kMaxD) {
+            return kMaxD;
+        }
+        return std::max(_timeBudget - timer.durationInSeconds(), 0.0);
+    }
 };
 
 //! Shared pointer type for the FdmLinearSystemSolver3.
@@ -0,0 +1,154 @@
+// Copyright (c) 2018 Doyub Kim
+//
+// I am making my contributions/submissions to this project solely in my
+// personal capacity and am not conveying any rights to any intellectual
+// property of any third parties.
+
+#ifndef INCLUDE_JET_FDM_MATRIX_FREE3_H_
+#define INCLUDE_JET_FDM_MATRIX_FREE3_H_
+
+#include <jet/array_accessor3.h>
+#include <jet/fdm_linear_system3.h>
+#include <jet/vector3.h>
+
+namespace jet {
+
+//!
+//! \brief Matrix-free 7-point Poisson operator for 3-D finite differencing.
+//!
+//! Instead of storing a FdmMatrixRow3 (32 bytes) per cell, this operator
+//! computes the stencil on the fly from a compact representation of the
+//! domain. Two representations are supported:
+//!
+//! - Blocked boundaries: one char marker (kFluid, kAir or kBoundary) per cell,
+//!   as in GridSinglePhasePressureSolver3.
+//! - Fractional boundaries: float face weights and cell-centered fluid SDF,
+//!   as in GridFractionalSinglePhasePressureSolver3, including the ghost
+//!   fluid treatment of the free surface.
+//!
+//! The operator only references the input arrays, so they must outlive it.
+//! It is set up once by its constructor and can be copied but not assigned.
+//! It produces exactly the same stencil as the assembled FdmMatrix3 of the
+//! corresponding pressure solver.
+//!
+struct FdmMatrixFree3 {
+    //! Marker for the fluid cells.
+    static constexpr char kFluid = 0;
+
+    //! Marker for the air cells.
+    static constexpr char kAir = 1;
+
+    //! Marker for the boundary cells.
+    static constexpr char kBoundary = 2;
+
+    //! Constructs the operator with blocked cell markers and grid spacing.
+    FdmMatrixFree3(const ConstArrayAccessor3<char>& markers,
+                   const Vector3D& gridSpacing);
+
+    //!
+    //! \brief Constructs the operator with fractional face weights and fluid
+    //!        SDF.
+    //!
+    //! \param uWeights - Face weights at u-faces, size (nx+1, ny, nz).
+    //! \param vWeights - Face weights at v-faces, size (nx, ny+1, nz).
+    //! \param wWeights - Face weights at w-faces, size (nx, ny, nz+1).
+    //! \param fluidSdf - Cell-centered fluid SDF, size (nx, ny, nz).
+    //! \param gridSpacing - The grid spacing.
+    //!
+    FdmMatrixFree3(const ConstArrayAccessor3<float>& uWeights,
+                   const ConstArrayAccessor3<float>& vWeights,
+                   const ConstArrayAccessor3<float>& wWeights,
+                   const ConstArrayAccessor3<float>& fluidSdf,
+                   const Vector3D& gridSpacing);
+
+    //! Copy constructor.
+    FdmMatrixFree3(const FdmMatrixFree3& other) = default;
+
+    FdmMatrixFree3& operator=(const FdmMatrixFree3& other) = delete;
+
+    //! Returns the resolution of the operator.
+    Size3 size() const;
+
+    //! Returns the diagonal element at (i, j, k).
+    double center(size_t i, size_t j, size_t k) const;
+
+    //! Returns the element coupling (i, j, k) and (i+1, j, k).
+    double right(size_t i, size_t j, size_t k) const;
+
+    //! Returns the element coupling (i, j, k) and (i, j+1, k).
+    double up(size_t i, size_t j, size_t k) const;
+
+    //! Returns the element coupling (i, j, k) and (i, j, k+1).
+    double front(size_t i, size_t j, size_t k) const;
+
+    //!
+    //! Returns true if (i, j, k) is a fractional fluid cell whose diagonal is
+    //! near zero because solid boundaries enclose it. center() returns 1 for
+    //! such a row, so its right-hand side must be zero.
+    //!
+    bool isDecoupled(size_t i, size_t j, size_t k) const;
+
+    //! Returns the full row at (i, j, k).
+    FdmMatrixRow3 row(size_t i, size_t j, size_t k) const;
+
+    //! Assembles the operator into an explicit FdmMatrix3.
+    void toMatrix(FdmMatrix3* matrix) const;
+
+ private:
+    bool _isFractional;
+    Vector3D _invHSqr;
+    ConstArrayAccessor3<char> _markers;
+    ConstArrayAccessor3<float> _uWeights;
+    ConstArrayAccessor3<float> _vWeights;
+    ConstArrayAccessor3<float> _wWeights;
+    ConstArrayAccessor3<float> _fluidSdf;
+
+    double offDiagonal(double weight, float phi0, float phi1,
+                       double invHSqr) const;
+
+    double diagonalTerm(double weight, float phi0, float phi1,
+                        double invHSqr) const;
+
+    double fractionalCenter(size_t i, size_t j, size_t k) const;
+};
+
+//! BLAS operator wrapper for matrix-free 3-D finite differencing.
+struct FdmMatrixFreeBlas3 {
+    typedef double ScalarType;
+    typedef FdmVector3 VectorType;
+    typedef FdmMatrixFree3 MatrixType;
+
+    //! Sets entire element of given vector \p result with scalar \p s.
+    static void set(ScalarType s, VectorType* result);
+
+    //! Copies entire element of given vector \p result with other vector \p v.
+    static void set(const VectorType& v, VectorType* result);
+
+    //! Performs dot product with vector \p a and \p b.
+    static double dot(const VectorType& a, const VectorType& b);
+
+    //! Performs ax + y operation where \p a is a matrix and \p x and \p y are
+    //! vectors.
+    static void axpy(double a, const VectorType& x, const VectorType& y,
+                     VectorType* result);
+
+    //! Performs matrix-vector multiplication.
+    static void mvm(const MatrixType& m, const VectorType& v,
+                    VectorType* result);
+
+    //! Computes residual vector (b - ax).
+    static void residual(const MatrixType& a, const VectorType& x,
+                         const VectorType& b, VectorType* result);
+
+    //! Returns L2-norm of the given vector \p v.
+    static ScalarType l2Norm(const VectorType& v);
+
+    //! Returns Linf-norm of the given vector \p v.
+    static ScalarType lInfNorm(const VectorType& v);
+};
+
+}  // namespace jet
+
+#include "detail/fdm_matrix_free3-inl.h"
+
+#endif  // INCLUDE_JET_FDM_MATRIX_FREE3_H_
@@ -30,6 +30,13 @@ struct FdmMgLinearSystem3 {
     //! The RHS vector.
     FdmMgVector3 b;
 
+    //!
+    //! Version of the matrix. Code that changes the values of A increments
+    //! it so that solvers which cache data derived from A, such as smoother
+    //! spectral bounds, know when to rebuild that data.
+    //!
+    size_t matrixVersion = 0;
+
     //! Clears the linear system.
     void clear();
 
@@ -63,9 +70,18 @@ class FdmMgUtils3 {
     //! Corrects given coarser grid to the finer grid.
     static void correct(const FdmVector3 &coarser, FdmVector3 *finer);
 
-    //! Resizes the array with the coarsest resolution and number of levels.
+    //!
+    //! \brief Resizes the array with the coarsest resolution and number of
+    //! levels.
+    //!
+    //! Levels that already have the requested resolution are kept as they
+    //! are, so calling this function every time step with the same
+    //! resolution does not allocate.
+    //!
+    //! \return True if any of the levels has been reallocated.
+    //!
     template <typename T>
-    static void resizeArrayWithCoarsest(const Size3 &coarsestResolution,
+    static bool resizeArrayWithCoarsest(const Size3 &coarsestResolution,
                                         size_t numberOfLevels,
                                         std::vector<Array3<T>> *levels);
 
@@ -78,11 +94,50 @@ class FdmMgUtils3 {
     //!
     //! \param finestResolution - The finest grid resolution.
     //! \param maxNumberOfLevels - Maximum number of multigrid levels.
+    //! \return True if any of the levels has been reallocated.
     //!
     template <typename T>
-    static void resizeArrayWithFinest(const Size3 &finestResolution,
+    static bool resizeArrayWithFinest(const Size3 &finestResolution,
                                       size_t maxNumberOfLevels,
                                       std::vector<Array3<T>> *levels);
+
+    //!
+    //! \brief Restricts the finer-level markers to the coarser level in place.
+    //!
+    //! Each coarser marker takes the most frequent marker of its 4x4x4
+    //! finer-level footprint, and ties go to the larger marker. This is the
+    //! same rule as a full rebuild of the marker hierarchy, which is what this
+    //! function does when \p finerChanged is non-zero everywhere. Otherwise
+    //! only the coarser cells whose footprint overlaps a non-zero entry of
+    //! \p finerChanged are revisited. \p coarserChanged is set to 1 where the
+    //! coarser marker has changed and 0 elsewhere, so it can be fed to the
+    //! next level.
+    //!
+    //! \param finer - The finer-level markers.
+    //! \param finerChanged - Non-zero where the finer marker has changed.
+    //! \param coarser - The coarser-level markers to update.
+    //! \param coarserChanged - Output change mask for the coarser level.
+    //! \return True if any of the coarser markers has changed.
+    //!
+    template <typename T>
+    static bool restrictMarkers(const Array3<T> &finer,
+                                const Array3<char> &finerChanged,
+                                Array3<T> *coarser,
+                                Array3<char> *coarserChanged);
+
+    //!
+    //! \brief Marks the matrix rows affected by the changed markers.
+    //!
+    //! A row of the 7-point FDM matrix depends on the markers of the cell
+    //! itself and its six neighbors. This function dilates \p changedMarkers
+    //! by one cell so that only the marked rows need to be rebuilt.
+    //!
+    //! \param changedMarkers - Non-zero where the marker has changed.
+    //! \param changedRows - Output mask, non-zero for the rows to rebuild.
+    //! \return Number of rows to rebuild.
+    //!
+    static size_t markChangedRows(const Array3<char> &changedMarkers,
+                                  Array3<char> *changedRows);
 };
 
 }  // namespace jet
@@ -7,6 +7,8 @@
 #ifndef INCLUDE_JET_FDM_MG_SOLVER3_H_
 #define INCLUDE_JET_FDM_MG_SOLVER3_H_
 
+#include <jet/chebyshev.h>
+#include <jet/fdm_blocked_smoother3.h>
 #include <jet/fdm_linear_system_solver3.h>
 #include <jet/fdm_mg_linear_system3.h>
 #include <jet/mg.h>
@@ -14,6 +16,10 @@
 namespace jet {
 
 //! \brief 3-D finite difference-type linear system solver using Multigrid.
+//!
+//! \note solve(FdmMgLinearSystem3*) is defined in
+//!     detail/fdm_mg_solver3-inl.h, not in fdm_mg_solver3.cpp.
+//!
 class FdmMgSolver3 : public FdmLinearSystemSolver3 {
  public:
     FdmMgSolver3() = default;
@@ -38,16 +44,57 @@ class FdmMgSolver3 : public FdmLinearSystemSolver3 {
     //! Returns true if red-black ordering is enabled.
     bool useRedBlackOrdering() const;
 
+    //!
+    //! \brief Replaces the relax function.
+    //!
+    //! By default, the solver relaxes with SOR or red-black Gauss-Seidel
+    //! depending on the constructor parameters. This function replaces it
+    //! with a custom smoother such as ChebyshevSmoother::relaxFunc().
+    //!
+    void setRelaxFunc(const MgRelaxFunc<FdmBlas3>& relaxFunc);
+
+    //!
+    //! \brief Replaces the relax function with a Chebyshev smoother.
+    //!
+    //! The cached spectral bounds of \p smoother are dropped before a solve
+    //! whenever FdmMgLinearSystem3::matrixVersion differs from the one of the
+    //! previous solve.
+    //!
+    void setRelaxFunc(const ChebyshevSmoother<FdmBlas3>& smoother);
+
+    //!
+    //! \brief Replaces the relax function with a temporally blocked smoother.
+    //!
+    //! The smoother holds no matrix-dependent data, so nothing is dropped
+    //! between solves.
+    //!
+    void setRelaxFunc(const FdmBlockedSmoother3& smoother);
+
     //! No-op. Multigrid-type solvers do not solve FdmLinearSystem3.
     bool solve(FdmLinearSystem3* system) final;
 
     //! Solves Multigrid linear system.
     virtual bool solve(FdmMgLinearSystem3* system);
 
+ protected:
+    //! Drops matrix-dependent smoother data if the matrix of \p system has
+    //! changed since the previous solve.
+    void validateRelaxFunc(const FdmMgLinearSystem3& system);
+
+    //!
+    //! Sets the max number of multigrid levels. The pressure solvers build
+    //! the hierarchy of the next system with this many levels.
+    //!
+    void setMaxNumberOfLevels(size_t numberOfLevels);
+
  private:
     MgParameters<FdmBlas3> _mgParams;
     double _sorFactor;
     bool _useRedBlackOrdering;
+
+    std::function<void()> _invalidateRelaxFunc;
+    const FdmMgLinearSystem3* _lastSystem = nullptr;
+    size_t _lastMatrixVersion = 0;
 };
 
 //! Shared pointer type for the FdmMgSolver3.
@@ -55,4 +102,6 @@ typedef std::shared_ptr<FdmMgSolver3> FdmMgSolver3Ptr;
 
 }  // namespace jet
 
+#include "detail/fdm_mg_solver3-inl.h"
+
 #endif  // INCLUDE_JET_FDM_MG_SOLVER3_H_
@@ -8,6 +8,7 @@
 #define INCLUDE_JET_FDM_MGPCG_SOLVER3_H_
 
 #include <jet/fdm_mg_solver3.h>
+#include <jet/fdm_solver_workspace3.h>
 
 namespace jet {
 
@@ -20,6 +21,9 @@ namespace jet {
 //!      grids." Proceedings of the 2010 ACM SIGGRAPH/Eurographics Symposium on
 //!      Computer Animation. Eurographics Association, 2010.
 //!
+//! \note solve(FdmMgLinearSystem3*) is defined in
+//!     detail/fdm_mgpcg_solver3-inl.h, not in fdm_mgpcg_solver3.cpp.
+//!
 class FdmMgpcgSolver3 final : public FdmMgSolver3 {
  public:
     //!
@@ -43,17 +47,26 @@ class FdmMgpcgSolver3 final : public FdmMgSolver3 {
     //! Solves the given linear system.
     bool solve(FdmMgLinearSystem3* system) override;
 
+    //! Returns the shared scratch vector workspace, if any.
+    const FdmSolverWorkspace3Ptr& workspace() const;
+
+    //!
+    //! Sets the workspace to borrow scratch vectors from. If nullptr, the
+    //! solver keeps its own scratch vectors.
+    //!
+    void setWorkspace(const FdmSolverWorkspace3Ptr& workspace);
+
     //! Returns the max number of Jacobi iterations.
     unsigned int maxNumberOfIterations() const;
 
     //! Returns the last number of Jacobi iterations the solver made.
-    unsigned int lastNumberOfIterations() const;
+    unsigned int lastNumberOfIterations() const override;
 
     //! Returns the max residual tolerance for the Jacobi method.
     double tolerance() const;
 
     //! Returns the last residual after the Jacobi iterations.
-    double lastResidual() const;
+    double lastResidual() const override;
 
  private:
     struct Preconditioner final {
@@ -70,10 +83,9 @@ class FdmMgpcgSolver3 final : public FdmMgSolver3 {
     double _tolerance;
     double _lastResidualNorm;
 
-    FdmVector3 _r;
-    FdmVector3 _d;
-    FdmVector3 _q;
-    FdmVector3 _s;
+    FdmSolverWorkspace3Ptr _workspace;
+
+    FdmPcgScratch3<FdmBlas3> _pcg;
     Preconditioner _precond;
 };
 
@@ -82,4 +94,6 @@ typedef std::shared_ptr<FdmMgpcgSolver3> FdmMgpcgSolver3Ptr;
 
 }  // namespace jet
 
+#include "detail/fdm_mgpcg_solver3-inl.h"
+
 #endif  // INCLUDE_JET_FDM_MGPCG_SOLVER3_H_
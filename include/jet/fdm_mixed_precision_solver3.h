@@ -0,0 +1,136 @@
+// Copyright (c) 2018 Doyub Kim
+//
+// I am making my contributions/submissions to this project solely in my
+// personal capacity and am not conveying any rights to any intellectual
+// property of any third parties.
+
+#ifndef INCLUDE_JET_FDM_MIXED_PRECISION_SOLVER3_H_
+#define INCLUDE_JET_FDM_MIXED_PRECISION_SOLVER3_H_
+
+#include <jet/fdm_linear_system_solver3.h>
+
+namespace jet {
+
+//!
+//! \brief 3-D finite difference-type linear system solver using
+//!        mixed-precision iterative refinement.
+//!
+//! This solver keeps single-precision copies of the system matrix and runs
+//! incomplete Cholesky preconditioned conjugate gradient (ICCG) in float,
+//! which halves the memory traffic of the inner iterations. An outer loop
+//! computes the residual of the double-precision system, solves for the
+//! correction in float and accumulates it in double, until the residual
+//! reaches the double-precision tolerance.
+//!
+//! \see Buttari, Alfredo, et al. "Using mixed precision for sparse matrix
+//!      computations to enhance the performance while achieving 64-bit
+//!      accuracy." ACM Transactions on Mathematical Software 34.4 (2008).
+//!
+class FdmMixedPrecisionSolver3 final : public FdmLinearSystemSolver3 {
+ public:
+    //!
+    //! Constructs the solver with given parameters.
+    //!
+    //! \param maxNumberOfIterations - Max number of inner iterations per
+    //!                               refinement step.
+    //! \param tolerance - Residual tolerance of the double-precision system.
+    //! \param maxNumberOfRefinements - Max number of outer refinement steps.
+    //! \param innerTolerance - Relative residual reduction of each inner
+    //!                         float solve.
+    //!
+    FdmMixedPrecisionSolver3(unsigned int maxNumberOfIterations,
+                             double tolerance,
+                             unsigned int maxNumberOfRefinements = 10,
+                             double innerTolerance = 1e-3);
+
+    //! Solves the given linear system.
+    bool solve(FdmLinearSystem3* system) override;
+
+    //! Solves the given compressed linear system.
+    bool solveCompressed(FdmCompressedLinearSystem3* system) override;
+
+    //! Returns the max number of inner iterations per refinement step.
+    unsigned int maxNumberOfIterations() const;
+
+    //! Returns the total number of inner iterations of the last solve.
+    unsigned int lastNumberOfIterations() const override;
+
+    //! Returns the max number of outer refinement steps.
+    unsigned int maxNumberOfRefinements() const;
+
+    //! Returns the number of outer refinement steps of the last solve.
+    unsigned int lastNumberOfRefinements() const;
+
+    //! Returns the residual tolerance of the double-precision system.
+    double tolerance() const;
+
+    //! Returns the relative tolerance of each inner float solve.
+    double innerTolerance() const;
+
+    //! Returns the last double-precision residual.
+    double lastResidual() const override;
+
+ private:
+    struct Preconditioner final {
+        const FdmMatrix3F* A = nullptr;
+        FdmVector3F d;
+        FdmVector3F y;
+
+        void build(const FdmMatrix3F& matrix);
+
+        void solve(const FdmVector3F& b, FdmVector3F* x);
+    };
+
+    struct PreconditionerCompressed final {
+        const MatrixCsrF* A;
+        VectorNF d;
+        VectorNF y;
+
+        void build(const MatrixCsrF& matrix);
+
+        void solve(const VectorNF& b, VectorNF* x);
+    };
+
+    unsigned int _maxNumberOfIterations;
+    unsigned int _lastNumberOfIterations = 0;
+    unsigned int _maxNumberOfRefinements;
+    unsigned int _lastNumberOfRefinements = 0;
+    double _tolerance;
+    double _innerTolerance;
+    double _lastResidual = 0.0;
+
+    // Uncompressed float system, vectors and preconditioner
+    FdmMatrix3F _aF;
+    FdmVector3F _rF;
+    FdmVector3F _eF;
+    FdmVector3F _r;
+    FdmVector3F _d;
+    FdmVector3F _q;
+    FdmVector3F _s;
+    FdmVector3 _residual;
+    Preconditioner _precond;
+
+    // Compressed float system, vectors and preconditioner
+    MatrixCsrF _aFComp;
+    VectorNF _rFComp;
+    VectorNF _eFComp;
+    VectorNF _rComp;
+    VectorNF _dComp;
+    VectorNF _qComp;
+    VectorNF _sComp;
+    VectorND _residualComp;
+    PreconditionerCompressed _precondComp;
+
+    void clearUncompressedVectors();
+    void clearCompressedVectors();
+};
+
+//! Shared pointer type for the FdmMixedPrecisionSolver3.
+typedef std::shared_ptr<FdmMixedPrecisionSolver3>
+    FdmMixedPrecisionSolver3Ptr;
+
+}  // namespace jet
+
+#include "detail/fdm_mixed_precision_solver3-inl.h"
+
+#endif  // INCLUDE_JET_FDM_MIXED_PRECISION_SOLVER3_H_
@@ -0,0 +1,145 @@
+// Copyright (c) 2018 Doyub Kim
+//
+// I am making my contributions/submissions to this project solely in my
+// personal capacity and am not conveying any rights to any intellectual
+// property of any third parties.
+
+#ifndef INCLUDE_JET_FDM_SCHWARZ_SOLVER3_H_
+#define INCLUDE_JET_FDM_SCHWARZ_SOLVER3_H_
+
+#include <jet/fdm_linear_system_solver3.h>
+#include <jet/fdm_solver_workspace3.h>
+
+#include <vector>
+
+namespace jet {
+
+//!
+//! \brief 3-D finite difference-type linear system solver using conjugate
+//!        gradient with additive Schwarz preconditioner.
+//!
+//! The grid is partitioned into slabs along the z-axis, one per subdomain.
+//! Each slab is extended by \p overlap layers on both sides and factorized
+//! with a local incomplete Cholesky (IC(0)) decomposition that ignores the
+//! couplings to the outside of the extended slab. Applying the
+//! preconditioner solves all subdomains independently in parallel and sums
+//! the local solutions, which keeps each thread on a contiguous block of
+//! memory and avoids the serial dependency chain of the global ICCG sweep.
+//! Compressed systems are partitioned into contiguous row ranges and
+//! extended by following the matrix graph.
+//!
+class FdmSchwarzSolver3 final : public FdmLinearSystemSolver3 {
+ public:
+    //!
+    //! Constructs the solver with given parameters.
+    //!
+    //! \param maxNumberOfIterations - Max number of CG iterations.
+    //! \param tolerance - Residual tolerance.
+    //! \param numberOfSubdomains - Number of subdomains. Zero means one
+    //!                             subdomain per thread.
+    //! \param overlap - Number of overlapping layers between subdomains.
+    //!
+    FdmSchwarzSolver3(unsigned int maxNumberOfIterations, double tolerance,
+                      size_t numberOfSubdomains = 0, size_t overlap = 1);
+
+    //! Solves the given linear system.
+    bool solve(FdmLinearSystem3* system) override;
+
+    //! Solves the given compressed linear system.
+    bool solveCompressed(FdmCompressedLinearSystem3* system) override;
+
+    //! Returns the shared scratch vector workspace, if any.
+    const FdmSolverWorkspace3Ptr& workspace() const;
+
+    //!
+    //! Sets the workspace to borrow scratch vectors from. If nullptr, the
+    //! solver keeps its own scratch vectors.
+    //!
+    void setWorkspace(const FdmSolverWorkspace3Ptr& workspace);
+
+    //! Returns the max number of CG iterations.
+    unsigned int maxNumberOfIterations() const;
+
+    //! Returns the last number of CG iterations the solver made.
+    unsigned int lastNumberOfIterations() const override;
+
+    //! Returns the max residual tolerance for the CG method.
+    double tolerance() const;
+
+    //! Returns the last residual after the CG iterations.
+    double lastResidual() const override;
+
+    //! Returns the requested number of subdomains (zero for auto).
+    size_t numberOfSubdomains() const;
+
+    //! Returns the number of overlapping layers between subdomains.
+    size_t overlap() const;
+
+ private:
+    struct Subdomain final {
+        // Owned and overlap-extended ranges. These are z-layers for the
+        // uncompressed system and rows for the compressed system.
+        size_t begin = 0;
+        size_t end = 0;
+        size_t extBegin = 0;
+        size_t extEnd = 0;
+
+        // Subdomains whose extended range overlaps the owned range
+        std::vector<size_t> neighbors;
+
+        std::vector<double> d;
+        std::vector<double> y;
+        std::vector<double> z;
+    };
+
+    struct Preconditioner final {
+        const FdmMatrix3* A = nullptr;
+        std::vector<Subdomain> subdomains;
+
+        void build(const FdmMatrix3& matrix, size_t numberOfSubdomains,
+                   size_t overlap);
+
+        void solve(const FdmVector3& b, FdmVector3* x);
+    };
+
+    struct PreconditionerCompressed final {
+        const MatrixCsrD* A;
+        std::vector<Subdomain> subdomains;
+
+        void build(const MatrixCsrD& matrix, size_t numberOfSubdomains,
+                   size_t overlap);
+
+        void solve(const VectorND& b, VectorND* x);
+    };
+
+    unsigned int _maxNumberOfIterations;
+    unsigned int _lastNumberOfIterations = 0;
+    double _tolerance;
+    double _lastResidualNorm = 0.0;
+    size_t _numberOfSubdomains;
+    size_t _overlap;
+
+    FdmSolverWorkspace3Ptr _workspace;
+
+    // Uncompressed vectors and preconditioner
+    FdmPcgScratch3<FdmBlas3> _pcg;
+    Preconditioner _precond;
+
+    // Compressed vectors and preconditioner
+    FdmPcgScratch3<FdmCompressedBlas3> _pcgComp;
+    PreconditionerCompressed _precondComp;
+
+    size_t resolvedNumberOfSubdomains() const;
+
+    void clearUncompressedVectors();
+    void clearCompressedVectors();
+};
+
+//! Shared pointer type for the FdmSchwarzSolver3.
+typedef std::shared_ptr<FdmSchwarzSolver3> FdmSchwarzSolver3Ptr;
+
+}  // namespace jet
+
+#include "detail/fdm_schwarz_solver3-inl.h"
+
+#endif  // INCLUDE_JET_FDM_SCHWARZ_SOLVER3_H_
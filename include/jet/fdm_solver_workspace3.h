@@ -0,0 +1,145 @@
+// Copyright (c) 2018 Doyub Kim
+//
+// I am making my contributions/submissions to this project solely in my
+// personal capacity and am not conveying any rights to any intellectual
+// property of any third parties.
+
+#ifndef INCLUDE_JET_FDM_SOLVER_WORKSPACE3_H_
+#define INCLUDE_JET_FDM_SOLVER_WORKSPACE3_H_
+
+#include <jet/cg.h>
+#include <jet/fdm_linear_system3.h>
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace jet {
+
+//!
+//! \brief Pool of scratch vectors shared between 3-D FDM linear system
+//!        solvers.
+//!
+//! Krylov solvers need several full-resolution scratch vectors during a solve
+//! but none between solves. Solvers that share a workspace borrow their
+//! scratch vectors at the beginning of a solve and release them at the end,
+//! so the peak memory is determined by the largest single solve rather than
+//! by the number of solver instances. Released vectors are kept for reuse
+//! until clear() is called.
+//!
+class FdmSolverWorkspace3 {
+ public:
+    //! Default constructor.
+    FdmSolverWorkspace3() = default;
+
+    //! Borrows a vector with given size. The contents are unspecified.
+    FdmVector3* borrow(const Size3& size);
+
+    //! Returns a vector previously obtained from borrow().
+    void release(FdmVector3* vector);
+
+    //! Borrows a compressed vector with given size. The contents are
+    //! unspecified.
+    VectorND* borrowCompressed(size_t size);
+
+    //! Returns a vector previously obtained from borrowCompressed().
+    void releaseCompressed(VectorND* vector);
+
+    //! Frees all the vectors that are not borrowed.
+    void clear();
+
+    //! Returns the number of vectors allocated by this workspace.
+    size_t numberOfVectors() const;
+
+    //! Returns the number of vectors currently borrowed.
+    size_t numberOfBorrowedVectors() const;
+
+    //! Returns the number of bytes held by the vectors of this workspace.
+    size_t memoryUsage() const;
+
+ private:
+    template <typename VectorType>
+    struct Entry {
+        std::unique_ptr<VectorType> vector;
+        bool borrowed = false;
+    };
+
+    mutable std::mutex _mutex;
+    std::vector<Entry<FdmVector3>> _vectors;
+    std::vector<Entry<VectorND>> _compressedVectors;
+};
+
+//! Shared pointer type for the FdmSolverWorkspace3.
+typedef std::shared_ptr<FdmSolverWorkspace3> FdmSolverWorkspace3Ptr;
+
+//!
+//! \brief Scratch vector borrowed from a FdmSolverWorkspace3 for the
+//!        lifetime of this object.
+//!
+//! The vector is returned to the workspace by the destructor, so it is not
+//! leaked as borrowed if the solve throws.
+//!
+template <typename VectorType>
+class FdmScopedScratchVector3 {
+ public:
+    //! Borrows a vector with the size of \p like from \p workspace.
+    FdmScopedScratchVector3(FdmSolverWorkspace3* workspace,
+                            const VectorType& like);
+
+    //! Returns the vector to the workspace.
+    ~FdmScopedScratchVector3();
+
+    FdmScopedScratchVector3(const FdmScopedScratchVector3&) = delete;
+
+    FdmScopedScratchVector3& operator=(const FdmScopedScratchVector3&) =
+        delete;
+
+    //! Returns the borrowed vector.
+    VectorType* get() const;
+
+ private:
+    FdmSolverWorkspace3* _workspace;
+    VectorType* _vector;
+};
+
+//!
+//! \brief Scratch vectors of a preconditioned CG solve.
+//!
+//! Runs pcg() with the four scratch vectors borrowed from a workspace through
+//! FdmScopedScratchVector3, or with its own vectors if there is no workspace.
+//! Own vectors are freed while a workspace is in use.
+//!
+template <typename BlasType>
+class FdmPcgScratch3 {
+ public:
+    typedef typename BlasType::MatrixType MatrixType;
+    typedef typename BlasType::VectorType VectorType;
+
+    //!
+    //! \brief Solves A x = b with preconditioned CG starting from \p x.
+    //!
+    //! \return True if \p maxDurationInSeconds stopped the iterations
+    //!         before the residual reached \p tolerance.
+    //!
+    template <typename PrecondType>
+    bool pcg(FdmSolverWorkspace3* workspace, const MatrixType& A,
+             const VectorType& b, unsigned int maxNumberOfIterations,
+             double tolerance, PrecondType* M, VectorType* x,
+             unsigned int* lastNumberOfIterations, double* lastResidualNorm,
+             double maxDurationInSeconds);
+
+    //! Frees the own scratch vectors.
+    void clear();
+
+ private:
+    VectorType _r;
+    VectorType _d;
+    VectorType _q;
+    VectorType _s;
+};
+
+}  // namespace jet
+
+#include "detail/fdm_solver_workspace3-inl.h"
+
+#endif  // INCLUDE_JET_FDM_SOLVER_WORKSPACE3_H_
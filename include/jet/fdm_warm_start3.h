@@ -0,0 +1,111 @@
+// Copyright (c) 2018 Doyub Kim
+//
+// I am making my contributions/submissions to this project solely in my
+// personal capacity and am not conveying any rights to any intellectual
+// property of any third parties.
+
+#ifndef INCLUDE_JET_FDM_WARM_START3_H_
+#define INCLUDE_JET_FDM_WARM_START3_H_
+
+#include <jet/fdm_linear_system3.h>
+
+#include <functional>
+
+namespace jet {
+
+//!
+//! \brief Previous-solution cache for warm-starting 3-D FDM solves.
+//!
+//! Pressure varies little from one frame to the next, so starting an
+//! iterative solve from the previous solution, scaled by the ratio of the
+//! time intervals, usually saves a good portion of the iterations compared to
+//! starting from zero. This class stores the last solution per cell together
+//! with the cells that were solved for. Cells that enter the fluid region
+//! take the average of their previously solved neighbors and cells that
+//! leave it are dropped. It also keeps running iteration counts of warm and
+//! cold solves so that the savings can be reported.
+//!
+class FdmWarmStart3 {
+ public:
+    //! Function that returns true if the cell (i, j, k) is an unknown.
+    typedef std::function<bool(size_t, size_t, size_t)> UnknownFunc;
+
+    //! Constructs an empty cache.
+    FdmWarmStart3();
+
+    //! Clears the cached solution and the statistics.
+    void clear();
+
+    //! Returns true if a cached solution with given resolution exists.
+    bool hasSolution(const Size3& resolution) const;
+
+    //!
+    //! \brief Fills the initial guess for the next solve.
+    //!
+    //! If there is no cached solution with the same resolution, \p x is
+    //! zeroed and the next solve is counted as a cold one.
+    //!
+    //! \param[in]  isUnknown             Returns true for the new unknowns.
+    //! \param[in]  timeIntervalInSeconds The time interval of the next solve.
+    //! \param[out] x                     The initial guess.
+    //! \return True if \p x has been warm-started.
+    //!
+    bool initialGuess(const UnknownFunc& isUnknown,
+                      double timeIntervalInSeconds, FdmVector3* x);
+
+    //!
+    //! \brief Fills the initial guess for the next compressed solve.
+    //!
+    //! The compressed unknowns are numbered in the same order as
+    //! Array3::forEachIndex visits the cells where \p isUnknown is true.
+    //!
+    bool initialGuessCompressed(const Size3& resolution,
+                                const UnknownFunc& isUnknown,
+                                double timeIntervalInSeconds, VectorND* x);
+
+    //! Stores the solution \p x of the solve with given time interval.
+    void store(const FdmVector3& x, const UnknownFunc& isUnknown,
+               double timeIntervalInSeconds);
+
+    //! Records the number of iterations the last solve took.
+    void recordIterations(unsigned int numberOfIterations);
+
+    //! Returns the number of cells that entered the unknowns in the last
+    //! initial guess.
+    size_t lastNumberOfEnteringCells() const;
+
+    //! Returns the average number of iterations of the warm-started solves.
+    double averageWarmIterations() const;
+
+    //! Returns the average number of iterations of the cold solves.
+    double averageColdIterations() const;
+
+    //!
+    //! \brief Returns the fraction of iterations saved by warm-starting.
+    //!
+    //! The value is 1 - averageWarmIterations() / averageColdIterations(),
+    //! or zero if either of them has not been measured yet.
+    //!
+    double iterationSavings() const;
+
+ private:
+    FdmVector3 _x;
+    Array3<char> _unknowns;
+    double _timeIntervalInSeconds = 0.0;
+    bool _lastGuessWasWarm = false;
+    size_t _lastNumberOfEnteringCells = 0;
+
+    size_t _numberOfWarmSolves = 0;
+    size_t _numberOfColdSolves = 0;
+    double _totalWarmIterations = 0.0;
+    double _totalColdIterations = 0.0;
+
+    double guess(const UnknownFunc& isUnknown, double scale, size_t i,
+                 size_t j, size_t k, bool* isEntering) const;
+};
+
+}  // namespace jet
+
+#include "detail/fdm_warm_start3-inl.h"
+
+#endif  // INCLUDE_JET_FDM_WARM_START3_H_
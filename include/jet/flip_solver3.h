@@ -7,6 +7,8 @@
 #ifndef INCLUDE_JET_FLIP_SOLVER3_H_
 #define INCLUDE_JET_FLIP_SOLVER3_H_
 
+#include <jet/cell_centered_scalar_grid3.h>
+#include <jet/face_centered_grid3.h>
 #include <jet/pic_solver3.h>
 
 namespace jet {
@@ -22,6 +24,9 @@ namespace jet {
 //! \see Zhu, Yongning, and Robert Bridson. "Animating sand as a fluid."
 //!     ACM Transactions on Graphics (TOG). Vol. 24. No. 3. ACM, 2005.
 //!
+//! \note transferFromParticlesToGrids() and transferFromGridsToParticles()
+//!     are defined in detail/flip_solver3-inl.h, not in flip_solver3.cpp.
+//!
 class FlipSolver3 : public PicSolver3 {
  public:
     class Builder;
@@ -53,6 +58,31 @@ class FlipSolver3 : public PicSolver3 {
     //!
     void setPicBlendingFactor(double factor);
 
+    //! Returns true if the solver only keeps particles near the surface.
+    bool useNarrowBand() const;
+
+    //!
+    //! \brief Enables or disables narrow-band FLIP.
+    //!
+    //! In narrow-band mode, particles are only kept within narrowBandWidth()
+    //! cells of the liquid surface. The deep interior is represented on the
+    //! grid by a level set and a velocity field that are advected with the
+    //! advection solver. Particles that drift into the interior are removed,
+    //! and empty cells at the inner band boundary are reseeded. This cuts the
+    //! particle count and transfer cost of large volumes of liquid. Default
+    //! is off.
+    //!
+    //! \see Ferstl, Florian, et al. "Narrow band FLIP for liquid
+    //!     simulations." Computer Graphics Forum. Vol. 35. No. 2. 2016.
+    //!
+    void setUseNarrowBand(bool onoff);
+
+    //! Returns the width of the particle band in cells.
+    double narrowBandWidth() const;
+
+    //! Sets the width of the particle band in cells. Default is 3.
+    void setNarrowBandWidth(double widthInCells);
+
     //! Returns builder fox FlipSolver3.
     static Builder builder();
 
@@ -63,11 +93,62 @@ class FlipSolver3 : public PicSolver3 {
     //! Transfers velocity field from grids to particles.
     void transferFromGridsToParticles() override;
 
+    //! Invoked before a simulation time-step begins. In narrow-band mode,
+    //! merges the grid-only interior into the transferred velocity and the
+    //! signed-distance field.
+    void onBeginAdvanceTimeStep(double timeIntervalInSeconds) override;
+
+    //! Computes the advection term. In narrow-band mode, the interior level
+    //! set and velocity are advected before the particles.
+    void computeAdvection(double timeIntervalInSeconds) override;
+
+    //! Moves particles. In narrow-band mode, interior particles are then
+    //! removed and the band boundary is reseeded.
+    void moveParticles(double timeIntervalInSeconds) override;
+
+    //!
+    //! \brief Advects the interior level set and velocity by one time-step.
+    //!
+    //! Called by computeAdvection() before the particles are moved, with the
+    //! projected velocity and the signed-distance field of the current step.
+    //!
+    void advectNarrowBandInterior(double timeIntervalInSeconds);
+
+    //!
+    //! \brief Merges the grid-only interior into the particle results.
+    //!
+    //! Called by onBeginAdvanceTimeStep() after the particle-to-grid transfer
+    //! and the signed-distance field construction. Deep interior cells take
+    //! the advected level set, and velocity faces without particle
+    //! contributions inside the liquid take the advected velocity and are
+    //! marked as valid. The saved grid velocity of the FLIP update is set to
+    //! the same values, so the interior faces only add their own change.
+    //!
+    void applyNarrowBandInterior();
+
+    //!
+    //! \brief Removes interior particles and reseeds the band boundary.
+    //!
+    //! Called by moveParticles() after the particles were moved. Particles
+    //! deeper than the band are removed, and empty cells in the innermost cell
+    //! layer of the band get eight jittered particles with the interior
+    //! velocity.
+    //!
+    void updateNarrowBandParticles();
+
+    //! Returns the band width in narrow-band mode, so that the particle
+    //! count control does not seed the grid-only interior.
+    double particleSeedingDepth() const override;
+
  private:
     double _picBlendingFactor = 0.0;
     Array3<float> _uDelta;
     Array3<float> _vDelta;
     Array3<float> _wDelta;
+    bool _useNarrowBand = false;
+    double _narrowBandWidth = 3.0;
+    CellCenteredScalarGrid3 _interiorSdf;
+    FaceCenteredGrid3 _interiorVelocity;
 };
 
 //! Shared pointer type for the FlipSolver3.
@@ -89,4 +170,6 @@ class FlipSolver3::Builder final
 
 }  // namespace jet
 
+#include "detail/flip_solver3-inl.h"
+
 #endif  // INCLUDE_JET_FLIP_SOLVER3_H_
@@ -8,8 +8,12 @@
 #define INCLUDE_JET_GRID_BACKWARD_EULER_DIFFUSION_SOLVER3_H_
 
 #include <jet/constant_scalar_field3.h>
+#include <jet/fdm_batch_linear_system3.h>
+#include <jet/fdm_cg_solver3.h>
 #include <jet/fdm_linear_system_solver3.h>
 #include <jet/grid_diffusion_solver3.h>
+
+#include <array>
 #include <limits>
 #include <memory>
 
@@ -26,6 +30,10 @@ namespace jet {
 //! To solve the backward Euler method, a linear system solver is used and
 //! incomplete Cholesky conjugate gradient method is used by default.
 //!
+//! \note The collocated and face-centered vector overloads of solve() are
+//!     defined in detail/grid_backward_euler_diffusion_solver3-inl.h, not in
+//!     grid_backward_euler_diffusion_solver3.cpp.
+//!
 class GridBackwardEulerDiffusionSolver3 final : public GridDiffusionSolver3 {
  public:
     enum BoundaryType {
@@ -100,12 +108,46 @@ class GridBackwardEulerDiffusionSolver3 final : public GridDiffusionSolver3 {
     //! Sets the linear system solver for this diffusion solver.
     void setLinearSystemSolver(const FdmLinearSystemSolver3Ptr& solver);
 
+    //! Returns true if collocated vector components are solved together.
+    bool useBatchedComponentSolve() const;
+
+    //!
+    //! \brief Enables or disables solving vector components together.
+    //!
+    //! The three components of a collocated vector grid share the same
+    //! matrix and differ only in their right-hand sides. When enabled, they
+    //! are solved with batchedCg(), which keeps separate step lengths and
+    //! convergence per component but reads the matrix once per iteration for
+    //! all of them. Face-centered components have different matrices, so
+    //! each one gets its own system and CG solver and the three are solved
+    //! concurrently. The batched solve uses its own CG iterations with the
+    //! given parameters instead of the linear system solver.
+    //!
+    //! \param useBatchedSolve True to enable the batched solve.
+    //! \param maxNumberOfIterations Max number of batched CG iterations.
+    //! \param tolerance Residual tolerance of each component.
+    //!
+    void setUseBatchedComponentSolve(
+        bool useBatchedSolve, unsigned int maxNumberOfIterations = 100,
+        double tolerance = std::numeric_limits<double>::epsilon());
+
  private:
     BoundaryType _boundaryType;
     FdmLinearSystem3 _system;
     FdmLinearSystemSolver3Ptr _systemSolver;
     Array3<char> _markers;
 
+    bool _useBatchedComponentSolve = false;
+    unsigned int _batchedMaxNumberOfIterations = 100;
+    double _batchedTolerance = std::numeric_limits<double>::epsilon();
+    FdmBatchLinearSystem3<3> _batchedSystem;
+    FdmBatchVector3<3> _batchedR;
+    FdmBatchVector3<3> _batchedD;
+    FdmBatchVector3<3> _batchedQ;
+    FdmBatchVector3<3> _batchedS;
+    std::array<FdmLinearSystem3, 3> _faceSystems;
+    std::array<FdmCgSolver3Ptr, 3> _faceSolvers;
+
     void buildMarkers(
         const Size3& size,
         const std::function<Vector3D(size_t, size_t, size_t)>& pos,
@@ -124,6 +166,20 @@ class GridBackwardEulerDiffusionSolver3 final : public GridDiffusionSolver3 {
         const ConstArrayAccessor3<Vector3D>& f,
         const Vector3D& c,
         size_t component);
+
+    void solveBatchedComponents(
+        const CollocatedVectorGrid3& source,
+        const Vector3D& c,
+        CollocatedVectorGrid3* dest);
+
+    void solveFaceComponentsConcurrently(
+        const FaceCenteredGrid3& source,
+        const Vector3D& c,
+        FaceCenteredGrid3* dest,
+        const ScalarField3& boundarySdf,
+        const ScalarField3& fluidSdf);
+
+    void clearBatchedVectors();
 };
 
 //! Shared pointer type for the GridBackwardEulerDiffusionSolver3.
@@ -132,4 +188,6 @@ typedef std::shared_ptr<GridBackwardEulerDiffusionSolver3>
 
 }  // namespace jet
 
+#include "detail/grid_backward_euler_diffusion_solver3-inl.h"
+
 #endif  // INCLUDE_JET_GRID_BACKWARD_EULER_DIFFUSION_SOLVER3_H_
@@ -31,6 +31,9 @@ namespace jet {
 //! user wants to change the advection solver to her/his own implementation,
 //! simply call GridFluidSolver3::setAdvectionSolver(newSolver).
 //!
+//! \note setPressureSolver() and computeAdvection() are defined in
+//!     detail/grid_fluid_solver3-inl.h, not in grid_fluid_solver3.cpp.
+//!
 class GridFluidSolver3 : public PhysicsAnimation {
  public:
     class Builder;
@@ -102,6 +105,29 @@ class GridFluidSolver3 : public PhysicsAnimation {
     //! Sets the pressure solver.
     void setPressureSolver(const GridPressureSolver3Ptr& newSolver);
 
+    //! Returns true if the pressure solve runs in time-budget mode.
+    bool usePressureSolveTimeBudget() const;
+
+    //!
+    //! \brief Switches the pressure solve between budget and accuracy mode.
+    //!
+    //! In budget mode, the linear solve of the pressure solver stops after
+    //! pressureSolveTimeBudget() seconds and leaves whatever residual it has
+    //! reached, which keeps the frame time bounded for interactive previews.
+    //! In accuracy mode (default), it iterates until the tolerance or the max
+    //! number of iterations is reached. The mode can be switched every frame.
+    //!
+    void setUsePressureSolveTimeBudget(bool onoff);
+
+    //! Returns the wall-clock budget of the pressure solve in seconds.
+    double pressureSolveTimeBudget() const;
+
+    //! Sets the wall-clock budget of the pressure solve in seconds.
+    void setPressureSolveTimeBudget(double seconds);
+
+    //! Returns the residual the last pressure solve achieved.
+    double lastPressureResidual() const;
+
     //! Returns the closed domain boundary flag.
     int closedDomainBoundaryFlag() const;
 
@@ -265,12 +291,21 @@ class GridFluidSolver3 : public PhysicsAnimation {
     //! Returns the velocity field of the collider.
     VectorField3Ptr colliderVelocityField() const;
 
+    //!
+    //! \brief Hands the budget of the current mode to the pressure solver.
+    //!
+    //! Called whenever the mode, the budget or the pressure solver changes.
+    //!
+    void applyPressureSolveMode();
+
  private:
     Vector3D _gravity = Vector3D(0.0, -9.8, 0.0);
     double _viscosityCoefficient = 0.0;
     double _maxCfl = 5.0;
     bool _useCompressedLinearSys = false;
     int _closedDomainBoundaryFlag = kDirectionAll;
+    bool _usePressureSolveTimeBudget = false;
+    double _pressureSolveTimeBudget = 0.01;
 
     GridSystemData3Ptr _grids;
     Collider3Ptr _collider;
@@ -392,4 +427,6 @@ class GridFluidSolver3::Builder final
 
 }  // namespace jet
 
+#include "detail/grid_fluid_solver3-inl.h"
+
 #endif  // INCLUDE_JET_GRID_FLUID_SOLVER3_H_
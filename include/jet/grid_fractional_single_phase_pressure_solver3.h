@@ -8,9 +8,12 @@
 #define INCLUDE_JET_GRID_FRACTIONAL_SINGLE_PHASE_PRESSURE_SOLVER3_H_
 
 #include <jet/cell_centered_scalar_grid3.h>
+#include <jet/fdm_compressed_linear_system_builder3.h>
 #include <jet/fdm_linear_system_solver3.h>
+#include <jet/fdm_matrix_free3.h>
 #include <jet/fdm_mg_linear_system3.h>
 #include <jet/fdm_mg_solver3.h>
+#include <jet/fdm_warm_start3.h>
 #include <jet/grid_boundary_condition_solver3.h>
 #include <jet/grid_pressure_solver3.h>
 #include <jet/vertex_centered_scalar_grid3.h>
@@ -43,6 +46,10 @@ namespace jet {
 //!     flows." ASME/JSME 2003 4th Joint Fluids Summer Engineering Conference.
 //!     American Society of Mechanical Engineers, 2003.
 //!
+//! \note solve(), buildSystem() and decompressSolution() are defined in
+//!     detail/grid_fractional_single_phase_pressure_solver3-inl.h, not in
+//!     grid_fractional_single_phase_pressure_solver3.cpp.
+//!
 class GridFractionalSinglePhasePressureSolver3 : public GridPressureSolver3 {
  public:
     GridFractionalSinglePhasePressureSolver3();
@@ -90,6 +97,15 @@ class GridFractionalSinglePhasePressureSolver3 : public GridPressureSolver3 {
     GridBoundaryConditionSolver3Ptr suggestedBoundaryConditionSolver()
         const override;
 
+    //! Returns the residual the last linear solve achieved.
+    double lastResidual() const override;
+
+    //! Returns the number of iterations of the last linear solve.
+    unsigned int lastNumberOfIterations() const override;
+
+    //! Returns true if the last linear solve was cut short by the budget.
+    bool lastSolveHitTimeBudget() const override;
+
     //! Returns the linear system solver.
     const FdmLinearSystemSolver3Ptr& linearSystemSolver() const;
 
@@ -99,14 +115,34 @@ class GridFractionalSinglePhasePressureSolver3 : public GridPressureSolver3 {
     //! Returns the pressure field.
     const FdmVector3& pressure() const;
 
+    //! Returns true if the solve starts from the previous pressure.
+    bool useWarmStart() const;
+
+    //!
+    //! \brief Enables or disables warm-starting the pressure solve.
+    //!
+    //! When enabled, each solve starts from the pressure of the previous
+    //! solve scaled by the ratio of the time intervals instead of zero. The
+    //! cached pressure is dropped when the grid resolution changes or the
+    //! mode is disabled.
+    //!
+    void setUseWarmStart(bool useWarmStart);
+
+    //! Returns the warm-start cache which also reports iteration savings.
+    const FdmWarmStart3& warmStart() const;
+
  private:
     FdmLinearSystem3 _system;
     FdmCompressedLinearSystem3 _compSystem;
+    FdmCompressedLinearSystemBuilder3 _compSystemBuilder;
     FdmLinearSystemSolver3Ptr _systemSolver;
 
     FdmMgLinearSystem3 _mgSystem;
     FdmMgSolver3Ptr _mgSystemSolver;
 
+    bool _useWarmStart = false;
+    FdmWarmStart3 _warmStart;
+
     std::vector<Array3<float>> _uWeights;
     std::vector<Array3<float>> _vWeights;
     std::vector<Array3<float>> _wWeights;
@@ -119,6 +155,15 @@ class GridFractionalSinglePhasePressureSolver3 : public GridPressureSolver3 {
                       const VectorField3& boundaryVelocity,
                       const ScalarField3& fluidSdf);
 
+    void buildCompressedMatrix(const Vector3D& gridSpacing);
+
+    double computeRhs(const FaceCenteredGrid3& input, const FdmMatrixFree3& op,
+                      size_t i, size_t j, size_t k) const;
+
+    void buildInitialGuess(double timeIntervalInSeconds, bool useCompressed);
+
+    void storeSolution(double timeIntervalInSeconds);
+
     void decompressSolution();
 
     virtual void buildSystem(const FaceCenteredGrid3& input,
@@ -134,4 +179,6 @@ typedef std::shared_ptr<GridFractionalSinglePhasePressureSolver3>
 
 }  // namespace jet
 
+#include "detail/grid_fractional_single_phase_pressure_solver3-inl.h"
+
 #endif  // INCLUDE_JET_GRID_FRACTIONAL_SINGLE_PHASE_PRESSURE_SOLVER3_H_
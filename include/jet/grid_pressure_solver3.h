@@ -14,6 +14,7 @@
 #include <jet/face_centered_grid3.h>
 #include <jet/grid_boundary_condition_solver3.h>
 #include <jet/scalar_grid3.h>
+#include <algorithm>
 #include <memory>
 
 namespace jet {
@@ -72,6 +73,33 @@ class GridPressureSolver3 {
     //!
     virtual GridBoundaryConditionSolver3Ptr suggestedBoundaryConditionSolver()
         const = 0;
+
+    //! Returns the residual the last linear solve achieved.
+    virtual double lastResidual() const { return 0.0; }
+
+    //! Returns the number of iterations of the last linear solve.
+    virtual unsigned int lastNumberOfIterations() const { return 0; }
+
+    //! Returns true if the last linear solve was cut short by the budget.
+    virtual bool lastSolveHitTimeBudget() const { return false; }
+
+    //! Returns the wall-clock budget of the linear solve in seconds.
+    double timeBudget() const { return _timeBudget; }
+
+    //!
+    //! \brief Sets the wall-clock budget of the linear solve in seconds.
+    //!
+    //! The budget is handed to the linear system solver at the beginning of
+    //! each solve. The linear system solver stops iterating once it runs out
+    //! and reports the achieved residual through lastResidual(). kMaxD
+    //! (default) solves to the tolerance.
+    //!
+    virtual void setTimeBudget(double seconds) {
+        _timeBudget = std::max(seconds, 0.0);
+    }
+
+ protected:
+    double _timeBudget = kMaxD;
 };
 
 //! Shared pointer type for the GridPressureSolver3.
@@ -7,9 +7,11 @@
 #ifndef INCLUDE_JET_GRID_SINGLE_PHASE_PRESSURE_SOLVER3_H_
 #define INCLUDE_JET_GRID_SINGLE_PHASE_PRESSURE_SOLVER3_H_
 
+#include <jet/fdm_compressed_linear_system_builder3.h>
 #include <jet/fdm_linear_system_solver3.h>
 #include <jet/fdm_mg_linear_system3.h>
 #include <jet/fdm_mg_solver3.h>
+#include <jet/fdm_warm_start3.h>
 #include <jet/grid_boundary_condition_solver3.h>
 #include <jet/grid_pressure_solver3.h>
 
@@ -31,6 +33,10 @@ namespace jet {
 //! fluid, it is marked as either fluid or atmosphere. Thus, this solver in
 //! general, does not compute subgrid structure.
 //!
+//! \note solve(), buildMarkers(), buildSystem() and decompressSolution() are
+//!     defined in detail/grid_single_phase_pressure_solver3-inl.h, not in
+//!     grid_single_phase_pressure_solver3.cpp.
+//!
 class GridSinglePhasePressureSolver3 : public GridPressureSolver3 {
  public:
     //! Default constructor.
@@ -81,6 +87,15 @@ class GridSinglePhasePressureSolver3 : public GridPressureSolver3 {
     GridBoundaryConditionSolver3Ptr suggestedBoundaryConditionSolver()
         const override;
 
+    //! Returns the residual the last linear solve achieved.
+    double lastResidual() const override;
+
+    //! Returns the number of iterations of the last linear solve.
+    unsigned int lastNumberOfIterations() const override;
+
+    //! Returns true if the last linear solve was cut short by the budget.
+    bool lastSolveHitTimeBudget() const override;
+
     //! Returns the linear system solver.
     const FdmLinearSystemSolver3Ptr& linearSystemSolver() const;
 
@@ -90,21 +105,50 @@ class GridSinglePhasePressureSolver3 : public GridPressureSolver3 {
     //! Returns the pressure field.
     const FdmVector3& pressure() const;
 
+    //! Returns true if the solve starts from the previous pressure.
+    bool useWarmStart() const;
+
+    //!
+    //! \brief Enables or disables warm-starting the pressure solve.
+    //!
+    //! When enabled, each solve starts from the pressure of the previous
+    //! solve scaled by the ratio of the time intervals instead of zero. The
+    //! cached pressure is dropped when the grid resolution changes or the
+    //! mode is disabled.
+    //!
+    void setUseWarmStart(bool useWarmStart);
+
+    //! Returns the warm-start cache which also reports iteration savings.
+    const FdmWarmStart3& warmStart() const;
+
  private:
     FdmLinearSystem3 _system;
     FdmCompressedLinearSystem3 _compSystem;
+    FdmCompressedLinearSystemBuilder3 _compSystemBuilder;
     FdmLinearSystemSolver3Ptr _systemSolver;
 
     FdmMgLinearSystem3 _mgSystem;
     FdmMgSolver3Ptr _mgSystemSolver;
 
+    bool _useWarmStart = false;
+    FdmWarmStart3 _warmStart;
+
     std::vector<Array3<char>> _markers;
+    std::vector<Array3<char>> _markerChanges;
+    std::vector<Array3<char>> _changedRows;
+    Vector3D _mgSystemGridSpacing;
 
     void buildMarkers(
         const Size3& size,
         const std::function<Vector3D(size_t, size_t, size_t)>& pos,
         const ScalarField3& boundarySdf, const ScalarField3& fluidSdf);
 
+    void buildCompressedSystem(const FaceCenteredGrid3& input);
+
+    void buildInitialGuess(double timeIntervalInSeconds, bool useCompressed);
+
+    void storeSolution(double timeIntervalInSeconds);
+
     void decompressSolution();
 
     virtual void buildSystem(const FaceCenteredGrid3& input,
@@ -120,4 +164,6 @@ typedef std::shared_ptr<GridSinglePhasePressureSolver3>
 
 }  // namespace jet
 
+#include "detail/grid_single_phase_pressure_solver3-inl.h"
+
 #endif  // INCLUDE_JET_GRID_SINGLE_PHASE_PRESSURE_SOLVER3_H_
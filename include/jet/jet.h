@@ -40,6 +40,7 @@
 #include <jet/cell_centered_vector_grid2.h>
 #include <jet/cell_centered_vector_grid3.h>
 #include <jet/cg.h>
+#include <jet/chebyshev.h>
 #include <jet/collider2.h>
 #include <jet/collider3.h>
 #include <jet/collider_set2.h>
@@ -65,9 +66,16 @@
 #include <jet/eno_level_set_solver3.h>
 #include <jet/face_centered_grid2.h>
 #include <jet/face_centered_grid3.h>
+#include <jet/fast_sweeping_level_set_solver2.h>
+#include <jet/fast_sweeping_level_set_solver3.h>
 #include <jet/fcc_lattice_point_generator.h>
+#include <jet/fdm_auto_tuning_solver3.h>
+#include <jet/fdm_batch_linear_system3.h>
+#include <jet/fdm_blocked_smoother3.h>
 #include <jet/fdm_cg_solver2.h>
 #include <jet/fdm_cg_solver3.h>
+#include <jet/fdm_chebyshev_solver3.h>
+#include <jet/fdm_compressed_linear_system_builder3.h>
 #include <jet/fdm_gauss_seidel_solver2.h>
 #include <jet/fdm_gauss_seidel_solver3.h>
 #include <jet/fdm_iccg_solver2.h>
@@ -78,13 +86,18 @@
 #include <jet/fdm_linear_system3.h>
 #include <jet/fdm_linear_system_solver2.h>
 #include <jet/fdm_linear_system_solver3.h>
+#include <jet/fdm_matrix_free3.h>
 #include <jet/fdm_mg_linear_system2.h>
 #include <jet/fdm_mg_linear_system3.h>
 #include <jet/fdm_mg_solver2.h>
 #include <jet/fdm_mg_solver3.h>
 #include <jet/fdm_mgpcg_solver2.h>
 #include <jet/fdm_mgpcg_solver3.h>
+#include <jet/fdm_mixed_precision_solver3.h>
+#include <jet/fdm_schwarz_solver3.h>
+#include <jet/fdm_solver_workspace3.h>
 #include <jet/fdm_utils.h>
+#include <jet/fdm_warm_start3.h>
 #include <jet/field2.h>
 #include <jet/field3.h>
 #include <jet/flip_solver2.h>
@@ -143,6 +156,8 @@
 #include <jet/list_query_engine2.h>
 #include <jet/list_query_engine3.h>
 #include <jet/logging.h>
+#include <jet/mac_cormack_semi_lagrangian2.h>
+#include <jet/mac_cormack_semi_lagrangian3.h>
 #include <jet/macros.h>
 #include <jet/marching_cubes.h>
 #include <jet/math_utils.h>
@@ -151,8 +166,10 @@
 #include <jet/matrix3x3.h>
 #include <jet/matrix4x4.h>
 #include <jet/matrix_csr.h>
+#include <jet/matrix_csr_builder.h>
 #include <jet/matrix_expression.h>
 #include <jet/matrix_mxn.h>
+#include <jet/matrix_sell.h>
 #include <jet/mg.h>
 #include <jet/nearest_neighbor_query_engine2.h>
 #include <jet/nearest_neighbor_query_engine3.h>
@@ -162,10 +179,12 @@
 #include <jet/particle_emitter3.h>
 #include <jet/particle_emitter_set2.h>
 #include <jet/particle_emitter_set3.h>
+#include <jet/particle_stencil_cache3.h>
 #include <jet/particle_system_data2.h>
 #include <jet/particle_system_data3.h>
 #include <jet/particle_system_solver2.h>
 #include <jet/particle_system_solver3.h>
+#include <jet/particle_to_grid_scatter3.h>
 #include <jet/pci_sph_solver2.h>
 #include <jet/pci_sph_solver3.h>
 #include <jet/pde.h>
@@ -343,6 +343,21 @@ class MatrixCsr final : public MatrixExpression<T, MatrixCsr<T>> {
     //! Returns this matrix / input scalar.
     MatrixCsr div(const T& s) const;
 
+    // MARK: Sparse matrix-vector multiplication
+
+    //!
+    //! \brief Computes \p result = this matrix * \p v.
+    //!
+    //! Unlike the lazily evaluated mul(const VectorExpression&), this function
+    //! runs a row-blocked kernel directly on the CSR arrays, in parallel over
+    //! blocks of rows.
+    //!
+    void mul(const VectorN<T>& v, VectorN<T>* result) const;
+
+    //! Computes \p result = \p b - this matrix * \p x in a single pass.
+    void residual(const VectorN<T>& x, const VectorN<T>& b,
+                  VectorN<T>* result) const;
+
     // MARK: Binary operator methods - new instance = input (+) this instance
 
     //! Returns input scalar + this matrix.
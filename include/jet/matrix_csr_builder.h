@@ -0,0 +1,134 @@
+// Copyright (c) 2018 Doyub Kim
+//
+// I am making my contributions/submissions to this project solely in my
+// personal capacity and am not conveying any rights to any intellectual
+// property of any third parties.
+
+#ifndef INCLUDE_JET_MATRIX_CSR_BUILDER_H_
+#define INCLUDE_JET_MATRIX_CSR_BUILDER_H_
+
+#include <jet/matrix_csr.h>
+#include <jet/size2.h>
+
+#include <vector>
+
+namespace jet {
+
+//!
+//! \brief Bulk triplet-based builder for MatrixCsr.
+//!
+//! MatrixCsr::addElement and MatrixCsr::setElement insert into the sorted row
+//! storage one element at a time, which is slow for large assemblies and
+//! cannot run concurrently. This class instead collects (i, j, value)
+//! triplets into independent partitions, typically one per parallel task, and
+//! then builds the CSR arrays at once with a parallel sort and scan. Triplets
+//! with the same (i, j) are summed up.
+//!
+//! The builder caches the sparsity pattern of the last build. If the next
+//! build receives the same sequence of (i, j) pairs, which is the case when
+//! the assembly loop visits the same cells, the sort is skipped and only the
+//! values are updated.
+//!
+//! \code{.cpp}
+//! MatrixCsrBuilderD builder(n, n, numberOfSlabs);
+//! parallelFor(kZeroSize, numberOfSlabs, [&](size_t slab) {
+//!     builder.addElement(slab, i, j, value);
+//! });
+//! MatrixCsrD matrix;
+//! builder.build(&matrix);
+//! \endcode
+//!
+//! \tparam T Type of the element.
+//!
+template <typename T>
+class MatrixCsrBuilder final {
+ public:
+    typedef typename MatrixCsr<T>::Element Element;
+    typedef std::vector<Element> ElementContainerType;
+
+    //! Constructs an empty builder.
+    MatrixCsrBuilder();
+
+    //! Constructs a builder for rows x cols matrix with given partitions.
+    MatrixCsrBuilder(size_t rows, size_t cols, size_t numberOfPartitions);
+
+    //!
+    //! \brief Resets the matrix size and the number of partitions.
+    //!
+    //! The collected triplets are cleared but the cached sparsity pattern is
+    //! kept, so that it can be reused if the matrix size does not change.
+    //!
+    void reset(size_t rows, size_t cols, size_t numberOfPartitions);
+
+    //! Clears the collected triplets while keeping the cached pattern.
+    void clearElements();
+
+    //! Clears everything including the cached pattern.
+    void clear();
+
+    //! Returns the size of the matrix to build.
+    Size2 size() const;
+
+    //! Returns the number of partitions.
+    size_t numberOfPartitions() const;
+
+    //! Returns the number of collected triplets.
+    size_t numberOfElements() const;
+
+    //!
+    //! \brief Adds a triplet to the given partition.
+    //!
+    //! Different partitions can be filled concurrently, but a partition
+    //! should not be shared by multiple tasks.
+    //!
+    void addElement(size_t partition, size_t i, size_t j, const T& value);
+
+    //! Returns the triplet container of the given partition.
+    ElementContainerType& partition(size_t partition);
+
+    //! Returns the triplet container of the given partition.
+    const ElementContainerType& partition(size_t partition) const;
+
+    //!
+    //! \brief Builds the CSR matrix from the collected triplets.
+    //!
+    //! Triplets with the same (i, j) are summed up in a fixed order, so the
+    //! result does not depend on the number of threads. If the cached pattern
+    //! is reused and \p matrix still has the size and the number of non-zeros
+    //! of the last build, only its non-zero values are written.
+    //!
+    void build(MatrixCsr<T>* matrix);
+
+    //! Returns true if the last build has reused the cached pattern.
+    bool lastBuildReusedPattern() const;
+
+ private:
+    Size2 _size;
+    std::vector<ElementContainerType> _partitions;
+    bool _lastBuildReusedPattern = false;
+
+    // Cached pattern of the last build
+    std::vector<Element> _elements;
+    std::vector<size_t> _order;
+    std::vector<size_t> _segmentPointers;
+    std::vector<size_t> _rowPointers;
+    std::vector<size_t> _columnIndices;
+
+    void gatherElements(bool* isSamePattern);
+
+    void buildPattern();
+
+    void writeMatrix(MatrixCsr<T>* matrix) const;
+};
+
+//! Float-type CSR matrix builder.
+typedef MatrixCsrBuilder<float> MatrixCsrBuilderF;
+
+//! Double-type CSR matrix builder.
+typedef MatrixCsrBuilder<double> MatrixCsrBuilderD;
+
+}  // namespace jet
+
+#include "detail/matrix_csr_builder-inl.h"
+
+#endif  // INCLUDE_JET_MATRIX_CSR_BUILDER_H_
@@ -0,0 +1,129 @@
+// Copyright (c) 2018 Doyub Kim
+//
+// I am making my contributions/submissions to this project solely in my
+// personal capacity and am not conveying any rights to any intellectual
+// property of any third parties.
+
+#ifndef INCLUDE_JET_MATRIX_SELL_H_
+#define INCLUDE_JET_MATRIX_SELL_H_
+
+#include <jet/matrix_csr.h>
+#include <jet/size2.h>
+#include <jet/vector_n.h>
+
+#include <cstdint>
+#include <vector>
+
+namespace jet {
+
+//!
+//! \brief Sliced ELLPACK (SELL-C-sigma) sparse matrix class.
+//!
+//! This class stores a sparse matrix in SELL-C-sigma format for fast
+//! matrix-vector multiplication. Rows are sorted by their lengths within
+//! windows of sigma rows and then grouped into chunks of C rows. Each chunk is
+//! padded to its longest row and stored column-major, so the inner loop of
+//! the multiplication runs over C independent rows and vectorizes. Column
+//! indices are stored as 32-bit integers to reduce the memory traffic.
+//!
+//! The matrix is built from a MatrixCsr and is read-only except for
+//! updateValues(), which refreshes the values of a matrix with the same
+//! sparsity pattern.
+//!
+//! \see Kreutzer, Moritz, et al. "A unified sparse matrix data format for
+//!      efficient general sparse matrix-vector multiplication on modern
+//!      processors with wide SIMD units." SIAM Journal on Scientific
+//!      Computing 36.5 (2014): C401-C423.
+//!
+//! \tparam T Type of the element.
+//! \tparam C Number of rows per chunk.
+//!
+template <typename T, size_t C = 8>
+class MatrixSell final {
+ public:
+    static_assert(
+        std::is_floating_point<T>::value,
+        "MatrixSell only can be instantiated with floating point types");
+
+    static_assert(C > 0, "Chunk size should be larger than zero");
+
+    //! Number of rows per chunk.
+    static constexpr size_t kChunkSize = C;
+
+    //! Default sorting window size in number of rows.
+    static constexpr size_t kDefaultSortingScope = 16 * C;
+
+    //! Constructs an empty matrix.
+    MatrixSell();
+
+    //! Converts given CSR matrix with the sorting scope \p sigma.
+    explicit MatrixSell(const MatrixCsr<T>& csr,
+                        size_t sigma = kDefaultSortingScope);
+
+    //! Clears the matrix and make it zero-dimensional.
+    void clear();
+
+    //!
+    //! \brief Converts given CSR matrix with the sorting scope \p sigma.
+    //!
+    //! \p sigma is rounded up to a multiple of the chunk size. Sorting within
+    //! a window larger than the chunk reduces the padding, while a small
+    //! window keeps the rows close to their original order for better
+    //! locality of the input vector access.
+    //!
+    void set(const MatrixCsr<T>& csr, size_t sigma = kDefaultSortingScope);
+
+    //!
+    //! \brief Updates the values from the CSR matrix with the same pattern.
+    //!
+    //! The sparsity pattern of \p csr must be identical to the one that was
+    //! passed to the last set() call.
+    //!
+    void updateValues(const MatrixCsr<T>& csr);
+
+    //! Returns the size of this matrix.
+    Size2 size() const;
+
+    //! Returns number of rows of this matrix.
+    size_t rows() const;
+
+    //! Returns number of columns of this matrix.
+    size_t cols() const;
+
+    //! Returns the number of non-zero elements.
+    size_t numberOfNonZeros() const;
+
+    //! Returns the number of stored elements including the padding.
+    size_t numberOfStoredElements() const;
+
+    //! Computes \p result = this matrix * \p v.
+    void mul(const VectorN<T>& v, VectorN<T>* result) const;
+
+    //! Computes \p result = \p b - this matrix * \p x in a single pass.
+    void residual(const VectorN<T>& x, const VectorN<T>& b,
+                  VectorN<T>* result) const;
+
+ private:
+    Size2 _size;
+    size_t _numberOfNonZeros = 0;
+    std::vector<T> _values;
+    std::vector<uint32_t> _columnIndices;
+    std::vector<size_t> _chunkPointers;
+    std::vector<size_t> _rowPermutation;
+    std::vector<size_t> _csrToSell;
+
+    template <typename Callback>
+    void forEachChunkRow(const VectorN<T>& x, const Callback& func) const;
+};
+
+//! Float-type SELL-C-sigma matrix.
+typedef MatrixSell<float> MatrixSellF;
+
+//! Double-type SELL-C-sigma matrix.
+typedef MatrixSell<double> MatrixSellD;
+
+}  // namespace jet
+
+#include "detail/matrix_sell-inl.h"
+
+#endif  // INCLUDE_JET_MATRIX_SELL_H_
@@ -7,6 +7,9 @@
 #ifndef INCLUDE_JET_PARALLEL_H_
 #define INCLUDE_JET_PARALLEL_H_
 
+#include <cstddef>
+#include <vector>
+
 namespace jet {
 
 //! Execution policy tag.
@@ -237,6 +240,24 @@ void parallelSort(RandomIterator begin, RandomIterator end,
                   CompareFunction compare,
                   ExecutionPolicy policy = ExecutionPolicy::kParallel);
 
+//!
+//! \brief      Computes the exclusive prefix sum of \p input in parallel.
+//!
+//! This function writes the sum of all preceding elements of \p input to each
+//! element of \p output, which is resized to the size of \p input. The input
+//! is processed in blocks whose sums are combined serially, so the result does
+//! not depend on the number of threads.
+//!
+//! \param[in]  input          The input values.
+//! \param[out] output         The exclusive prefix sums.
+//! \param[in]  policy         The execution policy (parallel or serial).
+//!
+//! \return     The sum of all input values.
+//!
+size_t parallelExclusiveScan(
+    const std::vector<size_t>& input, std::vector<size_t>* output,
+    ExecutionPolicy policy = ExecutionPolicy::kParallel);
+
 //! Sets maximum number of threads to use.
 void setMaxNumberOfThreads(unsigned int numThreads);
 
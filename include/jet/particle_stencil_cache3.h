@@ -0,0 +1,103 @@
+// Copyright (c) 2018 Doyub Kim
+//
+// I am making my contributions/submissions to this project solely in my
+// personal capacity and am not conveying any rights to any intellectual
+// property of any third parties.
+
+#ifndef INCLUDE_JET_PARTICLE_STENCIL_CACHE3_H_
+#define INCLUDE_JET_PARTICLE_STENCIL_CACHE3_H_
+
+#include <jet/array1.h>
+#include <jet/array_accessor1.h>
+#include <jet/array_accessor3.h>
+#include <jet/point3.h>
+#include <jet/size3.h>
+#include <jet/vector3.h>
+
+#include <array>
+#include <cstdint>
+
+namespace jet {
+
+//!
+//! \brief Per-particle cache of trilinear interpolation stencils.
+//!
+//! This class stores, for every particle, the stencil that
+//! LinearArraySampler3 would use to sample one data array (for example the
+//! u-data of a FaceCenteredGrid3) at the particle position. A stencil is the
+//! base index of the cell plus the fractional offsets in single precision,
+//! which is 24 bytes per particle instead of the 8 indices and weights
+//! returned by LinearArraySampler3::getCoordinatesAndWeights.
+//!
+//! The cache only depends on the positions, so one build per position update
+//! can serve both the particle-to-grid and the grid-to-particle transfer.
+//!
+class ParticleStencilCache3 {
+ public:
+    //! Base index and fractional offsets of a trilinear stencil.
+    struct Stencil {
+        uint32_t i;
+        uint32_t j;
+        uint32_t k;
+        float fx;
+        float fy;
+        float fz;
+    };
+
+    //!
+    //! \brief Builds the stencils of \p positions in parallel.
+    //!
+    //! \param positions    The particle positions.
+    //! \param dataSize     The size of the data array.
+    //! \param gridSpacing  The grid spacing.
+    //! \param dataOrigin   The position of the first data point.
+    //!
+    void build(const ConstArrayAccessor1<Vector3D>& positions,
+               const Size3& dataSize, const Vector3D& gridSpacing,
+               const Vector3D& dataOrigin);
+
+    //! Returns true if the cache was built for the given particle count and
+    //! data layout.
+    bool isValid(size_t numberOfParticles, const Size3& dataSize,
+                 const Vector3D& gridSpacing,
+                 const Vector3D& dataOrigin) const;
+
+    //! Returns the number of cached particles.
+    size_t numberOfParticles() const;
+
+    //! Returns the stencil of particle \p i.
+    const Stencil& operator[](size_t i) const;
+
+    //! Returns the value of \p data interpolated at particle \p i.
+    template <typename T>
+    T interpolate(size_t i, const ConstArrayAccessor3<T>& data) const;
+
+    //! Returns the indices of points and their sampling weight for particle
+    //! \p i, in the same order as LinearArraySampler3.
+    void getCoordinatesAndWeights(size_t i, std::array<Point3UI, 8>* indices,
+                                  std::array<double, 8>* weights) const;
+
+    //! Returns the indices of points and their gradient of sampling weight
+    //! for particle \p i, in the same order as LinearArraySampler3.
+    void getCoordinatesAndGradientWeights(
+        size_t i, std::array<Point3UI, 8>* indices,
+        std::array<Vector3D, 8>* weights) const;
+
+    //! Clears the cache.
+    void clear();
+
+ private:
+    Array1<Stencil> _stencils;
+    Size3 _dataSize;
+    Vector3D _gridSpacing;
+    Vector3D _dataOrigin;
+
+    void getCoordinates(const Stencil& s,
+                        std::array<Point3UI, 8>* indices) const;
+};
+
+}  // namespace jet
+
+#include "detail/particle_stencil_cache3-inl.h"
+
+#endif  // INCLUDE_JET_PARTICLE_STENCIL_CACHE3_H_
@@ -11,6 +11,7 @@
 #include <jet/serialization.h>
 #include <jet/point_neighbor_searcher3.h>
 
+#include <cstdint>
 #include <memory>
 #include <vector>
 
@@ -179,6 +180,37 @@ class ParticleSystemData3 : public Serializable {
         const ConstArrayAccessor1<Vector3D>& newForces
             = ConstArrayAccessor1<Vector3D>());
 
+    //!
+    //! \brief      Removes the particles that are marked in \p shouldRemove.
+    //!
+    //! This function removes every particle whose flag is non-zero and
+    //! compacts the positions, velocities, forces, and custom data layers in
+    //! parallel. The remaining particles keep their relative order. Like
+    //! ParticleSystemData3::resize, this invalidates the neighbor searcher and
+    //! neighbor lists.
+    //!
+    //! \param[in]  shouldRemove    Per-particle removal flags.
+    //!
+    void removeParticles(const ConstArrayAccessor1<char>& shouldRemove);
+
+    //!
+    //! \brief      Returns the generation of the particle positions.
+    //!
+    //! The generation is incremented whenever the positions or the number of
+    //! particles change. Data derived from the positions, such as
+    //! interpolation stencils or particle bins, can record the generation it
+    //! was built from and compare it later to detect stale results.
+    //!
+    uint64_t positionGeneration() const;
+
+    //!
+    //! \brief      Increments the generation of the particle positions.
+    //!
+    //! Code that writes to the mutable position array must call this after
+    //! the update so that data derived from the positions is rebuilt.
+    //!
+    void notifyPositionsChanged();
+
     //!
     //! \brief      Returns neighbor searcher.
     //!
@@ -238,6 +270,7 @@ class ParticleSystemData3 : public Serializable {
     size_t _positionIdx;
     size_t _velocityIdx;
     size_t _forceIdx;
+    uint64_t _positionGeneration = 0;
 
     std::vector<ScalarData> _scalarDataList;
     std::vector<VectorData> _vectorDataList;
@@ -251,4 +284,6 @@ typedef std::shared_ptr<ParticleSystemData3> ParticleSystemData3Ptr;
 
 }  // namespace jet
 
+#include "detail/particle_system_data3-inl.h"
+
 #endif  // INCLUDE_JET_PARTICLE_SYSTEM_DATA3_H_
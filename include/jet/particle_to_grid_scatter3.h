@@ -0,0 +1,120 @@
+// Copyright (c) 2018 Doyub Kim
+//
+// I am making my contributions/submissions to this project solely in my
+// personal capacity and am not conveying any rights to any intellectual
+// property of any third parties.
+
+#ifndef INCLUDE_JET_PARTICLE_TO_GRID_SCATTER3_H_
+#define INCLUDE_JET_PARTICLE_TO_GRID_SCATTER3_H_
+
+#include <jet/array_accessor1.h>
+#include <jet/array_accessor3.h>
+#include <jet/particle_stencil_cache3.h>
+#include <jet/size3.h>
+#include <jet/vector3.h>
+
+#include <array>
+#include <vector>
+
+namespace jet {
+
+//!
+//! \brief Race-free parallel particle-to-grid scatter.
+//!
+//! This class bins particles by blocks of grid cells and visits them in
+//! eight colored passes. Blocks of the same color are at least one block
+//! apart along every axis, so the particles of one pass can write to the
+//! grid data around their cells without atomics or locks. Within a block,
+//! particles are visited in ascending index order, and the passes run in a
+//! fixed order, so every grid point receives its contributions in the same
+//! order regardless of the number of threads. The results are therefore
+//! deterministic.
+//!
+//! A particle may write to any data point whose index differs from its cell
+//! index by at most one along each axis. This covers the trilinear stencils
+//! of cell-centered, vertex-centered and face-centered data.
+//!
+class ParticleToGridScatter3 {
+ public:
+    //! Constructs the scatter with the given block size in cells.
+    explicit ParticleToGridScatter3(size_t blockSize = 8);
+
+    //! Returns the block size in cells.
+    size_t blockSize() const;
+
+    //! Sets the block size in cells. It must be at least 2.
+    void setBlockSize(size_t blockSize);
+
+    //!
+    //! \brief Bins \p positions by the cells of the given grid.
+    //!
+    //! \param positions    The particle positions.
+    //! \param resolution   The grid resolution.
+    //! \param gridSpacing  The grid spacing.
+    //! \param origin       The grid origin.
+    //!
+    void build(const ConstArrayAccessor1<Vector3D>& positions,
+               const Size3& resolution, const Vector3D& gridSpacing,
+               const Vector3D& origin);
+
+    //! Returns true if the bins were built for the given particle count and
+    //! grid layout with the current block size.
+    bool isValid(size_t numberOfParticles, const Size3& resolution,
+                 const Vector3D& gridSpacing, const Vector3D& origin) const;
+
+    //! Returns the number of binned particles.
+    size_t numberOfParticles() const;
+
+    //! Returns the number of blocks along each axis of the binned grid.
+    Size3 numberOfBlocks() const;
+
+    //!
+    //! \brief Invokes \p func (particle index) for every particle binned in
+    //! block (\p bi, \p bj, \p bk).
+    //!
+    //! The calls run serially in ascending particle index order. Blocks span
+    //! blockSize() cells along each axis, starting from cell (0, 0, 0).
+    //!
+    template <typename Function>
+    void forEachParticleInBlock(size_t bi, size_t bj, size_t bk,
+                                const Function& func) const;
+
+    //!
+    //! \brief Invokes \p func (particle index) for every binned particle.
+    //!
+    //! Calls for particles in blocks of the same color run in parallel, and
+    //! calls within a block run serially in ascending particle index order.
+    //!
+    template <typename Function>
+    void forEachParticle(const Function& func) const;
+
+    //!
+    //! \brief Accumulates weighted particle values to the grid data.
+    //!
+    //! For every particle p and every point x of its stencil with weight w,
+    //! adds w * value(p) to data(x) and w to weights(x), and sets markers(x)
+    //! to 1. The arrays are not cleared beforehand.
+    //!
+    template <typename T, typename ValueFunction>
+    void scatter(const ParticleStencilCache3& stencils,
+                 const ValueFunction& value, ArrayAccessor3<T> data,
+                 ArrayAccessor3<double> weights,
+                 ArrayAccessor3<char> markers) const;
+
+ private:
+    size_t _blockSize = 0;
+    size_t _numberOfParticles = 0;
+    Size3 _numberOfBlocks;
+    Size3 _resolution;
+    Vector3D _gridSpacing;
+    Vector3D _origin;
+    std::vector<size_t> _sortedParticles;
+    std::vector<size_t> _blockStarts;
+    std::array<std::vector<size_t>, 8> _coloredBlocks;
+};
+
+}  // namespace jet
+
+#include "detail/particle_to_grid_scatter3-inl.h"
+
+#endif  // INCLUDE_JET_PARTICLE_TO_GRID_SCATTER3_H_
@@ -9,7 +9,12 @@
 
 #include <jet/grid_fluid_solver3.h>
 #include <jet/particle_emitter3.h>
+#include <jet/particle_stencil_cache3.h>
 #include <jet/particle_system_data3.h>
+#include <jet/particle_to_grid_scatter3.h>
+
+#include <cstdint>
+#include <vector>
 
 namespace jet {
 
@@ -23,6 +28,10 @@ namespace jet {
 //! \see Zhu, Yongning, and Robert Bridson. "Animating sand as a fluid."
 //!     ACM Transactions on Graphics (TOG). Vol. 34. No. 3. ACM, 3005.
 //!
+//! \note transferFromParticlesToGrids(), transferFromGridsToParticles(),
+//!     moveParticles() and buildSignedDistanceField() are defined in
+//!     detail/pic_solver3-inl.h, not in pic_solver3.cpp.
+//!
 class PicSolver3 : public GridFluidSolver3 {
  public:
     class Builder;
@@ -51,6 +60,24 @@ class PicSolver3 : public GridFluidSolver3 {
     //! Sets the particle emitter.
     void setParticleEmitter(const ParticleEmitter3Ptr& newEmitter);
 
+    //! Returns the minimum number of particles per fluid cell.
+    size_t minParticlesPerCell() const;
+
+    //! Returns the maximum number of particles per cell.
+    size_t maxParticlesPerCell() const;
+
+    //!
+    //! \brief Sets the range of particles per cell.
+    //!
+    //! After the particles are moved, controlParticleCount() deletes the
+    //! particles beyond \p maxCount in a cell and seeds fluid cells with
+    //! fewer than \p minCount particles up to \p minCount. This keeps the
+    //! particle count, and thus the transfer cost, bounded when emitters keep
+    //! adding particles or particles clump. The default range [0, kMaxSize]
+    //! disables the control.
+    //!
+    void setParticlesPerCellRange(size_t minCount, size_t maxCount);
+
     //! Returns builder fox PicSolver3.
     static Builder builder();
 
@@ -59,6 +86,20 @@ class PicSolver3 : public GridFluidSolver3 {
     Array3<char> _vMarkers;
     Array3<char> _wMarkers;
 
+    //! Interpolation stencils of the particles on the u-, v- and w-data of
+    //! the velocity grid.
+    ParticleStencilCache3 _uStencils;
+    ParticleStencilCache3 _vStencils;
+    ParticleStencilCache3 _wStencils;
+
+    //! Particles binned by grid blocks of the velocity grid. The
+    //! particle-to-grid transfer of PicSolver3 and FlipSolver3 accumulates
+    //! through it in parallel without races.
+    ParticleToGridScatter3 _particleScatter;
+
+    //! Position generation the stencils and bins were built from.
+    uint64_t _particleStencilGeneration = 0;
+
     //! Initializes the simulator.
     void onInitialize() override;
 
@@ -71,19 +112,109 @@ class PicSolver3 : public GridFluidSolver3 {
     //! Returns the signed-distance field of the fluid.
     ScalarField3Ptr fluidSdf() const override;
 
-    //! Transfers velocity field from particles to grids.
+    //!
+    //! \brief Transfers velocity field from particles to grids.
+    //!
+    //! The weights are taken from the particle stencil caches, which are
+    //! rebuilt first if the particles changed since they were built, and
+    //! the particles are accumulated in parallel through _particleScatter.
+    //!
     virtual void transferFromParticlesToGrids();
 
-    //! Transfers velocity field from grids to particles.
+    //!
+    //! \brief Transfers velocity field from grids to particles.
+    //!
+    //! The grid velocity is interpolated with the particle stencil caches,
+    //! which are rebuilt first if the particles changed since they were
+    //! built.
+    //!
     virtual void transferFromGridsToParticles();
 
-    //! Moves particles.
+    //!
+    //! \brief Moves particles.
+    //!
+    //! The particles are advected with the midpoint rule, clamped to the
+    //! closed domain boundaries and pushed out of the collider. Afterwards
+    //! the position generation of the particle system data is incremented,
+    //! so the particle stencils and bins are rebuilt once before the next
+    //! transfer, and controlParticleCount() is applied.
+    //!
     virtual void moveParticles(double timeIntervalInSeconds);
 
+    //!
+    //! \brief Rebuilds the particle stencil caches and the particle bins.
+    //!
+    //! The caches are built from the current particle positions and the
+    //! velocity grid layout, and record the position generation of the
+    //! particle system data they were built from. The transfers and the
+    //! signed-distance field construction call this only when
+    //! hasValidParticleStencils() is false, so each position update is
+    //! processed once.
+    //!
+    void updateParticleStencils();
+
+    //!
+    //! \brief Returns true if the stencils and bins match the particles.
+    //!
+    //! Both the stencils and the bins share the same check: this returns
+    //! false once the position generation of the particle system data has
+    //! changed since updateParticleStencils(), for example after particles
+    //! were removed or seeded, or once the velocity grid was resized.
+    //!
+    bool hasValidParticleStencils() const;
+
+    //!
+    //! \brief Deletes and seeds particles to keep the per-cell counts in the
+    //! range set by setParticlesPerCellRange().
+    //!
+    //! Called at the end of moveParticles(), so PicSolver3, FlipSolver3 and
+    //! ApicSolver3 all apply the range after every position update. Each
+    //! cell keeps its first particles in index order, and the removal
+    //! compacts all particle channels in parallel. New particles are jittered
+    //! within their cell and take the grid velocity.
+    //!
+    void controlParticleCount();
+
+    //!
+    //! \brief Removes the particles that are marked in \p shouldRemove.
+    //!
+    //! Solvers that keep their own per-particle data override this to compact
+    //! it the same way, and then call the base version.
+    //!
+    virtual void removeParticles(const ConstArrayAccessor1<char>& shouldRemove);
+
+    //!
+    //! \brief Counts the particles per grid cell.
+    //!
+    //! Particles outside the grid are counted in the nearest cell. If \p ranks
+    //! is given, it receives the rank of each particle among the particles of
+    //! its cell in index order.
+    //!
+    void countParticlesPerCell(Array3<uint32_t>* counts,
+                               std::vector<uint32_t>* ranks = nullptr) const;
+
+    //!
+    //! \brief Seeds func(i, j, k) particles in each grid cell.
+    //!
+    //! The particles are jittered within the cell, first one per octant, and
+    //! take their velocity from \p velocity. Cells are processed in parallel
+    //! and the new particles are appended in cell order, so the result is
+    //! deterministic for a given \p seed.
+    //!
+    template <typename SeedCountFunction>
+    void seedParticlesInCells(const SeedCountFunction& func,
+                              const VectorField3& velocity, uint64_t seed);
+
+    //! Returns the maximum depth below the surface at which fluid cells are
+    //! seeded by controlParticleCount().
+    virtual double particleSeedingDepth() const;
+
  private:
     size_t _signedDistanceFieldId;
     ParticleSystemData3Ptr _particles;
     ParticleEmitter3Ptr _particleEmitter;
+    size_t _minParticlesPerCell = 0;
+    size_t _maxParticlesPerCell = kMaxSize;
 
     void extrapolateVelocityToAir();
 
@@ -111,4 +242,6 @@ class PicSolver3::Builder final
 
 }  // namespace jet
 
+#include "detail/pic_solver3-inl.h"
+
 #endif  // INCLUDE_JET_PIC_SOLVER3_H_
@@ -144,4 +144,6 @@ typedef std::shared_ptr<SemiLagrangian2> SemiLagrangian2Ptr;
 
 }  // namespace jet
 
+#include "detail/semi_lagrangian2-inl.h"
+
 #endif  // INCLUDE_JET_SEMI_LAGRANGIAN2_H_
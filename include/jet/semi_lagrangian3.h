@@ -23,6 +23,9 @@ namespace jet {
 //! classes can override SemiLagrangian2::getScalarSamplerFunc and
 //! SemiLagrangian2::getVectorSamplerFunc. See CubicSemiLagrangian2 for example.
 //!
+//! \note The advect() overloads are defined in detail/semi_lagrangian3-inl.h,
+//!     not in semi_lagrangian3.cpp.
+//!
 class SemiLagrangian3 : public AdvectionSolver3 {
  public:
     SemiLagrangian3();
@@ -99,6 +102,26 @@ class SemiLagrangian3 : public AdvectionSolver3 {
                 const ScalarField3& boundarySdf = ConstantScalarField3(
                     std::numeric_limits<double>::max())) final;
 
+    //!
+    //! \brief Computes semi-Lagrangian for multiple grids at once.
+    //!
+    //! Grids whose inputs share the same data layout (size, grid spacing and
+    //! data origin), and whose outputs do too, are grouped and advected in a
+    //! single traversal that back-traces each data point only once. With the
+    //! linear samplers, the interpolation weights are also computed once per
+    //! data point and applied to every grid in the group, giving the same
+    //! result as advecting the grids one by one. advect() runs the same
+    //! traversal with a group of one.
+    //!
+    void advectFields(
+        const std::vector<const ScalarGrid3*>& scalarInputs,
+        const std::vector<ScalarGrid3*>& scalarOutputs,
+        const std::vector<const CollocatedVectorGrid3*>& vectorInputs,
+        const std::vector<CollocatedVectorGrid3*>& vectorOutputs,
+        const VectorField3& flow, double dt,
+        const ScalarField3& boundarySdf = ConstantScalarField3(
+            std::numeric_limits<double>::max())) override;
+
  protected:
     //!
     //! \brief Returns spatial interpolation function object for given scalar
@@ -136,13 +159,23 @@ class SemiLagrangian3 : public AdvectionSolver3 {
     virtual std::function<Vector3D(const Vector3D&)> getVectorSamplerFunc(
         const FaceCenteredGrid3& input) const;
 
- private:
-    Vector3D backTrace(const VectorField3& flow, double dt, double h,
-                       const Vector3D& pt0, const ScalarField3& boundarySdf);
+    //!
+    //! \brief Returns true if the samplers are the default linear samplers.
+    //!
+    //! When true, the input is interpolated with a trilinear stencil computed
+    //! directly from its data array instead of the virtual sampler
+    //! functions. Inheriting classes that override the sampler functions must
+    //! return false so that their samplers are used. Independently of this,
+    //! a FaceCenteredGrid3 flow and a grid or constant boundary SDF are
+    //! sampled without virtual calls.
+    //!
+    virtual bool hasLinearSamplers() const { return true; }
 };
 
 typedef std::shared_ptr<SemiLagrangian3> SemiLagrangian3Ptr;
 
 }  // namespace jet
 
+#include "detail/semi_lagrangian3-inl.h"
+
 #endif  // INCLUDE_JET_SEMI_LAGRANGIAN3_H_